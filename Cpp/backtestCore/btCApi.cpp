@@ -0,0 +1,414 @@
+// btCApi.cpp
+//
+// C ABI front-end for the backtest core.  Exceptions never cross this boundary.
+
+#include "btCApi.h"
+#include "btProfitLoss.h"
+#include "btNumTicksProfit.h"
+#include "btPlStream.h"
+#include "btError.h"
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <new>
+#include <vector>
+
+using namespace openAlgo;
+
+// Copy an error message into the caller's buffer
+static void setErr(char *errBuf, size_t errLen, const char *msg)
+{
+	if (errBuf == NULL || errLen == 0)
+		return;
+
+	strncpy(errBuf, msg, errLen - 1);
+	errBuf[errLen - 1] = '\0';
+}
+
+// Map a core error to a return code
+static int errCode(const btError &err)
+{
+	return (strstr(err.id(), "AdvancedSignal") != NULL) ? OA_ERR_SIGNAL : OA_ERR_INPUT;
+}
+
+int oaCalcProfitLoss(const double *open, const double *close, const double *sig, size_t rows,
+	double bigPoint, double cost,
+	double *cash, double *openEQ, double *netLiq, double *returns,
+	char *errBuf, size_t errLen)
+{
+	if (open == NULL || close == NULL || sig == NULL || cash == NULL || openEQ == NULL || netLiq == NULL || returns == NULL)
+	{
+		setErr(errBuf, errLen, "A required array was NULL. Aborting.");
+		return OA_ERR_INPUT;
+	}
+
+	try
+	{
+		plOutputs out;
+		out.cash = span<double>(cash, rows);
+		out.openEQ = span<double>(openEQ, rows);
+		out.netLiq = span<double>(netLiq, rows);
+		out.returns = span<double>(returns, rows);
+
+		calcProfitLoss(span<const double>(open, rows), span<const double>(close, rows), span<const double>(sig, rows),
+			bigPoint, cost, out);
+	}
+	catch (const btError &err)
+	{
+		setErr(errBuf, errLen, err.what());
+		return errCode(err);
+	}
+	catch (const std::exception &err)
+	{
+		setErr(errBuf, errLen, err.what());
+		return OA_ERR_INTERNAL;
+	}
+
+	return OA_OK;
+}
+
+int oaCalcProfitLossBatch(const double *open, const double *close, const double *sig, size_t rows, size_t cols,
+	double bigPoint, double cost, unsigned threads,
+	double *cash, double *openEQ, double *netLiq, double *returns,
+	char *errBuf, size_t errLen)
+{
+	if (open == NULL || close == NULL || sig == NULL || cash == NULL || openEQ == NULL || netLiq == NULL || returns == NULL)
+	{
+		setErr(errBuf, errLen, "A required array was NULL. Aborting.");
+		return OA_ERR_INPUT;
+	}
+
+	try
+	{
+		plOutputs out;
+		out.cash = span<double>(cash, rows * cols);
+		out.openEQ = span<double>(openEQ, rows * cols);
+		out.netLiq = span<double>(netLiq, rows * cols);
+		out.returns = span<double>(returns, rows * cols);
+
+		calcProfitLossBatch(span<const double>(open, rows), span<const double>(close, rows), span<const double>(sig, rows * cols), cols,
+			bigPoint, cost, out, threads);
+	}
+	catch (const btError &err)
+	{
+		setErr(errBuf, errLen, err.what());
+		return errCode(err);
+	}
+	catch (const std::exception &err)
+	{
+		setErr(errBuf, errLen, err.what());
+		return OA_ERR_INTERNAL;
+	}
+
+	return OA_OK;
+}
+
+int oaCalcProfitLossStats(const double *open, const double *close, const double *sig, size_t rows, size_t cols,
+	double bigPoint, double cost, unsigned threads,
+	oaPlStats *stats,
+	char *errBuf, size_t errLen)
+{
+	if (open == NULL || close == NULL || sig == NULL || stats == NULL)
+	{
+		setErr(errBuf, errLen, "A required array was NULL. Aborting.");
+		return OA_ERR_INPUT;
+	}
+
+	try
+	{
+		std::vector<plStats> colStats(cols);
+
+		calcProfitLossStatsBatch(span<const double>(open, rows), span<const double>(close, rows), span<const double>(sig, rows * cols), cols,
+			bigPoint, cost, colStats, threads);
+
+		for (size_t col = 0; col < cols; col++)
+		{
+			stats[col].bars = colStats[col].bars;
+			stats[col].meanReturn = colStats[col].meanReturn;
+			stats[col].varReturn = colStats[col].varReturn;
+			stats[col].stdReturn = colStats[col].stdReturn;
+			stats[col].sharpe = colStats[col].sharpe;
+			stats[col].maxDrawdown = colStats[col].maxDrawdown;
+			stats[col].trades = colStats[col].trades;
+			stats[col].winners = colStats[col].winners;
+			stats[col].winRate = colStats[col].winRate;
+			stats[col].grossProfit = colStats[col].grossProfit;
+			stats[col].grossLoss = colStats[col].grossLoss;
+			stats[col].netProfit = colStats[col].netProfit;
+			stats[col].netLiq = colStats[col].netLiq;
+		}
+	}
+	catch (const btError &err)
+	{
+		setErr(errBuf, errLen, err.what());
+		return errCode(err);
+	}
+	catch (const std::exception &err)
+	{
+		setErr(errBuf, errLen, err.what());
+		return OA_ERR_INTERNAL;
+	}
+
+	return OA_OK;
+}
+
+int oaNumTicksProfit(const double *barsIn, const double *sigIn, size_t rows,
+	double minTick, double numTicks, int openAvg,
+	double **barsOut, double **sigOut, size_t *rowsOut,
+	char *errBuf, size_t errLen)
+{
+	if (barsIn == NULL || sigIn == NULL || barsOut == NULL || sigOut == NULL || rowsOut == NULL)
+	{
+		setErr(errBuf, errLen, "A required array was NULL. Aborting.");
+		return OA_ERR_INPUT;
+	}
+
+	*barsOut = NULL;
+	*sigOut = NULL;
+	*rowsOut = 0;
+
+	try
+	{
+		ohlcSeries bars;
+		bars.open = span<const double>(barsIn, rows);
+		bars.high = span<const double>(barsIn + rows, rows);
+		bars.low = span<const double>(barsIn + 2 * rows, rows);
+		bars.close = span<const double>(barsIn + 3 * rows, rows);
+
+		span<const double> sig(sigIn, rows);
+		std::vector<ntpProfit> profits = numTicksProfitScan(bars, sig, minTick, numTicks, openAvg);
+
+		// +1 so an empty series still returns a valid pointer
+		size_t nOut = rows + profits.size();
+		double *b = (double*)malloc(nOut * 4 * sizeof(double) + 1);
+		double *s = (double*)malloc(nOut * sizeof(double) + 1);
+		if (b == NULL || s == NULL)
+		{
+			free(b);
+			free(s);
+			throw std::bad_alloc();
+		}
+
+		// Return what we were given when no profits were taken
+		if (!profits.empty())
+		{
+			numTicksProfitMerge(bars, sig, profits, span<double>(b, nOut * 4), span<double>(s, nOut));
+		}
+		else
+		{
+			memcpy(b, barsIn, nOut * 4 * sizeof(double));
+			memcpy(s, sigIn, nOut * sizeof(double));
+		}
+
+		*barsOut = b;
+		*sigOut = s;
+		*rowsOut = nOut;
+	}
+	catch (const btError &err)
+	{
+		setErr(errBuf, errLen, err.what());
+		return errCode(err);
+	}
+	catch (const std::exception &err)
+	{
+		setErr(errBuf, errLen, err.what());
+		return OA_ERR_INTERNAL;
+	}
+
+	return OA_OK;
+}
+
+struct oaPlStream
+{
+	plStream stream;
+
+	oaPlStream(double bigPoint, double cost) : stream(bigPoint, cost) {}
+};
+
+static void copyBar(const plBar &src, oaPlBar *dst)
+{
+	dst->index = src.index;
+	dst->cash = src.cash;
+	dst->openEQ = src.openEQ;
+	dst->netLiq = src.netLiq;
+	dst->returns = src.returns;
+}
+
+oaPlStream *oaPlStreamCreate(double bigPoint, double cost)
+{
+	return new (std::nothrow) oaPlStream(bigPoint, cost);
+}
+
+int oaPlStreamPush(oaPlStream *stream, double open, double close, double sig,
+	oaPlBar *bar, int *ready,
+	char *errBuf, size_t errLen)
+{
+	if (stream == NULL || bar == NULL || ready == NULL)
+	{
+		setErr(errBuf, errLen, "A required argument was NULL. Aborting.");
+		return OA_ERR_INPUT;
+	}
+
+	try
+	{
+		plBar released;
+		*ready = stream->stream.push(open, close, sig, released) ? 1 : 0;
+		if (*ready)
+			copyBar(released, bar);
+	}
+	catch (const btError &err)
+	{
+		*ready = 0;
+		setErr(errBuf, errLen, err.what());
+		return errCode(err);
+	}
+	catch (const std::exception &err)
+	{
+		*ready = 0;
+		setErr(errBuf, errLen, err.what());
+		return OA_ERR_INTERNAL;
+	}
+
+	return OA_OK;
+}
+
+int oaPlStreamCurrent(const oaPlStream *stream, oaPlBar *bar, int *ready)
+{
+	if (stream == NULL || bar == NULL || ready == NULL)
+		return OA_ERR_INPUT;
+
+	plBar latest;
+	*ready = stream->stream.current(latest) ? 1 : 0;
+	if (*ready)
+		copyBar(latest, bar);
+
+	return OA_OK;
+}
+
+int oaPlStreamCheckpoint(const oaPlStream *stream, double *state, size_t len, size_t *needed,
+	char *errBuf, size_t errLen)
+{
+	if (stream == NULL || needed == NULL)
+	{
+		setErr(errBuf, errLen, "A required argument was NULL. Aborting.");
+		return OA_ERR_INPUT;
+	}
+
+	try
+	{
+		std::vector<double> saved = stream->stream.checkpoint();
+		*needed = saved.size();
+
+		if (state == NULL)
+			return OA_OK;
+
+		if (len < saved.size())
+		{
+			setErr(errBuf, errLen, "The state buffer is too small. Aborting.");
+			return OA_ERR_INPUT;
+		}
+
+		memcpy(state, saved.data(), saved.size() * sizeof(double));
+	}
+	catch (const std::exception &err)
+	{
+		setErr(errBuf, errLen, err.what());
+		return OA_ERR_INTERNAL;
+	}
+
+	return OA_OK;
+}
+
+int oaPlStreamRestore(oaPlStream *stream, const double *state, size_t len,
+	char *errBuf, size_t errLen)
+{
+	if (stream == NULL || state == NULL)
+	{
+		setErr(errBuf, errLen, "A required argument was NULL. Aborting.");
+		return OA_ERR_INPUT;
+	}
+
+	try
+	{
+		stream->stream.restore(span<const double>(state, len));
+	}
+	catch (const btError &err)
+	{
+		setErr(errBuf, errLen, err.what());
+		return errCode(err);
+	}
+	catch (const std::exception &err)
+	{
+		setErr(errBuf, errLen, err.what());
+		return OA_ERR_INTERNAL;
+	}
+
+	return OA_OK;
+}
+
+void oaPlStreamDestroy(oaPlStream *stream)
+{
+	delete stream;
+}
+
+void oaFree(void *ptr)
+{
+	free(ptr);
+}
+
+//
+//  -------------------------------------------------------------------------
+//                                  _    _ 
+//         ___  _ __   ___ _ __    / \  | | __ _  ___   ___  _ __ __ _ 
+//        / _ \| '_ \ / _ \ '_ \  / _ \ | |/ _` |/ _ \ / _ \| '__/ _` |
+//       | (_) | |_) |  __/ | | |/ ___ \| | (_| | (_) | (_) | | | (_| |
+//        \___/| .__/ \___|_| |_/_/   \_\_|\__, |\___(_)___/|_|  \__, |
+//             |_|                         |___/                 |___/
+//  -------------------------------------------------------------------------
+//        This code is distributed in the hope that it will be useful,
+//
+//                         WITHOUT ANY WARRANTY AND
+//
+//                  WITHOUT CLAIM AS TO MERCHANTABILITY
+//
+//                  OR FITNESS FOR A PARTICULAR PURPOSE
+//
+//                           EXPRESSED OR IMPLIED.
+//
+//   Use of this code, pseudocode, algorithmic or trading logic contained
+//   herein, whether sound or faulty for any purpose is the sole
+//   responsibility of the USER. Any such use of these algorithms, coding
+//   logic or concepts in whole or in part carry no covenant of correctness
+//   or recommended usage from the AUTHOR or any of the possible
+//   contributors listed or unlisted, known or unknown.
+//
+//	 Redistribution and use in source and binary forms, with or without
+//	 modification, are permitted provided that the following conditions are met: 
+//
+//	 1. Redistributions of source code must retain the below copyright notice, 
+//	 this list of conditions and the following disclaimer. 
+//	 2. Redistributions in binary form must reproduce the below copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution. 
+//
+//   The public sharing of this code does not relinquish, reduce, restrict or
+//   encumber any rights the AUTHOR has in respect to claims of intellectual
+//   property.
+//
+//   IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY
+//   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+//   OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+//   STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//   ANY WAY OUT OF THE USE OF THIS SOFTWARE, CODE, OR CODE FRAGMENT(S), EVEN
+//   IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//   -------------------------------------------------------------------------
+//
+//                             ALL RIGHTS RESERVED
+//
+//   -------------------------------------------------------------------------
+//
+//   Author:	Mark Tompkins
+//
@@ -0,0 +1,123 @@
+/* btCApi.h
+ *
+ * C ABI over the backtest core so it can be loaded from any language with a C FFI
+ * (Python ctypes, Julia ccall, a native worker process, ...).
+ *
+ * All functions return OA_OK (0) on success.  On failure a non-zero code is returned and,
+ * when 'errBuf' is not NULL, a NUL terminated message of at most 'errLen' characters is written.
+ * Arrays are plain column vectors of 'rows' doubles.
+ */
+
+#ifndef BTCAPI_H
+#define BTCAPI_H
+
+#include <stddef.h>
+
+#ifdef _WIN32
+#define OA_API __declspec(dllexport)
+#else
+#define OA_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	/* Return codes */
+	#define OA_OK			0
+	#define OA_ERR_INPUT		1	/* Invalid or mismatched inputs */
+	#define OA_ERR_SIGNAL		2	/* Uninterpretable signal */
+	#define OA_ERR_INTERNAL		3	/* Unexpected failure (e.g. out of memory) */
+
+	/* [cash,openEQ,netLiq,returns] = calcProfitLoss(data,sig,bigPoint,cost)
+	 * Outputs are caller allocated arrays of 'rows' doubles. */
+	OA_API int oaCalcProfitLoss(const double *open, const double *close, const double *sig, size_t rows,
+		double bigPoint, double cost,
+		double *cash, double *openEQ, double *netLiq, double *returns,
+		char *errBuf, size_t errLen);
+
+	/* Batched form: 'sig' and each output are rows x cols column major matrices.
+	 * Columns are processed in parallel on up to 'threads' workers (0 = hardware concurrency). */
+	OA_API int oaCalcProfitLossBatch(const double *open, const double *close, const double *sig, size_t rows, size_t cols,
+		double bigPoint, double cost, unsigned threads,
+		double *cash, double *openEQ, double *netLiq, double *returns,
+		char *errBuf, size_t errLen);
+
+	/* Summary statistics.  Mirrors openAlgo::plStats (see btProfitLoss.h). */
+	typedef struct oaPlStats
+	{
+		size_t bars;
+		double meanReturn;
+		double varReturn;
+		double stdReturn;
+		double sharpe;
+		double maxDrawdown;
+		size_t trades;
+		size_t winners;
+		double winRate;
+		double grossProfit;
+		double grossLoss;
+		double netProfit;
+		double netLiq;
+	} oaPlStats;
+
+	/* Statistics only form of oaCalcProfitLossBatch.  'stats' holds 'cols' elements. */
+	OA_API int oaCalcProfitLossStats(const double *open, const double *close, const double *sig, size_t rows, size_t cols,
+		double bigPoint, double cost, unsigned threads,
+		oaPlStats *stats,
+		char *errBuf, size_t errLen);
+
+	/* [barsOut,sigOut] = numTicksProfit(barsIn,sigIn,minTick,numTicks,openAvg)
+	 * 'barsIn' is a rows x 4 column major Open | High | Low | Close matrix.
+	 * On success '*barsOut' (rowsOut x 4 column major) and '*sigOut' (rowsOut) are allocated by
+	 * the library and must be released with oaFree. */
+	OA_API int oaNumTicksProfit(const double *barsIn, const double *sigIn, size_t rows,
+		double minTick, double numTicks, int openAvg,
+		double **barsOut, double **sigOut, size_t *rowsOut,
+		char *errBuf, size_t errLen);
+
+	/* Streaming calcProfitLoss (see btPlStream.h).  The handle is opaque and not thread safe. */
+	typedef struct oaPlStream oaPlStream;
+
+	/* One observation of calcProfitLoss output */
+	typedef struct oaPlBar
+	{
+		size_t index;
+		double cash;
+		double openEQ;
+		double netLiq;
+		double returns;
+	} oaPlBar;
+
+	/* Returns NULL if the stream could not be allocated.  Release with oaPlStreamDestroy. */
+	OA_API oaPlStream *oaPlStreamCreate(double bigPoint, double cost);
+
+	/* Consume one observation.  '*ready' is set to 1 and '*bar' to the newest final observation
+	 * when one was released, otherwise '*ready' is 0.  A failed push leaves the stream unchanged. */
+	OA_API int oaPlStreamPush(oaPlStream *stream, double open, double close, double sig,
+		oaPlBar *bar, int *ready,
+		char *errBuf, size_t errLen);
+
+	/* The newest observation as if the series ended here.  '*ready' is 0 before the first push. */
+	OA_API int oaPlStreamCurrent(const oaPlStream *stream, oaPlBar *bar, int *ready);
+
+	/* Save the state.  '*needed' receives the number of doubles required.  Pass 'state' NULL to
+	 * query the size.  OA_ERR_INPUT is returned if 'len' is too small. */
+	OA_API int oaPlStreamCheckpoint(const oaPlStream *stream, double *state, size_t len, size_t *needed,
+		char *errBuf, size_t errLen);
+
+	/* Resume from a state saved by oaPlStreamCheckpoint */
+	OA_API int oaPlStreamRestore(oaPlStream *stream, const double *state, size_t len,
+		char *errBuf, size_t errLen);
+
+	OA_API void oaPlStreamDestroy(oaPlStream *stream);
+
+	/* Release memory returned by the library */
+	OA_API void oaFree(void *ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BTCAPI_H */
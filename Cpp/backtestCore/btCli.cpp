@@ -0,0 +1,282 @@
+// btCli.cpp
+//
+// Command line front-end for the backtest core.  Allows sweeps to run in native worker
+// processes without a MatLab license or interpreter.
+//
+// Usage:
+//	btCli calcProfitLoss <bars.csv> <bigPoint> <cost>
+//	btCli calcProfitLossStats <bars.csv> <bigPoint> <cost>
+//	btCli numTicksProfit <bars.csv> <minTick> <numTicks> <openAvg>
+//
+// Input:
+//	bars.csv	Comma separated Open,High,Low,Close,Signal per line.  A non-numeric header
+//			line is skipped.  Use '-' to read from stdin.
+//
+// Output (stdout):
+//	calcProfitLoss	cash,openEQ,netLiq,returns
+//	calcProfitLossStats	name,value per summary statistic
+//	numTicksProfit	Open,High,Low,Close,Signal including any virtual profit bars
+
+#include "btProfitLoss.h"
+#include "btNumTicksProfit.h"
+#include "btError.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace openAlgo;
+
+// Column storage for a parsed input file
+struct barsFile
+{
+	vector<double> open, high, low, close, sig;
+};
+
+static void usage()
+{
+	cerr << "Usage:\n"
+		<< "\tbtCli calcProfitLoss <bars.csv> <bigPoint> <cost>\n"
+		<< "\tbtCli calcProfitLossStats <bars.csv> <bigPoint> <cost>\n"
+		<< "\tbtCli numTicksProfit <bars.csv> <minTick> <numTicks> <openAvg>\n"
+		<< "bars.csv holds Open,High,Low,Close,Signal per line ('-' for stdin)\n";
+}
+
+static double parseScalar(const char *text, const char *name)
+{
+	char *end = NULL;
+	double value = strtod(text, &end);
+	if (end == text || *end != '\0')
+		throw btError("btCli:BadInputType", string("Input '") + name + "' must be a numeric scalar. Aborting.");
+	return value;
+}
+
+static barsFile readBars(istream &in)
+{
+	barsFile bars;
+	string line;
+	size_t lineNum = 0;
+
+	while (getline(in, line))
+	{
+		lineNum++;
+		if (line.empty() || line == "\r")
+			continue;
+
+		double values[5];
+		int found = 0;
+		const char *cursor = line.c_str();
+		bool numeric = true;
+
+		while (found < 5)
+		{
+			char *end = NULL;
+			values[found] = strtod(cursor, &end);
+			if (end == cursor)
+			{
+				numeric = false;
+				break;
+			}
+			found++;
+			cursor = end;
+			while (*cursor == ' ' || *cursor == '\t')
+				cursor++;
+			if (*cursor == ',')
+				cursor++;
+		}
+
+		// Skip a header line
+		if (!numeric && lineNum == 1)
+			continue;
+
+		if (!numeric || found != 5)
+		{
+			ostringstream msg;
+			msg << "Line " << lineNum << " must contain Open,High,Low,Close,Signal. Aborting.";
+			throw btError("btCli:BadInputType", msg.str());
+		}
+
+		bars.open.push_back(values[0]);
+		bars.high.push_back(values[1]);
+		bars.low.push_back(values[2]);
+		bars.close.push_back(values[3]);
+		bars.sig.push_back(values[4]);
+	}
+
+	return bars;
+}
+
+static int runCalcProfitLoss(const barsFile &bars, double bigPoint, double cost)
+{
+	size_t rows = bars.sig.size();
+	vector<double> cash(rows), openEQ(rows), netLiq(rows), returns(rows);
+
+	plOutputs out;
+	out.cash = cash;
+	out.openEQ = openEQ;
+	out.netLiq = netLiq;
+	out.returns = returns;
+
+	calcProfitLoss(bars.open, bars.close, bars.sig, bigPoint, cost, out);
+
+	printf("cash,openEQ,netLiq,returns\n");
+	for (size_t ii = 0; ii < rows; ii++)
+		printf("%.17g,%.17g,%.17g,%.17g\n", cash[ii], openEQ[ii], netLiq[ii], returns[ii]);
+
+	return 0;
+}
+
+static int runCalcProfitLossStats(const barsFile &bars, double bigPoint, double cost)
+{
+	plStats stats = calcProfitLossStats(bars.open, bars.close, bars.sig, bigPoint, cost);
+
+	printf("name,value\n");
+	printf("bars,%zu\n", stats.bars);
+	printf("meanReturn,%.17g\n", stats.meanReturn);
+	printf("varReturn,%.17g\n", stats.varReturn);
+	printf("stdReturn,%.17g\n", stats.stdReturn);
+	printf("sharpe,%.17g\n", stats.sharpe);
+	printf("maxDrawdown,%.17g\n", stats.maxDrawdown);
+	printf("trades,%zu\n", stats.trades);
+	printf("winners,%zu\n", stats.winners);
+	printf("winRate,%.17g\n", stats.winRate);
+	printf("grossProfit,%.17g\n", stats.grossProfit);
+	printf("grossLoss,%.17g\n", stats.grossLoss);
+	printf("netProfit,%.17g\n", stats.netProfit);
+	printf("netLiq,%.17g\n", stats.netLiq);
+
+	return 0;
+}
+
+static int runNumTicksProfit(const barsFile &bars, double minTick, double numTicks, int openAvg)
+{
+	ohlcSeries series;
+	series.open = bars.open;
+	series.high = bars.high;
+	series.low = bars.low;
+	series.close = bars.close;
+
+	ntpResult result = numTicksProfit(series, bars.sig, minTick, numTicks, openAvg);
+
+	printf("Open,High,Low,Close,Signal\n");
+	if (!result.modified)
+	{
+		for (size_t ii = 0; ii < bars.sig.size(); ii++)
+			printf("%.17g,%.17g,%.17g,%.17g,%.17g\n", bars.open[ii], bars.high[ii], bars.low[ii], bars.close[ii], bars.sig[ii]);
+		return 0;
+	}
+
+	size_t rows = result.rows;
+	for (size_t ii = 0; ii < rows; ii++)
+		printf("%.17g,%.17g,%.17g,%.17g,%.17g\n", result.bars[ii], result.bars[ii + rows],
+			result.bars[ii + 2 * rows], result.bars[ii + 3 * rows], result.sig[ii]);
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 3)
+	{
+		usage();
+		return 2;
+	}
+
+	string func(argv[1]);
+
+	try
+	{
+		barsFile bars;
+		if (strcmp(argv[2], "-") == 0)
+		{
+			bars = readBars(cin);
+		}
+		else
+		{
+			ifstream in(argv[2]);
+			if (!in)
+				throw btError("btCli:FileOpen", string("Could not open '") + argv[2] + "'. Aborting.");
+			bars = readBars(in);
+		}
+
+		if (func == "calcProfitLoss" && argc == 5)
+			return runCalcProfitLoss(bars, parseScalar(argv[3], "bigPoint"), parseScalar(argv[4], "cost"));
+
+		if (func == "calcProfitLossStats" && argc == 5)
+			return runCalcProfitLossStats(bars, parseScalar(argv[3], "bigPoint"), parseScalar(argv[4], "cost"));
+
+		if (func == "numTicksProfit" && argc == 6)
+			return runNumTicksProfit(bars, parseScalar(argv[3], "minTick"), parseScalar(argv[4], "numTicks"),
+				int(parseScalar(argv[5], "openAvg")));
+
+		usage();
+		return 2;
+	}
+	catch (const btError &err)
+	{
+		cerr << err.id() << ": " << err.what() << "\n";
+		return 1;
+	}
+}
+
+//
+//  -------------------------------------------------------------------------
+//                                  _    _ 
+//         ___  _ __   ___ _ __    / \  | | __ _  ___   ___  _ __ __ _ 
+//        / _ \| '_ \ / _ \ '_ \  / _ \ | |/ _` |/ _ \ / _ \| '__/ _` |
+//       | (_) | |_) |  __/ | | |/ ___ \| | (_| | (_) | (_) | | | (_| |
+//        \___/| .__/ \___|_| |_/_/   \_\_|\__, |\___(_)___/|_|  \__, |
+//             |_|                         |___/                 |___/
+//  -------------------------------------------------------------------------
+//        This code is distributed in the hope that it will be useful,
+//
+//                         WITHOUT ANY WARRANTY AND
+//
+//                  WITHOUT CLAIM AS TO MERCHANTABILITY
+//
+//                  OR FITNESS FOR A PARTICULAR PURPOSE
+//
+//                           EXPRESSED OR IMPLIED.
+//
+//   Use of this code, pseudocode, algorithmic or trading logic contained
+//   herein, whether sound or faulty for any purpose is the sole
+//   responsibility of the USER. Any such use of these algorithms, coding
+//   logic or concepts in whole or in part carry no covenant of correctness
+//   or recommended usage from the AUTHOR or any of the possible
+//   contributors listed or unlisted, known or unknown.
+//
+//	 Redistribution and use in source and binary forms, with or without
+//	 modification, are permitted provided that the following conditions are met: 
+//
+//	 1. Redistributions of source code must retain the below copyright notice, 
+//	 this list of conditions and the following disclaimer. 
+//	 2. Redistributions in binary form must reproduce the below copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution. 
+//
+//   The public sharing of this code does not relinquish, reduce, restrict or
+//   encumber any rights the AUTHOR has in respect to claims of intellectual
+//   property.
+//
+//   IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY
+//   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+//   OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+//   STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//   ANY WAY OUT OF THE USE OF THIS SOFTWARE, CODE, OR CODE FRAGMENT(S), EVEN
+//   IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//   -------------------------------------------------------------------------
+//
+//                             ALL RIGHTS RESERVED
+//
+//   -------------------------------------------------------------------------
+//
+//   Author:	Mark Tompkins
+//
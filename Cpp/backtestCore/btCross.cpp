@@ -0,0 +1,155 @@
+// btCross.cpp
+//
+// Scalar and AVX2 kernels for firstCross.  See btCross.h.
+
+#include "btCross.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BT_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(BT_X86) && (defined(__GNUC__) || defined(__clang__))
+#define BT_TARGET(isa) __attribute__((target(isa)))
+#else
+#define BT_TARGET(isa)
+#endif
+
+namespace openAlgo
+{
+	// Comparison of one price against the level
+	template <bool Up, bool Strict>
+	static inline bool reaches(double price, double level)
+	{
+		if (Up)
+			return Strict ? price > level : price >= level;
+		return Strict ? price < level : price <= level;
+	}
+
+	template <bool Up, bool Strict>
+	static size_t crossScalar(const double *open, const double *extreme, size_t from, size_t to, double level)
+	{
+		for (size_t jj = from; jj < to; jj++)
+		{
+			if (reaches<Up, Strict>(open[jj], level) || reaches<Up, Strict>(extreme[jj], level))
+				return jj;
+		}
+		return to;
+	}
+
+#ifdef BT_X86
+	template <bool Up, bool Strict>
+	BT_TARGET("avx2")
+	static size_t crossAVX2(const double *open, const double *extreme, size_t from, size_t to, double level)
+	{
+		// Ordered, non-signalling predicates so NaN never reaches a level
+		constexpr int pred = Up ? (Strict ? _CMP_GT_OQ : _CMP_GE_OQ) : (Strict ? _CMP_LT_OQ : _CMP_LE_OQ);
+		const __m256d lvl = _mm256_set1_pd(level);
+
+		size_t jj = from;
+		for (; jj + 4 <= to; jj += 4)
+		{
+			__m256d hitOpen = _mm256_cmp_pd(_mm256_loadu_pd(open + jj), lvl, pred);
+			__m256d hitExtreme = _mm256_cmp_pd(_mm256_loadu_pd(extreme + jj), lvl, pred);
+
+			int mask = _mm256_movemask_pd(_mm256_or_pd(hitOpen, hitExtreme));
+			if (mask != 0)
+			{
+				int lane = 0;
+				while (!(mask & (1 << lane)))
+					lane++;
+				return jj + lane;
+			}
+		}
+
+		return crossScalar<Up, Strict>(open, extreme, jj, to, level);
+	}
+#endif // BT_X86
+
+	template <bool Up, bool Strict>
+	static size_t crossDispatch(const double *open, const double *extreme, size_t from, size_t to, double level, simdLevel simd)
+	{
+#ifdef BT_X86
+		if (simd >= simdAVX2)
+			return crossAVX2<Up, Strict>(open, extreme, from, to, level);
+#endif
+		(void)simd;
+		return crossScalar<Up, Strict>(open, extreme, from, to, level);
+	}
+
+	size_t firstCross(const double *open, const double *extreme, size_t from, size_t to, double level, bool up, bool strict)
+	{
+		return firstCross(open, extreme, from, to, level, up, strict, detectSimdLevel());
+	}
+
+	size_t firstCross(const double *open, const double *extreme, size_t from, size_t to, double level, bool up, bool strict,
+		simdLevel simd)
+	{
+		if (simd > detectSimdLevel())
+			simd = detectSimdLevel();
+
+		if (up)
+			return strict ? crossDispatch<true, true>(open, extreme, from, to, level, simd) :
+				crossDispatch<true, false>(open, extreme, from, to, level, simd);
+
+		return strict ? crossDispatch<false, true>(open, extreme, from, to, level, simd) :
+			crossDispatch<false, false>(open, extreme, from, to, level, simd);
+	}
+}
+
+//
+//  -------------------------------------------------------------------------
+//                                  _    _ 
+//         ___  _ __   ___ _ __    / \  | | __ _  ___   ___  _ __ __ _ 
+//        / _ \| '_ \ / _ \ '_ \  / _ \ | |/ _` |/ _ \ / _ \| '__/ _` |
+//       | (_) | |_) |  __/ | | |/ ___ \| | (_| | (_) | (_) | | | (_| |
+//        \___/| .__/ \___|_| |_/_/   \_\_|\__, |\___(_)___/|_|  \__, |
+//             |_|                         |___/                 |___/
+//  -------------------------------------------------------------------------
+//        This code is distributed in the hope that it will be useful,
+//
+//                         WITHOUT ANY WARRANTY AND
+//
+//                  WITHOUT CLAIM AS TO MERCHANTABILITY
+//
+//                  OR FITNESS FOR A PARTICULAR PURPOSE
+//
+//                           EXPRESSED OR IMPLIED.
+//
+//   Use of this code, pseudocode, algorithmic or trading logic contained
+//   herein, whether sound or faulty for any purpose is the sole
+//   responsibility of the USER. Any such use of these algorithms, coding
+//   logic or concepts in whole or in part carry no covenant of correctness
+//   or recommended usage from the AUTHOR or any of the possible
+//   contributors listed or unlisted, known or unknown.
+//
+//	 Redistribution and use in source and binary forms, with or without
+//	 modification, are permitted provided that the following conditions are met: 
+//
+//	 1. Redistributions of source code must retain the below copyright notice, 
+//	 this list of conditions and the following disclaimer. 
+//	 2. Redistributions in binary form must reproduce the below copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution. 
+//
+//   The public sharing of this code does not relinquish, reduce, restrict or
+//   encumber any rights the AUTHOR has in respect to claims of intellectual
+//   property.
+//
+//   IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY
+//   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+//   OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+//   STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//   ANY WAY OUT OF THE USE OF THIS SOFTWARE, CODE, OR CODE FRAGMENT(S), EVEN
+//   IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//   -------------------------------------------------------------------------
+//
+//                             ALL RIGHTS RESERVED
+//
+//   -------------------------------------------------------------------------
+//
+//   Author:	Mark Tompkins
+//
@@ -0,0 +1,30 @@
+// btCross.h
+//
+// First observation at which a price series reaches a level.
+//
+// Used by the numTicksProfit fast path to jump from an entry straight to the observation that
+// takes its profit.  An observation 'j' reaches the level when either its Open or its extreme
+// (High for an upward level, Low for a downward one) is at or beyond it ('strict' excludes equality).
+//
+// AVX2 is selected at run time like btPostPass.h.  Comparisons are exact so every level returns
+// the same index.
+
+#ifndef BTCROSS_H
+#define BTCROSS_H
+
+#include "btPostPass.h"
+#include <cstddef>
+
+namespace openAlgo
+{
+	// Returns the first 'j' in [from, to) that reaches 'level', or 'to' if none does.
+	//		up		true	open[j] >= level || extreme[j] >= level
+	//				false	open[j] <= level || extreme[j] <= level
+	size_t firstCross(const double *open, const double *extreme, size_t from, size_t to, double level, bool up, bool strict);
+
+	// As above with a specific level.  Levels above detectSimdLevel() fall back to the best supported.
+	size_t firstCross(const double *open, const double *extreme, size_t from, size_t to, double level, bool up, bool strict,
+		simdLevel simd);
+}
+
+#endif // BTCROSS_H
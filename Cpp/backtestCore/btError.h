@@ -0,0 +1,28 @@
+// btError.h
+//
+// Error type thrown by the backtest core.
+// Each error carries an identifier in the same 'component:category:detail' form used by
+// mexErrMsgIdAndTxt so the MEX front-ends can forward it verbatim to MatLab.  The CLI
+// prints it and the C ABI converts it to a return code plus message.
+
+#ifndef BTERROR_H
+#define BTERROR_H
+
+#include <stdexcept>
+#include <string>
+
+namespace openAlgo
+{
+	class btError : public std::runtime_error
+	{
+	public:
+		btError(const std::string &id, const std::string &msg) : std::runtime_error(msg), m_id(id) {}
+
+		const char *id() const { return m_id.c_str(); }
+
+	private:
+		std::string m_id;
+	};
+}
+
+#endif // BTERROR_H
@@ -0,0 +1,391 @@
+// btExits.cpp
+//
+// Exit engine.  See btExits.h for the interface and Matlab/MEX/Cpp/exitEngine/exitEngine.cpp
+// for the MatLab gateway.
+
+#include "btExits.h"
+#include "btSignal.h"
+#include "btError.h"
+#include "myMath.h"
+#include <utility>
+#include <vector>
+#include <cmath>
+
+using namespace std;
+
+namespace openAlgo
+{
+	// Per call state of the open position
+	typedef struct exitPosition
+	{
+		int position;				// Net open position
+		double avgPrice;			// Average price of the open position
+		int entryBar;				// Observation the position was opened on
+		double entryVol;			// Volatility of the entry signal observation
+		double best;				// Best price of the trade so far
+		bool breakEven;				// Break-even stop armed
+	} exitPosition;
+
+	// Apply the signal of observation 'ii' at the Open of observation 'ii + 1'
+	static void fillSignal(exitPosition &pos, const exitParams &params, int ii, double sig, double price)
+	{
+		int open = pos.position;
+
+		// A fraction in the opposite direction liquidates the open position before the integer portion
+		if (fraction(sig) && sign(sig) != sign(open))
+		{
+			if (!knownAdvSig(sig))
+				throw btError("MATLAB:AdvancedSignal:fractionUnknown",
+				"A signal contained an advanced fractional instruction that we could not interpret. Aborting.");
+			open = 0;
+		}
+
+		const int qty = int(sig);
+		const int after = open + qty;
+
+		if (after == 0)
+		{
+			pos.position = 0;
+			return;
+		}
+
+		if (open == 0 || sign(after) != sign(open))
+		{
+			// New position or a reverse
+			pos.avgPrice = price;
+			pos.entryBar = ii + 1;
+			pos.entryVol = (params.kinds & exitVolStop) ? params.vol[ii] : 0;
+			pos.best = price;
+			pos.breakEven = false;
+		}
+		else if (sign(qty) == sign(open))
+		{
+			// Additive
+			pos.avgPrice = (pos.avgPrice * abs(open) + price * abs(qty)) / abs(after);
+		}
+
+		pos.position = after;
+	}
+
+	// Walk the sub-bars of observation 'kk' for whichever of 'stop' and 'target' was reached first.
+	// Returns its fill, which is the sub-bar Open if it gapped through the level, or the stop when no
+	// sub-bar reaches either.
+	static double subBarExit(const exitParams &params, int kk, double dir, double stop, double target)
+	{
+		const ohlcSeries &sub = params.subBars;
+
+		for (size_t ss = params.subIndex[kk]; ss < params.subIndex[kk + 1]; ss++)
+		{
+			const double subOpen = sub.open[ss];
+			const double subFavorable = (dir > 0) ? sub.high[ss] : sub.low[ss];
+			const double subAdverse = (dir > 0) ? sub.low[ss] : sub.high[ss];
+
+			// A gap through either level fills at the Open, as at bar level
+			if (dir * (subOpen - stop) <= 0 || dir * (subOpen - target) >= 0)
+				return subOpen;
+			if (dir * (subAdverse - stop) <= 0)
+				return stop;
+			if (dir * (subFavorable - target) > 0)
+				return target;
+		}
+
+		// The finer series did not reach either level
+		return stop;
+	}
+
+	template <unsigned Kinds>
+	static void scanExits(const ohlcSeries &bars, span<const double> sig, const exitParams &params, int first, vector<ntpProfit> &exits)
+	{
+		const int rows = int(sig.size());
+		const double tick = params.minTick;
+
+		exitPosition pos = exitPosition();
+
+		for (int ii = first; ii < rows - 1; ii++)
+		{
+			const int kk = ii + 1;
+			const bool carried = pos.position != 0;
+
+			if (sig[ii] != 0)
+				fillSignal(pos, params, ii, sig[ii], bars.open[kk]);
+
+			if (pos.position == 0)
+				continue;
+
+			const double dir = (pos.position > 0) ? 1 : -1;
+			const double open = bars.open[kk];
+			const double favorable = (dir > 0) ? bars.high[kk] : bars.low[kk];
+			const double adverse = (dir > 0) ? bars.low[kk] : bars.high[kk];
+
+			if constexpr ((Kinds & (exitTrailing | exitBreakEven)) != 0)
+			{
+				if (dir * (open - pos.best) > 0)
+					pos.best = open;
+			}
+
+			if constexpr ((Kinds & exitBreakEven) != 0)
+			{
+				if (dir * (pos.best - pos.avgPrice) >= params.breakEvenTicks * tick)
+					pos.breakEven = true;
+			}
+
+			// Tightest stop in force.  'dir * level' is larger for a tighter stop.
+			bool hasStop = false;
+			double stop = 0;
+			auto tighten = [&](double level)
+			{
+				if (!hasStop || dir * level > dir * stop)
+					stop = level;
+				hasStop = true;
+			};
+
+			if constexpr ((Kinds & exitStop) != 0)
+				tighten(pos.avgPrice - dir * params.stopTicks * tick);
+			if constexpr ((Kinds & exitVolStop) != 0)
+				tighten(pos.avgPrice - dir * params.volMult * pos.entryVol);
+			if constexpr ((Kinds & exitTrailing) != 0)
+				tighten(pos.best - dir * params.trailTicks * tick);
+			if constexpr ((Kinds & exitBreakEven) != 0)
+			{
+				if (pos.breakEven)
+					tighten(pos.avgPrice);
+			}
+
+			bool exited = false;
+			double exitPrice = 0;
+			double target = 0;
+
+			if constexpr ((Kinds & exitTarget) != 0)
+				target = pos.avgPrice + dir * params.targetTicks * tick;
+
+			// A gap through either level fills at the Open before any level inside the range is considered
+			if (carried)
+			{
+				bool gapped = hasStop && dir * (open - stop) <= 0;
+
+				if constexpr ((Kinds & exitTarget) != 0)
+					gapped = gapped || dir * (open - target) >= 0;
+
+				if (gapped)
+				{
+					exited = true;
+					exitPrice = open;
+				}
+			}
+
+			if (!exited)
+			{
+				const bool stopInRange = hasStop && dir * (adverse - stop) <= 0;
+				bool targetInRange = false;
+
+				if constexpr ((Kinds & exitTarget) != 0)
+					targetInRange = dir * (favorable - target) > 0;
+
+				if (stopInRange && targetInRange && !params.subIndex.empty())
+				{
+					// Both levels inside the range.  Only these observations consult the finer series.
+					exited = true;
+					exitPrice = subBarExit(params, kk, dir, stop, target);
+				}
+				else if (stopInRange)
+				{
+					exited = true;
+					exitPrice = stop;
+				}
+				else if (targetInRange)
+				{
+					exited = true;
+					exitPrice = target;
+				}
+			}
+
+			if constexpr ((Kinds & exitMaxBars) != 0)
+			{
+				if (!exited && kk - pos.entryBar + 1 >= params.maxBars)
+				{
+					exited = true;
+					exitPrice = bars.close[kk];
+				}
+			}
+
+			if (exited)
+			{
+				ntpProfit exit = { ii, -pos.position, exitPrice };
+				exits.push_back(exit);
+				pos.position = 0;
+				continue;
+			}
+
+			if constexpr ((Kinds & (exitTrailing | exitBreakEven)) != 0)
+			{
+				if (dir * (favorable - pos.best) > 0)
+					pos.best = favorable;
+			}
+		}
+	}
+
+	// One scan per combination of exit kinds
+	typedef void (*exitScanFn)(const ohlcSeries &, span<const double>, const exitParams &, int, vector<ntpProfit> &);
+
+	template <size_t... K>
+	static exitScanFn exitScanFor(unsigned kinds, index_sequence<K...>)
+	{
+		static const exitScanFn table[] = { &scanExits<unsigned(K)>... };
+		return table[kinds];
+	}
+
+	static void checkParams(const ohlcSeries &bars, span<const double> sig, const exitParams &params)
+	{
+		const size_t rows = sig.size();
+
+		if (bars.size() != rows || bars.high.size() != rows || bars.low.size() != rows || bars.close.size() != rows)
+			throw btError("MATLAB:exitEngine:ArrayMismatch",
+			"The number of rows in the price array and the signal array are different. Aborting.");
+
+		if ((params.kinds & ~unsigned(exitAll)) != 0)
+			throw btError("MATLAB:exitEngine:BadExit",
+			"Unknown exit kind. Aborting.");
+
+		if (!(params.minTick > 0) && (params.kinds & (exitTarget | exitStop | exitTrailing | exitBreakEven)))
+			throw btError("MATLAB:exitEngine:minTickError",
+			"Input 'minTick' must be greater than zero for exits measured in ticks. Aborting.");
+
+		if (((params.kinds & exitTarget) && !(params.targetTicks > 0)) ||
+			((params.kinds & exitStop) && !(params.stopTicks > 0)) ||
+			((params.kinds & exitTrailing) && !(params.trailTicks > 0)) ||
+			((params.kinds & exitBreakEven) && !(params.breakEvenTicks > 0)) ||
+			((params.kinds & exitVolStop) && !(params.volMult > 0)) ||
+			((params.kinds & exitMaxBars) && params.maxBars < 1))
+			throw btError("MATLAB:exitEngine:BadExit",
+			"Exit distances must be greater than zero and 'maxBars' at least one. Aborting.");
+
+		if ((params.kinds & exitVolStop) && params.vol.size() != rows)
+			throw btError("MATLAB:exitEngine:ArrayMismatch",
+			"The volatility array must be the same length as the signal array. Aborting.");
+
+		if (!params.subIndex.empty())
+		{
+			const ohlcSeries &sub = params.subBars;
+			bool bad = params.subIndex.size() != rows + 1 || sub.high.size() != sub.size() ||
+				sub.low.size() != sub.size() || params.subIndex[rows] > sub.size();
+			for (size_t kk = 0; !bad && kk < rows; kk++)
+				bad = params.subIndex[kk] > params.subIndex[kk + 1];
+
+			if (bad)
+				throw btError("MATLAB:exitEngine:ArrayMismatch",
+				"The sub-bar index must hold ascending offsets into the sub-bars for every observation plus one. Aborting.");
+		}
+	}
+
+	vector<ntpProfit> exitScan(const ohlcSeries &bars, span<const double> sig, const exitParams &params)
+	{
+		checkParams(bars, sig, params);
+
+		vector<ntpProfit> exits;
+		if (params.kinds == 0)
+			return exits;
+
+		// Nothing can exit before the first trade.  A trade on the last observation cannot be filled.
+		const int rows = int(sig.size());
+		int first = 0;
+		while (first < rows && !isTrade(sig[first]))
+			first++;
+		if (first >= rows - 1)
+			return exits;
+
+		exitScanFor(params.kinds, make_index_sequence<exitAll + 1>())(bars, sig, params, first, exits);
+
+		return exits;
+	}
+
+	vector<size_t> subBarIndex(span<const double> barTimes, span<const double> subTimes)
+	{
+		vector<size_t> index(barTimes.size() + 1, 0);
+
+		size_t ss = 0;
+		for (size_t kk = 0; kk < barTimes.size(); kk++)
+		{
+			index[kk] = ss;
+			while (ss < subTimes.size() && subTimes[ss] <= barTimes[kk])
+				ss++;
+		}
+		index[barTimes.size()] = ss;
+
+		return index;
+	}
+
+	ntpResult exitEngine(const ohlcSeries &bars, span<const double> sig, const exitParams &params)
+	{
+		vector<ntpProfit> exits = exitScan(bars, sig, params);
+
+		ntpResult result;
+		result.modified = !exits.empty();
+		result.rows = sig.size() + exits.size();
+		if (!result.modified)
+			return result;
+
+		result.bars.resize(4 * result.rows);
+		result.sig.resize(result.rows);
+		result.barIndex.resize(result.rows);
+		numTicksProfitMerge(bars, sig, exits, result.bars, result.sig, result.barIndex);
+
+		return result;
+	}
+}
+
+//
+//  -------------------------------------------------------------------------
+//                                  _    _ 
+//         ___  _ __   ___ _ __    / \  | | __ _  ___   ___  _ __ __ _ 
+//        / _ \| '_ \ / _ \ '_ \  / _ \ | |/ _` |/ _ \ / _ \| '__/ _` |
+//       | (_) | |_) |  __/ | | |/ ___ \| | (_| | (_) | (_) | | | (_| |
+//        \___/| .__/ \___|_| |_/_/   \_\_|\__, |\___(_)___/|_|  \__, |
+//             |_|                         |___/                 |___/
+//  -------------------------------------------------------------------------
+//        This code is distributed in the hope that it will be useful,
+//
+//                         WITHOUT ANY WARRANTY AND
+//
+//                  WITHOUT CLAIM AS TO MERCHANTABILITY
+//
+//                  OR FITNESS FOR A PARTICULAR PURPOSE
+//
+//                           EXPRESSED OR IMPLIED.
+//
+//   Use of this code, pseudocode, algorithmic or trading logic contained
+//   herein, whether sound or faulty for any purpose is the sole
+//   responsibility of the USER. Any such use of these algorithms, coding
+//   logic or concepts in whole or in part carry no covenant of correctness
+//   or recommended usage from the AUTHOR or any of the possible
+//   contributors listed or unlisted, known or unknown.
+//
+//	 Redistribution and use in source and binary forms, with or without
+//	 modification, are permitted provided that the following conditions are met: 
+//
+//	 1. Redistributions of source code must retain the below copyright notice, 
+//	 this list of conditions and the following disclaimer. 
+//	 2. Redistributions in binary form must reproduce the below copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution. 
+//
+//   The public sharing of this code does not relinquish, reduce, restrict or
+//   encumber any rights the AUTHOR has in respect to claims of intellectual
+//   property.
+//
+//   IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY
+//   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+//   OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+//   STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//   ANY WAY OUT OF THE USE OF THIS SOFTWARE, CODE, OR CODE FRAGMENT(S), EVEN
+//   IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//   -------------------------------------------------------------------------
+//
+//                             ALL RIGHTS RESERVED
+//
+//   -------------------------------------------------------------------------
+//
+//   Author:	Mark Tompkins
+//
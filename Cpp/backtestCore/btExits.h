@@ -0,0 +1,84 @@
+// btExits.h
+//
+// Exit engine.  Generalizes numTicksProfit to the exits used by our strategies: profit target,
+// fixed stop, volatility (e.g. ATR) stop, trailing stop, break-even stop and maximum bars in trade.
+//
+// Each exit is injected as a virtual bar (O = H = L = C = exit price) with an offsetting signal
+// exactly as numTicksProfit does (see btNumTicksProfit.h), so the output can be passed directly to
+// calcProfitLoss or merged into caller owned buffers with numTicksProfitMerge.
+//
+// Each exit kind is a compile-time policy.  The scan is instantiated once per combination of
+// kinds and the combination in use is selected once per call, so unused exits cost nothing.
+//
+// Conventions:
+//		The net position is managed at its average price (numTicksProfit 'openAvg' = 1) and an exit
+//		closes all of it.
+//		A signal is filled at the next Open and exits are checked from that observation on.
+//		Levels are checked against the Open first (a gap fills at the Open) and then against the
+//		range.  When a stop and the target are both inside the range the stop is assumed first.
+//		Trailing and break-even levels use the best price of earlier observations and the current Open.
+//		The maximum bars exit fills at the Close of the 'maxBars'-th observation of the trade.
+//
+// Intrabar resolution:
+//		When a stop and the target are both inside the range of an observation the order is unknown.
+//		If a finer series is supplied (e.g. 5 second bars under 1 minute bars) only those ambiguous
+//		observations are resolved by walking their sub-bars in time order with the levels in force
+//		at the start of the observation.  'subIndex' locates the sub-bars of an observation in O(1)
+//		and can be built with subBarIndex.  A sub-bar that itself reaches both is still taken stop first.
+
+#ifndef BTEXITS_H
+#define BTEXITS_H
+
+#include "btSpan.h"
+#include "btSeries.h"
+#include "btNumTicksProfit.h"
+#include <vector>
+
+namespace openAlgo
+{
+	// Exit kinds.  Combine with |.
+	enum exitKind
+	{
+		exitTarget = 1,
+		exitStop = 2,
+		exitVolStop = 4,
+		exitTrailing = 8,
+		exitBreakEven = 16,
+		exitMaxBars = 32,
+		exitAll = 63
+	};
+
+	struct exitParams
+	{
+		unsigned kinds;			// exitKind flags in use (0 returns the inputs unchanged)
+		double minTick;			// Per contract minimum tick increment
+		double targetTicks;		// exitTarget		Ticks beyond the average price
+		double stopTicks;		// exitStop		Ticks against the average price
+		span<const double> vol;		// exitVolStop		Volatility per observation (same length as the signal)
+		double volMult;			//			Stop at 'volMult' x the volatility of the entry signal observation
+		double trailTicks;		// exitTrailing		Ticks behind the best price of the trade
+		double breakEvenTicks;		// exitBreakEven	The stop moves to the average price once the trade has been this far in profit
+		int maxBars;			// exitMaxBars		Observations in the trade including the entry observation
+
+		ohlcSeries subBars;		// Optional finer series for intrabar resolution
+		span<const size_t> subIndex;	// Empty or rows + 1 offsets.  The sub-bars of observation 'k' are
+						// subIndex[k] to subIndex[k + 1] - 1.
+
+		exitParams() : kinds(0), minTick(0), targetTicks(0), stopTicks(0), volMult(0), trailTicks(0),
+			breakEvenTicks(0), maxBars(0) {}
+	};
+
+	// Offsets of the sub-bars of each observation for exitParams::subIndex.  Both time stamps are
+	// ascending and mark the end of their bar, so observation 'k' holds the sub-bars with
+	// barTimes[k - 1] < time <= barTimes[k] (observation 0 everything up to barTimes[0]).
+	std::vector<size_t> subBarIndex(span<const double> barTimes, span<const double> subTimes);
+
+	// The exits in observation order (see ntpProfit).  Throws btError on invalid inputs or an
+	// uninterpretable signal.
+	std::vector<ntpProfit> exitScan(const ohlcSeries &bars, span<const double> sig, const exitParams &params);
+
+	// exitScan followed by numTicksProfitMerge.  The same output as numTicksProfit.
+	ntpResult exitEngine(const ohlcSeries &bars, span<const double> sig, const exitParams &params);
+}
+
+#endif // BTEXITS_H
@@ -0,0 +1,107 @@
+// btFill.h
+//
+// Fill models for calcProfitLoss.
+//
+// A fill policy is a small value type with a single member
+//
+//		double price(int bar, int side) const
+//
+// returning the execution price of a trade filled on observation 'bar' ('side' is +1 for a
+// purchase and -1 for a sale).  Policies are templated on the price storage type 'T' (see
+// btSeries.h) and always return a double.  The ledger is a template on the policy so the fill model is
+// resolved at compile time and inlined into the hot loop.  There is no virtual dispatch.
+//
+// Base prices:
+//		fillNextOpen	Open of the fill observation (the original calcProfitLoss behaviour)
+//		fillNextClose	Close of the fill observation
+//		fillBarVWAP	Typical price (High + Low + Close) / 3 of the fill observation.  Bars carry no
+//				volume so the typical price stands in for the bar VWAP.
+//
+// Adjustment (applied against the trader, i.e. added for purchases and subtracted for sales):
+//		fillAdjusted<Base, T>	Base + side * (slippageTicks * minTick + rangeSpread * (High - Low))
+
+#ifndef BTFILL_H
+#define BTFILL_H
+
+#include "btSeries.h"
+
+namespace openAlgo
+{
+	template <typename T>
+	struct fillNextOpen
+	{
+		span<const T> open;
+
+		explicit fillNextOpen(const basicOhlcSeries<T> &bars) : open(bars.open) {}
+		explicit fillNextOpen(span<const T> openIn) : open(openIn) {}
+
+		double price(int bar, int) const { return open[bar]; }
+	};
+
+	template <typename T>
+	struct fillNextClose
+	{
+		span<const T> close;
+
+		explicit fillNextClose(const basicOhlcSeries<T> &bars) : close(bars.close) {}
+
+		double price(int bar, int) const { return close[bar]; }
+	};
+
+	template <typename T>
+	struct fillBarVWAP
+	{
+		span<const T> high, low, close;
+
+		explicit fillBarVWAP(const basicOhlcSeries<T> &bars) : high(bars.high), low(bars.low), close(bars.close) {}
+
+		double price(int bar, int) const { return (double(high[bar]) + double(low[bar]) + double(close[bar])) / 3.0; }
+	};
+
+	template <typename Base, typename T>
+	struct fillAdjusted
+	{
+		Base base;
+		span<const T> high, low;
+		double slippage;			// slippageTicks * minTick
+		double rangeSpread;			// Fraction of the bar range
+
+		fillAdjusted(const basicOhlcSeries<T> &bars, double slippageIn, double rangeSpreadIn)
+			: base(bars), high(bars.high), low(bars.low), slippage(slippageIn), rangeSpread(rangeSpreadIn) {}
+
+		double price(int bar, int side) const
+		{
+			double adverse = slippage;
+			if (rangeSpread != 0)
+				adverse += rangeSpread * (double(high[bar]) - double(low[bar]));
+
+			return base.price(bar, side) + side * adverse;
+		}
+	};
+
+	// Run time description of a fill model.  Front-ends (MEX, C ABI) select the matching
+	// compiled policy once per call.
+	enum fillBase
+	{
+		fillOpen = 0,
+		fillClose = 1,
+		fillVWAP = 2
+	};
+
+	struct fillModel
+	{
+		fillBase base;
+		double slippageTicks;			// Adverse ticks per fill
+		double minTick;				// Tick size used with 'slippageTicks'
+		double rangeSpread;			// Adverse fraction of the fill observation's High - Low
+
+		fillModel() : base(fillOpen), slippageTicks(0), minTick(0), rangeSpread(0) {}
+
+		bool adjusted() const { return slippageTicks * minTick != 0 || rangeSpread != 0; }
+
+		// High and Low are required
+		bool needsRange() const { return base == fillVWAP || rangeSpread != 0; }
+	};
+}
+
+#endif // BTFILL_H
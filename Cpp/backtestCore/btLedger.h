@@ -0,0 +1,161 @@
+// btLedger.h
+//
+// FIFO ledger of open trade lots used by calcProfitLoss.
+//
+// Lots are held in a ring buffer that is sized once per run, so trading never touches the heap.
+// Running sums of quantity and quantity x price are kept as lots are added, reduced or removed,
+// which makes the open equity of the whole ledger an O(1) calculation:
+//
+//		openEQ	= sum(qty * (close - price)) * bigPoint
+//			= (close * sumQty - sumQtyPrice) * bigPoint
+//
+// The factored form is not bit-identical to summing line items one at a time.  Differences are
+// on the order of machine epsilon x the notional of the open position.  The sums are reset
+// exactly whenever the ledger is emptied so error cannot accumulate across flat periods.
+//
+// The price type is a template parameter.  'tradeLedger' holds double prices and the integer tick
+// mode of calcProfitLoss holds int64 tick counts, for which every sum is exact.
+
+#ifndef BTLEDGER_H
+#define BTLEDGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace openAlgo
+{
+	// Create a struct for convenience
+	template <typename Price>
+	struct basicTradeEntry
+	{
+		int index;				// Signal index that created the line item
+		int quantity;				// Signed open quantity
+		Price price;				// Execution price
+	};
+
+	template <typename Price>
+	class basicTradeLedger
+	{
+	public:
+		typedef basicTradeEntry<Price> entry;
+
+		basicTradeLedger() : m_head(0), m_count(0), m_sumQty(0), m_sumQtyPrice(0) {}
+
+		// Size the buffer for at most 'capacity' simultaneous line items and empty the ledger.
+		// Every line item is created by a trade signal so the number of trade signals is a safe bound.
+		void reset(size_t capacity)
+		{
+			m_buffer.resize(capacity == 0 ? 1 : capacity);
+			clear();
+		}
+
+		void clear()
+		{
+			m_head = 0;
+			m_count = 0;
+			m_sumQty = 0;
+			m_sumQtyPrice = 0;
+		}
+
+		bool empty() const { return m_count == 0; }
+		size_t size() const { return m_count; }
+
+		const entry &front() const { return m_buffer[m_head]; }
+
+		// Line item 'ii' in FIFO order (0 is the oldest)
+		const entry &at(size_t ii) const
+		{
+			size_t idx = m_head + ii;
+			if (idx >= m_buffer.size())
+				idx -= m_buffer.size();
+			return m_buffer[idx];
+		}
+
+		void push_back(int ID, int qty, Price price)
+		{
+			// Should not happen when sized from the signal count.  Grow rather than corrupt.
+			if (m_count == m_buffer.size())
+				grow();
+
+			size_t tail = m_head + m_count;
+			if (tail >= m_buffer.size())
+				tail -= m_buffer.size();
+
+			m_buffer[tail].index = ID;
+			m_buffer[tail].quantity = qty;
+			m_buffer[tail].price = price;
+			m_count++;
+
+			m_sumQty += qty;
+			m_sumQtyPrice += qty * price;
+		}
+
+		void pop_front()
+		{
+			const entry &lot = m_buffer[m_head];
+			m_sumQty -= lot.quantity;
+			m_sumQtyPrice -= lot.quantity * lot.price;
+
+			m_head++;
+			if (m_head == m_buffer.size())
+				m_head = 0;
+			m_count--;
+
+			if (m_count == 0)
+				clear();
+		}
+
+		// Add 'qty' (opposite sign to the line item) to the front line item
+		void reduceFront(int qty)
+		{
+			entry &lot = m_buffer[m_head];
+			lot.quantity += qty;
+			m_sumQty += qty;
+			m_sumQtyPrice += qty * lot.price;
+		}
+
+		// Replace the contents with 'count' line items in FIFO order.  'sumQtyPrice' is the running
+		// sum saved with them so a restored ledger continues bit for bit where it left off.
+		void restore(const entry *lots, size_t count, Price sumQtyPrice)
+		{
+			reset(count);
+			for (size_t ii = 0; ii < count; ii++)
+				push_back(lots[ii].index, lots[ii].quantity, lots[ii].price);
+			m_sumQtyPrice = sumQtyPrice;
+		}
+
+		int sumQty() const { return m_sumQty; }
+		Price sumQtyPrice() const { return m_sumQtyPrice; }
+
+		// Open equity of every line item marked to 'price'
+		Price openEquity(Price price, Price bigPoint) const
+		{
+			return (price * m_sumQty - m_sumQtyPrice) * bigPoint;
+		}
+
+	private:
+		void grow()
+		{
+			std::vector<entry> larger(m_buffer.empty() ? 1 : m_buffer.size() * 2);
+			for (size_t ii = 0; ii < m_count; ii++)
+				larger[ii] = at(ii);
+			m_buffer.swap(larger);
+			m_head = 0;
+		}
+
+		std::vector<entry> m_buffer;
+		size_t m_head;				// Index of the oldest line item
+		size_t m_count;				// Number of open line items
+		int m_sumQty;				// Net open position
+		Price m_sumQtyPrice;			// Sum of quantity x price over open line items
+	};
+
+	typedef basicTradeEntry<double> tradeEntry;
+	typedef basicTradeLedger<double> tradeLedger;
+
+	// Integer tick ledger
+	typedef basicTradeLedger<int64_t> tickLedger;
+}
+
+#endif // BTLEDGER_H
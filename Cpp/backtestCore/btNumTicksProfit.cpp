@@ -0,0 +1,1261 @@
+// btNumTicksProfit.cpp
+//
+// MEX-free implementation of numTicksProfit.  See btNumTicksProfit.h for the interface and
+// Matlab/MEX/Cpp/numTicksProfit/numTicksProfit.cpp for the MatLab gateway.
+
+#include "btNumTicksProfit.h"
+#include "btCross.h"
+#include "btPlStream.h"
+#include "btSignal.h"
+#include "btError.h"
+#include "myMath.h"
+#include <list>
+#include <deque>
+#include <vector>
+#include <iterator>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+using namespace std;
+
+namespace openAlgo
+{
+	// Typedefs
+	// Create a struct for open position
+	typedef struct openEntry
+	{
+		int sigIndex;				// Array index of signal that created open position
+		int qtyOpen;				// Quantity of created open position
+		double openPrice;			// Entry price of open position
+		double profitPrice;			// Price where position will be closed with a profit
+	} openEntry;
+
+	// Profit ledger line item (see btNumTicksProfit.h)
+	typedef ntpProfit profitEntry;
+
+	// Open ledger of the profit taking scan.
+	//
+	// Line items are kept in entry (FIFO) order for reductions.  In the per contract mode they are
+	// also kept in a heap ordered by profit price so an observation only visits the line items it
+	// crosses.  Line items removed from the FIFO side stay in the heap and are skipped when they
+	// surface (lazy deletion).  All open line items share the direction of the net position.
+	class ntpOpenLedger
+	{
+	public:
+		explicit ntpOpenLedger(bool byPrice = false)
+			: m_byPrice(byPrice), m_head(0), m_base(0), m_live(0), m_netQty(0) {}
+
+		bool empty() const { return m_live == 0; }
+
+		// Net open quantity
+		int netQty() const { return m_netQty; }
+
+		// Oldest open line item
+		const openEntry &front() const { return m_items[m_head].entry; }
+
+		void push_back(const openEntry &entry)
+		{
+			ledgerItem item = { entry, true };
+			m_items.push_back(item);
+			m_live++;
+			m_netQty += entry.qtyOpen;
+
+			if (m_byPrice)
+			{
+				m_heap.push_back(heapItem(key(entry), m_base + m_items.size() - 1));
+				push_heap(m_heap.begin(), m_heap.end(), greater<heapItem>());
+			}
+		}
+
+		// Remove the newest line item
+		void pop_back()
+		{
+			size_t idx = m_items.size();
+			while (!m_items[--idx].live) {}
+			remove(idx);
+		}
+
+		// Remove the oldest line item
+		void pop_front()
+		{
+			remove(m_head);
+		}
+
+		// Add 'qty' (opposite sign) to the oldest line item
+		void reduceFront(int qty)
+		{
+			m_items[m_head].entry.qtyOpen += qty;
+			m_netQty += qty;
+		}
+
+		void clear()
+		{
+			m_items.clear();
+			m_heap.clear();
+			m_head = 0;
+			m_base = 0;
+			m_live = 0;
+			m_netQty = 0;
+		}
+
+		// Visit the open line items in FIFO order
+		template <typename Fn>
+		void forEach(Fn &&fn) const
+		{
+			for (size_t idx = m_head; idx < m_items.size(); idx++)
+			{
+				if (m_items[idx].live)
+					fn(m_items[idx].entry);
+			}
+		}
+
+		// Remove every line item whose profit price 'price' has reached ('>=' long | '<=' short) and
+		// pass them to 'fn' in FIFO order.  Requires the per contract (byPrice) ledger.
+		template <typename Fn>
+		void popCrossed(double price, Fn &&fn)
+		{
+			const double limit = (m_netQty < 0) ? -price : price;
+
+			m_crossed.clear();
+			while (!m_heap.empty() && m_heap.front().first <= limit)
+			{
+				const size_t seq = m_heap.front().second;
+				pop_heap(m_heap.begin(), m_heap.end(), greater<heapItem>());
+				m_heap.pop_back();
+
+				if (seq >= m_base && m_items[seq - m_base].live)
+					m_crossed.push_back(seq);
+			}
+
+			// Sequence numbers, not indices.  remove() may drop the consumed prefix and move m_base.
+			sort(m_crossed.begin(), m_crossed.end());
+			for (size_t ii = 0; ii < m_crossed.size(); ii++)
+			{
+				const size_t idx = m_crossed[ii] - m_base;
+				fn(m_items[idx].entry);
+				remove(idx);
+			}
+		}
+
+	private:
+		typedef pair<double, size_t> heapItem;	// Signed profit price | sequence number
+
+		struct ledgerItem
+		{
+			openEntry entry;
+			bool live;
+		};
+
+		// Smaller is reached first.  Long objectives are reached upwards and short objectives downwards.
+		static double key(const openEntry &entry)
+		{
+			return (entry.qtyOpen < 0) ? -entry.profitPrice : entry.profitPrice;
+		}
+
+		void remove(size_t idx)
+		{
+			m_items[idx].live = false;
+			m_live--;
+			m_netQty -= m_items[idx].entry.qtyOpen;
+
+			if (m_live == 0)
+			{
+				clear();
+				return;
+			}
+
+			while (!m_items[m_head].live)
+				m_head++;
+
+			// Drop the consumed prefix and stale heap entries once they dominate
+			if (m_head > 64 && 2 * m_head > m_items.size())
+			{
+				m_items.erase(m_items.begin(), m_items.begin() + m_head);
+				m_base += m_head;
+				m_head = 0;
+			}
+			if (m_byPrice && m_heap.size() > 2 * m_live + 64)
+				rebuildHeap();
+		}
+
+		void rebuildHeap()
+		{
+			m_heap.clear();
+			for (size_t idx = m_head; idx < m_items.size(); idx++)
+			{
+				if (m_items[idx].live)
+					m_heap.push_back(heapItem(key(m_items[idx].entry), m_base + idx));
+			}
+			make_heap(m_heap.begin(), m_heap.end(), greater<heapItem>());
+		}
+
+		bool m_byPrice;				// Maintain the profit price heap (per contract mode)
+		vector<ledgerItem> m_items;		// FIFO order.  Removed line items are marked dead.
+		vector<heapItem> m_heap;		// Min heap of signed profit prices
+		vector<size_t> m_crossed;		// Scratch for popCrossed (sequence numbers)
+		size_t m_head;				// Oldest live line item
+		size_t m_base;				// Sequence number of m_items[0]
+		size_t m_live;				// Open line items
+		int m_netQty;				// Net open position
+	};
+
+	// Per call state.  Every helper receives the context of the call it serves so concurrent
+	// calls never share anything but their read-only inputs.
+	typedef struct ntpContext
+	{
+		double profitTgt;			// Calculated profit target (minTick * numTicks)
+		double numTicks;			// Number of ticks (representing $ multiples) in which to take a profit
+		double minTick;				// What a single tick increment is for a given contract
+		int openAvg;				// Should we manage profit taking on a per contract basis or average the net position (0 = atomic | 1 = average)
+
+		const double *openPtr;			// Pointers for the price columns
+		const double *highPtr;
+		const double *lowPtr;
+		const double *sigInPtr;			// Pointer for the signal array
+		size_t rows;				// Number of observations
+	} ntpContext;
+
+	// Prototypes
+	static openEntry createOpenLedgerEntry(const ntpContext &ctx, int ID, int qty, double price);
+	static profitEntry createProfitLedgerEntry(int ID, int qty, double price);
+	static double getAvgPftPrice(const ntpContext &ctx, const ntpOpenLedger &openLedger);
+	static void shrinkProfitLedger(list<profitEntry> &profitLedger);
+	static void moveProfitLedger(list<profitEntry> &profitLedger, const int ID, int qty, double price);
+	static void checkOpen(const ntpContext &ctx, ntpOpenLedger &openLedger, list<profitEntry> &profitLedger, const int ID, int &openPosition);
+	static void newAvgChk(const ntpContext &ctx, ntpOpenLedger &openLedger, list<profitEntry> &profitLedger, const int ID, int &openPosition, double &minMax);
+	static void newMinMax(const ntpContext &ctx, ntpOpenLedger &openLedger, list<profitEntry> &profitLedger, const int ID, int &openPosition, double &minMax);
+	static void checkMinMax(const ntpContext &ctx, ntpOpenLedger &openLedger, list<profitEntry> &profitLedger, const int ID, int &openPosition, double &minMax);
+	static void chkOpenMethod(const ntpContext &ctx, int &openPosition, const int curBar, double &minMax, ntpOpenLedger &openLedger, list<profitEntry> &profitLedger);
+	static void sameBarProfitCheck(const ntpContext &ctx, ntpOpenLedger &openLedger, list<profitEntry> &profitLedger, const int ID, int qty, int &openPosition, double &minMax);
+
+	// Validate the inputs and build the context of a call
+	static ntpContext makeContext(const ohlcSeries &bars, span<const double> sig, double minTickIn, double numTicksIn, int openAvgIn)
+	{
+		if (bars.size() != sig.size() || bars.high.size() != sig.size() ||
+			bars.low.size() != sig.size() || bars.close.size() != sig.size())
+			throw btError("MATLAB:numTicksProfit:ArrayMismatch",
+			"The number of rows in the price array and the signal array are different. Aborting.");
+
+		// Final check of inputs
+		if ((openAvgIn != 0) && (openAvgIn != 1))
+			throw btError("MATLAB:numTicksProfit:ProfitTargetCalc",
+			"Input 'openAvg' must be either 0 - atomic price | 1 - average price. Aborting.");
+
+		if (minTickIn < 0)
+			throw btError("MATLAB:numTicksProfit:minTickError",
+			"Input 'minTick' must be greater than or equal to zero. Aborting.");
+
+		ntpContext ctx;
+
+		/* Assign pointers to the input arrays */
+		ctx.openPtr = bars.open.data();
+		ctx.highPtr = bars.high.data();
+		ctx.lowPtr = bars.low.data();
+		ctx.sigInPtr = sig.data();
+		ctx.rows = sig.size();
+
+		/* Assign scalar values */
+		ctx.minTick = minTickIn;
+		ctx.numTicks = numTicksIn;
+		ctx.openAvg = openAvgIn;
+
+		ctx.profitTgt = (ctx.minTick * ctx.numTicks);
+
+		return ctx;
+	}
+
+	// Index of the first signal that trades, or -1 when nothing can be filled or profit taking is disabled
+	static int firstTrade(const ntpContext &ctx)
+	{
+		const int rows = int(ctx.rows);
+
+		// Check that we have at least one signal (at least one trade)
+		int sigIndex;
+		for (sigIndex = 0; sigIndex < rows; sigIndex++)
+		{
+			if (isTrade(ctx.sigInPtr[sigIndex]))
+				break;
+		}
+
+		// A trade on the last observation cannot be filled so it is treated as no trade.
+		if (sigIndex >= rows - 1 || ctx.minTick == 0)
+			return -1;
+
+		return sigIndex;
+	}
+
+	// Scan state of one profit target.  Targets of a multi-target scan share everything in 'ctx'
+	// except 'numTicks' and 'profitTgt'.
+	typedef struct ntpTarget
+	{
+		ntpContext ctx;
+		ntpOpenLedger openLedger;		// Open positions
+		list<profitEntry> profitLedger;		// Profits taken on the current observation
+		int openPosition;
+		double minMax;				// Current minimum | maximum to optimize (minimize) checks
+	} ntpTarget;
+
+	static ntpTarget makeTarget(const ntpContext &ctx, double numTicks)
+	{
+		ntpTarget tgt;
+		tgt.ctx = ctx;
+		tgt.ctx.numTicks = numTicks;
+		tgt.openLedger = ntpOpenLedger(ctx.openAvg == 0);
+		tgt.ctx.profitTgt = ctx.minTick * numTicks;
+		tgt.openPosition = 0;
+		tgt.minMax = 0;
+		return tgt;
+	}
+
+	// The first trade 'sigIndex'
+	static void ntpFirstBar(ntpTarget &tgt, int sigIndex)
+	{
+		const ntpContext &ctx = tgt.ctx;
+		ntpOpenLedger &openLedger = tgt.openLedger;
+		list<profitEntry> &profitLedger = tgt.profitLedger;
+		int &openPosition = tgt.openPosition;
+		double &minMax = tgt.minMax;
+
+		/////////////
+		//
+		// FIRST SIGNAL PROCESSING
+		//
+		/////////////
+
+		// Put first detected trade on openLedger
+		openLedger.push_back(createOpenLedgerEntry(ctx, sigIndex, int(ctx.sigInPtr[sigIndex]), ctx.openPtr[sigIndex + 1]));
+
+		// Short signal.  Assign minMax to LOW
+		if (ctx.sigInPtr[sigIndex] < 0)
+		{
+			minMax = ctx.lowPtr[sigIndex + 1];
+		}
+		// Long signal. Assign minMax to HIGH
+		else if (ctx.sigInPtr[sigIndex] > 0)
+		{
+			minMax = ctx.highPtr[sigIndex + 1];
+		}
+
+		// Check for profit on same observation
+		// 'minMax' has been updated so we can safely call 'sameBarProfitCheck'
+		sameBarProfitCheck(ctx, openLedger, profitLedger, sigIndex, int(ctx.sigInPtr[sigIndex]), openPosition, minMax);
+
+		// FIRST BAR END
+	}
+
+	// Any observation after the first trade
+	static void ntpNextBar(ntpTarget &tgt, int curBar)
+	{
+		const ntpContext &ctx = tgt.ctx;
+		ntpOpenLedger &openLedger = tgt.openLedger;
+		list<profitEntry> &profitLedger = tgt.profitLedger;
+		int &openPosition = tgt.openPosition;
+		double &minMax = tgt.minMax;
+
+		// ORDER OF SIGNIFICANCE from a signal with an existing position
+		// REVERSE
+		if (fraction(ctx.sigInPtr[curBar]))
+		{
+			// Is fraction the same sign (additive in nature) ?
+			// Additive
+			if (sign(ctx.sigInPtr[curBar]) == sign(openPosition))
+			{
+				// Nothing to do with the current logic
+				// The only fraction currently in use is |0.5| to liquidate entire opposing openPosition
+			}
+			// Reductive (liquidate)
+			else
+			{
+				// Adding logic here for prevention of 'other' fractions or surprising inputs
+				if (knownAdvSig(ctx.sigInPtr[curBar]))
+				{
+					// Liquidate any open position
+					openLedger.clear();
+					openPosition = 0;
+				}
+				// Unknown advanced instruction
+				else
+				{
+					throw btError("MATLAB:AdvancedSignal:fractionUnknown",
+						"A signal contained an advanced fractional instruction that we could not interpret. Aborting.");
+				}
+			}
+		}
+
+		// REDUCE or ADD
+		// Do we have a signal with an integer portion ?
+		if (abs(int(ctx.sigInPtr[curBar])) >= 1)
+		{
+			// Signal is reductive
+			if ((int(ctx.sigInPtr[curBar]) > 0 && openPosition < 0) || (int(ctx.sigInPtr[curBar]) < 0 && openPosition > 0))
+			{
+				// Signal is effectively a reverse or liquidate
+				if (abs(int(ctx.sigInPtr[curBar])) >= abs(openPosition))
+				{
+					openPosition = int(ctx.sigInPtr[curBar]) + openPosition;
+					openLedger.clear();
+					if (openPosition != 0)
+					{
+						openLedger.push_back(createOpenLedgerEntry(ctx, curBar, openPosition, ctx.openPtr[curBar + 1]));
+					}
+				}
+				else
+				{
+					// How many do we need to reduce by?  (opposite sign to the open position)
+					int needQty = int(ctx.sigInPtr[curBar]);
+					// Prepare to iterate until we are satisfied
+					while (needQty != 0)
+					{
+						// Is the current line item quantity larger than what we need?
+						if (abs(openLedger.front().qtyOpen) > abs(needQty))
+						{
+							// Reduce the position size.  We are aggregating so we add (e.g. 5 Purchases + 4 Sales = 1 Long)
+							openLedger.reduceFront(needQty);
+							// We are satisfied and don't need any more contracts
+							needQty = 0;
+						}
+						// Current line item quantity is equal to or smaller than what we need.  Process P&L and remove.
+						else
+						{
+							// Reduce needed quantity by what we've been provided
+							needQty = needQty + openLedger.front().qtyOpen;
+							// Remove the line item (FIFO)
+							openLedger.pop_front();
+						}
+					}
+					openPosition = openPosition + int(ctx.sigInPtr[curBar]);
+				}
+			}
+			// Signal is additive
+			else
+			{
+				// Before adding, check if the open qualifies to liquidate any existing position
+				if (openPosition != 0)
+				{
+					chkOpenMethod(ctx, openPosition, curBar, minMax, openLedger, profitLedger);
+				}
+
+				// A new position from flat starts tracking extremes from its entry observation
+				if (openPosition == 0)
+				{
+					minMax = (ctx.sigInPtr[curBar] < 0) ? ctx.lowPtr[curBar + 1] : ctx.highPtr[curBar + 1];
+				}
+
+				// Process addition
+				// Put trade on openLedger
+				openLedger.push_back(createOpenLedgerEntry(ctx, curBar, int(ctx.sigInPtr[curBar]), ctx.openPtr[curBar + 1]));
+				sameBarProfitCheck(ctx, openLedger, profitLedger, curBar, int(ctx.sigInPtr[curBar]), openPosition, minMax);
+			}
+		}
+		// NONE
+		else
+		{
+			// We can just check against the open and leave the range check for all entries on the openLedger below
+			// Only check if necessary
+			if (openPosition != 0)
+			{
+				chkOpenMethod(ctx, openPosition, curBar, minMax, openLedger, profitLedger);
+			}
+		}
+
+		// Check for extremes that result in a profit for any openPosition
+		if (openPosition != 0)
+		{
+			checkMinMax(ctx, openLedger, profitLedger, curBar, openPosition, minMax);
+		}
+	}
+
+	// ntpScan over several profit targets in one pass over the observations.  Each observation is
+	// stepped for every target before moving on and 'onBar(target, curBar, profits)' receives the
+	// profits of each.
+	template <typename OnBar>
+	static void ntpScanTargets(vector<ntpTarget> &targets, int sigIndex, OnBar &&onBar)
+	{
+		const int rows = targets.empty() ? 0 : int(targets[0].ctx.rows);
+
+		for (int curBar = sigIndex; curBar < rows - 1; curBar++)
+		{
+			for (size_t tt = 0; tt < targets.size(); tt++)
+			{
+				ntpTarget &tgt = targets[tt];
+				if (curBar == sigIndex)
+					ntpFirstBar(tgt, curBar);
+				else
+					ntpNextBar(tgt, curBar);
+
+				shrinkProfitLedger(tgt.profitLedger);
+				onBar(tt, curBar, tgt.profitLedger);
+				tgt.profitLedger.clear();
+			}
+		}
+	}
+
+	// The profit taking scan from the first trade 'sigIndex' to the observation before last.
+	// After each scanned observation 'curBar', 'onBar(curBar, profits)' receives the profits taken
+	// on it (adjacent profits in the same direction already combined).  Every profit of 'curBar'
+	// prices observation 'curBar + 1'.
+	template <typename OnBar>
+	static void ntpScan(const ntpContext &ctx, int sigIndex, OnBar &&onBar)
+	{
+		vector<ntpTarget> targets(1, makeTarget(ctx, ctx.numTicks));
+		ntpScanTargets(targets, sigIndex, [&onBar](size_t, int curBar, list<profitEntry> &profits)
+		{
+			onBar(curBar, profits);
+		});
+	}
+
+	// The single contract reverse case.  Every signal from the first trade on is 0 or +/-1.5 and
+	// consecutive signals alternate in direction, so the position is always -1, 0 or +1 and each
+	// entry has a single objective.  'entries' receives the signal indices.
+	static bool singleLotReverse(const ntpContext &ctx, int sigIndex, vector<int> &entries)
+	{
+		const int rows = int(ctx.rows);
+		double lastSig = 0;
+
+		entries.clear();
+		for (int ii = sigIndex; ii < rows - 1; ii++)
+		{
+			const double curSig = ctx.sigInPtr[ii];
+			if (curSig == 0)
+				continue;
+			if ((curSig != 1.5 && curSig != -1.5) || curSig == lastSig)
+				return false;
+
+			entries.push_back(ii);
+			lastSig = curSig;
+		}
+
+		return true;
+	}
+
+	// ntpScan of a single contract reverse series (see singleLotReverse) for the objective
+	// 'profitTgt'.  There is at most one profit per entry so instead of stepping every observation
+	// the observation that takes it is searched for directly with firstCross.  The output is
+	// identical to ntpScan.
+	static void ntpReverseScan(const ntpContext &ctx, const vector<int> &entries, double profitTgt, vector<ntpProfit> &profits)
+	{
+		const int rows = int(ctx.rows);
+
+		for (size_t ee = 0; ee < entries.size(); ee++)
+		{
+			const int sigBar = entries[ee];
+			const size_t entryBar = size_t(sigBar) + 1;
+			const bool isLong = ctx.sigInPtr[sigBar] > 0;
+			const double *extreme = isLong ? ctx.highPtr : ctx.lowPtr;
+			const double profitPrice = isLong ? ctx.openPtr[entryBar] + profitTgt : ctx.openPtr[entryBar] - profitTgt;
+
+			ntpProfit profit;
+			profit.qtyProfit = isLong ? -1 : 1;
+			profit.profitPrice = profitPrice;
+
+			// Profit on the entry observation.  Per contract objectives need the extreme beyond the
+			// objective, the average price method only needs it reached.
+			const double entryExtreme = extreme[entryBar];
+			const bool sameBar = (ctx.openAvg == 0) ?
+				(isLong ? entryExtreme > profitPrice : entryExtreme < profitPrice) :
+				(isLong ? entryExtreme >= profitPrice : entryExtreme <= profitPrice);
+			if (sameBar)
+			{
+				profit.barIndex = sigBar;
+				profits.push_back(profit);
+				continue;
+			}
+
+			// The position is held until the fill of the next entry.  An extreme equal to the
+			// objective on the entry observation is the starting extreme so only prices beyond it
+			// take the profit afterwards.
+			const size_t lastBar = (ee + 1 < entries.size()) ? size_t(entries[ee + 1]) : size_t(rows - 1);
+			const bool strict = (entryExtreme == profitPrice);
+			const size_t hit = firstCross(ctx.openPtr, extreme, entryBar + 1, lastBar + 1, profitPrice, isLong, strict);
+			if (hit > lastBar)
+				continue;
+
+			// A gap through the objective fills at the Open
+			const double hitOpen = ctx.openPtr[hit];
+			const bool atOpen = isLong ? (strict ? hitOpen > profitPrice : hitOpen >= profitPrice) :
+				(strict ? hitOpen < profitPrice : hitOpen <= profitPrice);
+
+			profit.barIndex = int(hit) - 1;
+			if (atOpen)
+				profit.profitPrice = hitOpen;
+			profits.push_back(profit);
+		}
+	}
+
+	vector<ntpProfit> numTicksProfitScan(const ohlcSeries &bars, span<const double> sig, double minTickIn, double numTicksIn, int openAvgIn)
+	{
+		// All state for this call lives in 'ctx' and the local ledgers so calls are reentrant
+		ntpContext ctx = makeContext(bars, sig, minTickIn, numTicksIn, openAvgIn);
+
+		vector<ntpProfit> profits;
+
+		// START //
+		// If there are no trades or the minTick is zero indicating no profit taking then return the original input.
+		int sigIndex = firstTrade(ctx);
+		if (sigIndex < 0)
+			return profits;
+
+		// Single contract reversals take the fast path
+		vector<int> entries;
+		if (singleLotReverse(ctx, sigIndex, entries))
+		{
+			ntpReverseScan(ctx, entries, ctx.profitTgt, profits);
+			return profits;
+		}
+
+		// Profits in observation order
+		ntpScan(ctx, sigIndex, [&profits](int, list<profitEntry> &barProfits)
+		{
+			profits.insert(profits.end(), barProfits.begin(), barProfits.end());
+		});
+
+		return profits;
+	}
+
+	/////////////
+	//
+	// OUTPUT PROCESSING
+	//
+	/////////////
+	void numTicksProfitMerge(const ohlcSeries &bars, span<const double> sig, const vector<ntpProfit> &profits,
+		span<double> barsOut, span<double> sigOut, span<size_t> barIndex)
+	{
+		const size_t rows = sig.size();
+		const size_t rowsOut = rows + profits.size();
+
+		if (bars.size() != rows || bars.high.size() != rows || bars.low.size() != rows || bars.close.size() != rows)
+			throw btError("MATLAB:numTicksProfit:ArrayMismatch",
+			"The number of rows in the price array and the signal array are different. Aborting.");
+
+		if (barsOut.size() != 4 * rowsOut || sigOut.size() != rowsOut || (!barIndex.empty() && barIndex.size() != rowsOut))
+			throw btError("MATLAB:numTicksProfit:ArrayMismatch",
+			"The output arrays must hold the input observations and every virtual bar. Aborting.");
+
+		double *openOut = barsOut.data();
+		double *highOut = openOut + rowsOut;
+		double *lowOut = highOut + rowsOut;
+		double *closeOut = lowOut + rowsOut;
+
+		// Signals.  A profit taken on observation 'b' follows input signal 'b'.
+		size_t pp = 0;
+		size_t row = 0;
+		for (size_t ii = 0; ii < rows; ii++)
+		{
+			sigOut[row++] = sig[ii];
+			while (pp < profits.size() && size_t(profits[pp].barIndex) == ii)
+				sigOut[row++] = profits[pp++].qtyProfit;
+		}
+
+		// Bars.  Its virtual bar follows input bar 'b + 1' and belongs to that observation.
+		pp = 0;
+		row = 0;
+		for (size_t ii = 0; ii < rows; ii++)
+		{
+			openOut[row] = bars.open[ii];
+			highOut[row] = bars.high[ii];
+			lowOut[row] = bars.low[ii];
+			closeOut[row] = bars.close[ii];
+			if (!barIndex.empty())
+				barIndex[row] = ii;
+			row++;
+
+			while (pp < profits.size() && size_t(profits[pp].barIndex) + 1 == ii)
+			{
+				const double price = profits[pp++].profitPrice;
+				openOut[row] = price;
+				highOut[row] = price;
+				lowOut[row] = price;
+				closeOut[row] = price;
+				if (!barIndex.empty())
+					barIndex[row] = ii;
+				row++;
+			}
+		}
+	}
+
+	// numTicksProfit output of one scan result
+	static ntpResult mergeResult(const ohlcSeries &bars, span<const double> sig, const vector<ntpProfit> &profits)
+	{
+		ntpResult result;
+		result.modified = !profits.empty();
+		result.rows = sig.size() + profits.size();
+		if (!result.modified)
+			return result;
+
+		result.bars.resize(4 * result.rows);
+		result.sig.resize(result.rows);
+		result.barIndex.resize(result.rows);
+		numTicksProfitMerge(bars, sig, profits, result.bars, result.sig, result.barIndex);
+
+		return result;
+	}
+
+	ntpResult numTicksProfit(const ohlcSeries &bars, span<const double> sig, double minTickIn, double numTicksIn, int openAvgIn)
+	{
+		return mergeResult(bars, sig, numTicksProfitScan(bars, sig, minTickIn, numTicksIn, openAvgIn));
+	}
+
+	vector<ntpResult> numTicksProfitTargets(const ohlcSeries &bars, span<const double> sig, double minTickIn,
+		span<const double> numTicksIn, int openAvgIn)
+	{
+		ntpContext ctx = makeContext(bars, sig, minTickIn, 0, openAvgIn);
+
+		vector<vector<ntpProfit> > profits(numTicksIn.size());
+		int sigIndex = firstTrade(ctx);
+		vector<int> entries;
+		if (sigIndex >= 0 && singleLotReverse(ctx, sigIndex, entries))
+		{
+			for (size_t tt = 0; tt < numTicksIn.size(); tt++)
+				ntpReverseScan(ctx, entries, ctx.minTick * numTicksIn[tt], profits[tt]);
+		}
+		else if (sigIndex >= 0)
+		{
+			vector<ntpTarget> targets;
+			targets.reserve(numTicksIn.size());
+			for (size_t tt = 0; tt < numTicksIn.size(); tt++)
+				targets.push_back(makeTarget(ctx, numTicksIn[tt]));
+
+			ntpScanTargets(targets, sigIndex, [&profits](size_t tt, int, list<profitEntry> &barProfits)
+			{
+				profits[tt].insert(profits[tt].end(), barProfits.begin(), barProfits.end());
+			});
+		}
+
+		vector<ntpResult> results;
+		results.reserve(numTicksIn.size());
+		for (size_t tt = 0; tt < numTicksIn.size(); tt++)
+			results.push_back(mergeResult(bars, sig, profits[tt]));
+
+		return results;
+	}
+
+	// Rows of the numTicksProfit output built on the fly.  A profit taken on observation 'b' places
+	// its signal after input signal 'b' and its virtual bar after input bar 'b + 1', so the signal
+	// and bar columns are merged separately and paired as both become available.  Each pair is
+	// pushed through the streaming ledger and released rows are folded onto input observations.
+	class ntpPlMerge
+	{
+	public:
+		ntpPlMerge(double bigPoint, double cost, const ntpPlOutputs &out)
+			: m_stream(bigPoint, cost), m_out(out), m_prevOrigin(0), m_virtual(0) {}
+
+		void signal(double sig)
+		{
+			m_sigs.push_back(sig);
+			drain();
+		}
+
+		void bar(double open, double high, double low, double close, size_t origin, bool isVirtual)
+		{
+			mergedBar mb = { open, high, low, close, origin };
+			m_bars.push_back(mb);
+			if (isVirtual)
+				m_virtual++;
+			drain();
+		}
+
+		plStats finish()
+		{
+			plBar last;
+			if (m_stream.current(last))
+				consume(last, m_prevOrigin);
+
+			if (!m_out.bars.netLiq.empty())
+			{
+				const span<double> &netLiq = m_out.bars.netLiq;
+				for (size_t rr = 0; rr < netLiq.size(); rr++)
+					m_out.bars.returns[rr] = (rr > 0) ? netLiq[rr] - netLiq[rr - 1] : 0;
+			}
+
+			if (m_out.virtualBars != NULL && m_virtual > 0)
+			{
+				ntpResult &res = *m_out.virtualBars;
+				res.modified = true;
+				res.rows = m_sig.size();
+				res.bars.clear();
+				res.bars.reserve(4 * res.rows);
+				res.bars.insert(res.bars.end(), m_open.begin(), m_open.end());
+				res.bars.insert(res.bars.end(), m_high.begin(), m_high.end());
+				res.bars.insert(res.bars.end(), m_low.begin(), m_low.end());
+				res.bars.insert(res.bars.end(), m_close.begin(), m_close.end());
+				res.sig.swap(m_sig);
+				res.barIndex.swap(m_barIndex);
+			}
+
+			return m_accum.finish();
+		}
+
+	private:
+		struct mergedBar
+		{
+			double open, high, low, close;
+			size_t origin;			// Input observation the row belongs to
+		};
+
+		void drain()
+		{
+			while (!m_bars.empty() && !m_sigs.empty())
+			{
+				const mergedBar &mb = m_bars.front();
+				const double sig = m_sigs.front();
+
+				plBar released;
+				if (m_stream.push(mb.open, mb.close, sig, released, [this](double pnl) { m_accum.trade(pnl); }))
+					consume(released, m_prevOrigin);
+				m_prevOrigin = mb.origin;
+
+				if (m_out.virtualBars != NULL)
+				{
+					m_open.push_back(mb.open);
+					m_high.push_back(mb.high);
+					m_low.push_back(mb.low);
+					m_close.push_back(mb.close);
+					m_sig.push_back(sig);
+					m_barIndex.push_back(mb.origin);
+				}
+
+				m_bars.pop_front();
+				m_sigs.pop_front();
+			}
+		}
+
+		// Rows arrive in time order so the last row of an observation holds its end of observation values
+		void consume(const plBar &row, size_t origin)
+		{
+			m_accum.bar(row.netLiq, row.returns);
+
+			if (!m_out.bars.netLiq.empty())
+			{
+				m_out.bars.cash[origin] += row.cash;
+				m_out.bars.openEQ[origin] = row.openEQ;
+				m_out.bars.netLiq[origin] = row.netLiq;
+			}
+		}
+
+		plStream m_stream;
+		plStatsAccumulator m_accum;
+		const ntpPlOutputs &m_out;
+
+		deque<mergedBar> m_bars;
+		deque<double> m_sigs;
+		size_t m_prevOrigin;			// Origin of the newest pushed row
+		size_t m_virtual;			// Virtual bars merged
+
+		// Materialized output (only with 'virtualBars')
+		vector<double> m_open, m_high, m_low, m_close, m_sig;
+		vector<size_t> m_barIndex;
+	};
+
+	// Feeds the merged rows of every target in 'targets' to the matching element of 'merges'
+	// while scanning the observations once
+	static void ntpPlDrive(const ohlcSeries &bars, span<const double> sig, const ntpContext &ctx,
+		vector<ntpTarget> &targets, vector<ntpPlMerge> &merges)
+	{
+		const int rows = int(sig.size());
+		if (rows == 0)
+			return;
+
+		// Input bar 'rr + 1' follows input signal 'rr'
+		auto inputBar = [&](ntpPlMerge &merge, int rr)
+		{
+			merge.bar(ctx.openPtr[rr], ctx.highPtr[rr], ctx.lowPtr[rr], bars.close[rr], size_t(rr), false);
+		};
+
+		for (size_t tt = 0; tt < merges.size(); tt++)
+			inputBar(merges[tt], 0);
+
+		int sigIndex = firstTrade(ctx);
+		const int scanFrom = (sigIndex < 0) ? rows - 1 : sigIndex;
+
+		// Nothing is taken before the first trade
+		for (int rr = 0; rr < scanFrom; rr++)
+		{
+			for (size_t tt = 0; tt < merges.size(); tt++)
+			{
+				merges[tt].signal(sig[rr]);
+				inputBar(merges[tt], rr + 1);
+			}
+		}
+
+		if (sigIndex >= 0)
+		{
+			ntpScanTargets(targets, sigIndex, [&](size_t tt, int curBar, list<profitEntry> &profits)
+			{
+				ntpPlMerge &merge = merges[tt];
+
+				merge.signal(sig[curBar]);
+				for (list<profitEntry>::const_iterator iter = profits.begin(); iter != profits.end(); ++iter)
+					merge.signal(iter->qtyProfit);
+
+				inputBar(merge, curBar + 1);
+				for (list<profitEntry>::const_iterator iter = profits.begin(); iter != profits.end(); ++iter)
+					merge.bar(iter->profitPrice, iter->profitPrice, iter->profitPrice, iter->profitPrice, size_t(curBar + 1), true);
+			});
+		}
+
+		for (size_t tt = 0; tt < merges.size(); tt++)
+			merges[tt].signal(sig[rows - 1]);
+	}
+
+	plStats numTicksProfitPL(const ohlcSeries &bars, span<const double> sig, double minTickIn, double numTicksIn, int openAvgIn,
+		double bigPoint, double cost, const ntpPlOutputs &out)
+	{
+		ntpContext ctx = makeContext(bars, sig, minTickIn, numTicksIn, openAvgIn);
+
+		const plOutputs &perBar = out.bars;
+		if (!(perBar.cash.empty() && perBar.openEQ.empty() && perBar.netLiq.empty() && perBar.returns.empty()) &&
+			(perBar.cash.size() != sig.size() || perBar.openEQ.size() != sig.size() ||
+			perBar.netLiq.size() != sig.size() || perBar.returns.size() != sig.size()))
+			throw btError("MATLAB:numTicksProfit:ArrayMismatch",
+			"The output arrays must be the same length as the signal array. Aborting.");
+
+		for (size_t rr = 0; rr < perBar.cash.size(); rr++)
+			perBar.cash[rr] = 0;
+
+		if (out.virtualBars != NULL)
+		{
+			*out.virtualBars = ntpResult();
+			out.virtualBars->modified = false;
+			out.virtualBars->rows = sig.size();
+		}
+
+		vector<ntpTarget> targets(1, makeTarget(ctx, ctx.numTicks));
+		vector<ntpPlMerge> merges(1, ntpPlMerge(bigPoint, cost, out));
+		ntpPlDrive(bars, sig, ctx, targets, merges);
+
+		return merges[0].finish();
+	}
+
+	vector<plStats> numTicksProfitPLTargets(const ohlcSeries &bars, span<const double> sig, double minTickIn,
+		span<const double> numTicksIn, int openAvgIn, double bigPoint, double cost)
+	{
+		ntpContext ctx = makeContext(bars, sig, minTickIn, 0, openAvgIn);
+
+		const ntpPlOutputs statsOnly;
+		vector<ntpTarget> targets;
+		vector<ntpPlMerge> merges;
+		targets.reserve(numTicksIn.size());
+		merges.reserve(numTicksIn.size());
+		for (size_t tt = 0; tt < numTicksIn.size(); tt++)
+		{
+			targets.push_back(makeTarget(ctx, numTicksIn[tt]));
+			merges.push_back(ntpPlMerge(bigPoint, cost, statsOnly));
+		}
+
+		ntpPlDrive(bars, sig, ctx, targets, merges);
+
+		vector<plStats> stats;
+		stats.reserve(merges.size());
+		for (size_t tt = 0; tt < merges.size(); tt++)
+			stats.push_back(merges[tt].finish());
+
+		return stats;
+	}
+
+	/////////////
+	//
+	// FUNCTIONS & METHODS
+	//
+	/////////////
+
+	// Constructor for ledger line item creation
+	static openEntry createOpenLedgerEntry(const ntpContext &ctx, int ID, int qty, double price)
+	{
+		openEntry OpenLedgerEntry;
+		OpenLedgerEntry.sigIndex = ID;
+		OpenLedgerEntry.qtyOpen = qty;
+		OpenLedgerEntry.openPrice = price;
+		if (qty < 0)
+		{
+			OpenLedgerEntry.profitPrice = price - (ctx.minTick * ctx.numTicks);
+		}
+		else
+		{
+			OpenLedgerEntry.profitPrice = price + (ctx.minTick * ctx.numTicks);
+		}
+
+		return OpenLedgerEntry;
+	}
+
+	static profitEntry createProfitLedgerEntry(int ID, int qty, double price)
+	{
+		profitEntry ProfitLedgerEntry;
+		ProfitLedgerEntry.barIndex = ID;
+		ProfitLedgerEntry.qtyProfit = qty;					// Quantity already transformed at calling function
+		ProfitLedgerEntry.profitPrice = price;
+
+		return ProfitLedgerEntry;
+	}
+
+	static void moveProfitLedger(list<profitEntry> &profitLedger, const int ID, int qty, double price)
+	{
+		// We take the price of the next observation for the generated signal
+		// We reverse the quantity to reflect closing of the positions
+		profitLedger.push_back(createProfitLedgerEntry(ID, qty * -1, price));
+	}
+
+	static void sameBarProfitCheck(const ntpContext &ctx, ntpOpenLedger &openLedger, list<profitEntry> &profitLedger, const int ID, int qty, int &openPosition, double &minMax)
+	{
+		if (ctx.openAvg == 0)
+		{
+			// Is there a profit on the bar of the trade?
+			// Short signal - check LOW
+			if ((qty < 0) && (ctx.lowPtr[ID + 1] < ctx.openPtr[ID + 1] - ctx.profitTgt))
+			{
+				// We have a profit on the same observation.  Move the entry in the profit ledger
+				// The position never changes as the entry is closed on the observation it was opened
+				moveProfitLedger(profitLedger, ID, qty, ctx.openPtr[ID + 1] - ctx.profitTgt);
+				openLedger.pop_back();
+			}
+			// Long signal - check HIGH
+			else if ((qty > 0) && (ctx.highPtr[ID + 1] > ctx.openPtr[ID + 1] + ctx.profitTgt))
+			{
+				// We have a profit on the same observation.  Put entry in the profit ledger
+				moveProfitLedger(profitLedger, ID, qty, ctx.openPtr[ID + 1] + ctx.profitTgt);
+				openLedger.pop_back();
+			}
+			else
+			{
+				openPosition = openPosition + qty;
+			}
+		}
+		else
+		{
+			// Check same bar using new average
+			// Requires minMax already updated !!
+			openPosition = openPosition + qty;
+			newAvgChk(ctx, openLedger, profitLedger, ID, openPosition, minMax);
+		}
+	}
+
+	// A new High | Low has occurred and we have determined that we have an openPosition
+	// Check if profit targets have been reached
+	static void newMinMax(const ntpContext &ctx, ntpOpenLedger &openLedger, list<profitEntry> &profitLedger, const int ID, int &openPosition, double &minMax)
+	{
+		if (openLedger.empty())
+			return;
+
+		if (ctx.openAvg == 0)
+		{
+			// Only the line items whose objective the new extreme reached are visited
+			openLedger.popCrossed(minMax, [&](const openEntry &lot)
+			{
+				moveProfitLedger(profitLedger, ID, lot.qtyOpen, lot.profitPrice);
+			});
+
+			// Update openPosition
+			openPosition = openLedger.netQty();
+		}
+		// Using the average price approach
+		else
+		{
+			newAvgChk(ctx, openLedger, profitLedger, ID, openPosition, minMax);
+		}
+	}
+
+	static void newAvgChk(const ntpContext &ctx, ntpOpenLedger &openLedger, list<profitEntry> &profitLedger, const int ID, int &openPosition, double &minMax)
+	{
+		if (openLedger.empty())
+			return;
+
+		double profitPrice = getAvgPftPrice(ctx, openLedger);
+
+		// Short. Check minMax <= profitPrice
+		// Long. Check minMax >= profitPrice
+		if ((openPosition < 0 && minMax <= profitPrice) || (openPosition > 0 && minMax >= profitPrice))
+		{
+			while (!openLedger.empty())
+			{
+				moveProfitLedger(profitLedger, ID, openLedger.front().qtyOpen, profitPrice);
+				openLedger.pop_front();
+			}
+			openPosition = 0;
+		}
+	}
+
+	static double getAvgPftPrice(const ntpContext &ctx, const ntpOpenLedger &openLedger)
+	{
+		int netQty = 0;
+		double sumWghts = 0;
+		double wghtAvg = 0;
+		double profitPrice = 0;
+
+		openLedger.forEach([&](const openEntry &lot)
+		{
+			netQty = netQty + lot.qtyOpen;
+			sumWghts = sumWghts + (abs(lot.qtyOpen) * lot.openPrice);
+		});
+
+		wghtAvg = sumWghts / abs(netQty);
+
+		// Short objective
+		if (netQty < 0)
+		{
+			profitPrice = wghtAvg - ctx.profitTgt;
+		}
+		// Long objective
+		else
+		{
+			profitPrice = wghtAvg + ctx.profitTgt;
+		}
+
+		return profitPrice;
+	}
+
+	static void checkOpen(const ntpContext &ctx, ntpOpenLedger &openLedger, list<profitEntry> &profitLedger, const int ID, int &openPosition)
+	{
+		const double barOpen = ctx.openPtr[ID + 1];
+
+		if (ctx.openAvg == 0)
+		{
+			// Open satisfies profit threshold
+			openLedger.popCrossed(barOpen, [&](const openEntry &lot)
+			{
+				moveProfitLedger(profitLedger, ID, lot.qtyOpen, barOpen);
+			});
+
+			// Update openPosition
+			openPosition = openLedger.netQty();
+		}
+		else
+		{
+			if (openLedger.empty())
+				return;
+
+			double profitPrice = getAvgPftPrice(ctx, openLedger);
+
+			if ((openPosition < 0 && barOpen <= profitPrice) || (openPosition > 0 && barOpen >= profitPrice))
+			{
+				// Open satisfies profit threshold
+				while (!openLedger.empty())
+				{
+					moveProfitLedger(profitLedger, ID, openLedger.front().qtyOpen, barOpen);
+					openLedger.pop_front();
+				}
+				openPosition = 0;
+			}
+		}
+	}
+
+	static void checkMinMax(const ntpContext &ctx, ntpOpenLedger &openLedger, list<profitEntry> &profitLedger, const int ID, int &openPosition, double &minMax)
+	{
+		if (openPosition < 0)						// Short.  Check minMax to LOW
+		{
+			if (ctx.lowPtr[ID + 1] < minMax)				// New minMax
+			{
+				minMax = ctx.lowPtr[ID + 1];
+				newMinMax(ctx, openLedger, profitLedger, ID, openPosition, minMax);
+			}
+		}
+		else if (openPosition > 0)					// Long.  Check minMax to HIGH
+		{
+			if (ctx.highPtr[ID + 1] > minMax)				// New minMax
+			{
+				minMax = ctx.highPtr[ID + 1];
+				newMinMax(ctx, openLedger, profitLedger, ID, openPosition, minMax);
+			}
+		}
+	}
+
+	// Combine adjacent profits taken on the same observation in the same direction
+	static void shrinkProfitLedger(list<profitEntry> &profitLedger)
+	{
+		if (profitLedger.empty())
+			return;
+
+		list<profitEntry>::iterator iterMain = profitLedger.begin();
+		list<profitEntry>::iterator iterPlusOne = next(iterMain);	// Look ahead iterator is always iterMain+1
+
+		while (iterPlusOne != profitLedger.end())
+		{
+			if ((iterMain->barIndex == iterPlusOne->barIndex) &&
+				(sign(iterMain->qtyProfit) == sign(iterPlusOne->qtyProfit)))
+			{
+				iterPlusOne->qtyProfit = iterPlusOne->qtyProfit + iterMain->qtyProfit;
+				profitLedger.erase(iterMain);
+			}
+			iterMain = iterPlusOne;
+			++iterPlusOne;
+		}
+	}
+
+	static void chkOpenMethod(const ntpContext &ctx, int &openPosition, const int curBar, double &minMax, ntpOpenLedger &openLedger, list<profitEntry> &profitLedger)
+	{
+		if (openPosition < 0)
+		{
+			// We can add a check to reduce calls to the function unless necessary
+			if (ctx.openPtr[curBar + 1] < minMax)
+			{
+				checkOpen(ctx, openLedger, profitLedger, curBar, openPosition);
+				minMax = ctx.openPtr[curBar + 1];
+			}
+		}
+		else if (openPosition > 0)
+		{
+			if (ctx.openPtr[curBar + 1] > minMax)
+			{
+				checkOpen(ctx, openLedger, profitLedger, curBar, openPosition);
+				minMax = ctx.openPtr[curBar + 1];
+			}
+		}
+	}
+}
+
+//
+//  -------------------------------------------------------------------------
+//                                  _    _ 
+//         ___  _ __   ___ _ __    / \  | | __ _  ___   ___  _ __ __ _ 
+//        / _ \| '_ \ / _ \ '_ \  / _ \ | |/ _` |/ _ \ / _ \| '__/ _` |
+//       | (_) | |_) |  __/ | | |/ ___ \| | (_| | (_) | (_) | | | (_| |
+//        \___/| .__/ \___|_| |_/_/   \_\_|\__, |\___(_)___/|_|  \__, |
+//             |_|                         |___/                 |___/
+//  -------------------------------------------------------------------------
+//        This code is distributed in the hope that it will be useful,
+//
+//                         WITHOUT ANY WARRANTY AND
+//
+//                  WITHOUT CLAIM AS TO MERCHANTABILITY
+//
+//                  OR FITNESS FOR A PARTICULAR PURPOSE
+//
+//                           EXPRESSED OR IMPLIED.
+//
+//   Use of this code, pseudocode, algorithmic or trading logic contained
+//   herein, whether sound or faulty for any purpose is the sole
+//   responsibility of the USER. Any such use of these algorithms, coding
+//   logic or concepts in whole or in part carry no covenant of correctness
+//   or recommended usage from the AUTHOR or any of the possible
+//   contributors listed or unlisted, known or unknown.
+//
+//	 Redistribution and use in source and binary forms, with or without
+//	 modification, are permitted provided that the following conditions are met: 
+//
+//	 1. Redistributions of source code must retain the below copyright notice, 
+//	 this list of conditions and the following disclaimer. 
+//	 2. Redistributions in binary form must reproduce the below copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution. 
+//
+//   The public sharing of this code does not relinquish, reduce, restrict or
+//   encumber any rights the AUTHOR has in respect to claims of intellectual
+//   property.
+//
+//   IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY
+//   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+//   OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+//   STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//   ANY WAY OUT OF THE USE OF THIS SOFTWARE, CODE, OR CODE FRAGMENT(S), EVEN
+//   IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//   -------------------------------------------------------------------------
+//
+//                             ALL RIGHTS RESERVED
+//
+//   -------------------------------------------------------------------------
+//
+//   Author:	Mark Tompkins
+//
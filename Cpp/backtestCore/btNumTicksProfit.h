@@ -0,0 +1,100 @@
+// btNumTicksProfit.h
+//
+// MEX-free core of numTicksProfit.
+//
+// Scans a signal array against Open | High | Low | Close prices and records where an open
+// position would reach a profit objective of 'numTicks' x 'minTick'.  Each profit is injected
+// into the output as a virtual bar (O = H = L = C = profit price) with an offsetting signal so
+// the result can be passed directly to calcProfitLoss.
+//
+// NOTES	We will assume the following standard:	+/- 1 lot is additive	+/- 2 lots is a reverse
+//		This is the version that should be used with a SIGNAL input.
+//
+//		Signals that only ever reverse a single contract (0 | +/-1.5 alternating) are detected
+//		and scanned entry to entry with a vectorized search (btCross.h).  The output is identical.
+
+#ifndef BTNUMTICKSPROFIT_H
+#define BTNUMTICKSPROFIT_H
+
+#include "btSpan.h"
+#include "btSeries.h"
+#include "btProfitLoss.h"
+#include <vector>
+
+namespace openAlgo
+{
+	struct ntpResult
+	{
+		bool modified;			// false when no profits were taken.  Inputs should be returned as given.
+		size_t rows;			// Number of observations in 'bars' and 'sig'
+		std::vector<double> bars;	// rows x 4 column major Open | High | Low | Close including virtual bars
+		std::vector<double> sig;	// Signals including any profit taking signals
+		std::vector<size_t> barIndex;	// Input observation each output row belongs to.  A virtual bar maps to the
+						// observation its profit was taken in.  Empty when 'modified' is false.
+	};
+
+	// A profit found by the scan.  Its signal follows input signal 'barIndex' and its virtual bar
+	// follows input bar 'barIndex + 1'.
+	struct ntpProfit
+	{
+		int barIndex;			// Observation the profit was taken in
+		int qtyProfit;			// Offsetting quantity
+		double profitPrice;		// Profit price
+	};
+
+	// Inputs:
+	//		bars		Open | High | Low | Close price columns
+	//		sig		Quantity bought or sold on a given observation
+	//		minTick		Per contract minimum tick increment (0 disables profit taking)
+	//		numTicks	Number of ticks from the open position price to take a profit
+	//		openAvg		0	Each trade individually
+	//				1	Average the open position
+	//
+	// Throws btError on invalid inputs or an uninterpretable signal.
+	ntpResult numTicksProfit(const ohlcSeries &bars, span<const double> sig, double minTick, double numTicks, int openAvg);
+
+	// The two stages of numTicksProfit for callers that own the output buffers (e.g. mxArrays).
+	// 'numTicksProfitScan' returns the profits in observation order (same inputs and errors as
+	// numTicksProfit) so the output has sig.size() + profits.size() rows.  'numTicksProfitMerge'
+	// writes the inputs and the profits in one linear pass.
+	//		barsOut		rowsOut x 4 column major Open | High | Low | Close
+	//		sigOut		rowsOut signals
+	//		barIndex	rowsOut input observation numbers (empty to skip)
+	//
+	// Throws btError if an output is not rowsOut long.
+	std::vector<ntpProfit> numTicksProfitScan(const ohlcSeries &bars, span<const double> sig, double minTick, double numTicks, int openAvg);
+	void numTicksProfitMerge(const ohlcSeries &bars, span<const double> sig, const std::vector<ntpProfit> &profits,
+		span<double> barsOut, span<double> sigOut, span<size_t> barIndex = span<size_t>());
+
+	// numTicksProfit for several profit targets in a single scan of the observations.  Element 't'
+	// equals numTicksProfit(bars, sig, minTick, numTicks[t], openAvg).
+	std::vector<ntpResult> numTicksProfitTargets(const ohlcSeries &bars, span<const double> sig, double minTick,
+		span<const double> numTicks, int openAvg);
+
+	// Optional outputs of numTicksProfitPL
+	struct ntpPlOutputs
+	{
+		plOutputs bars;			// Per input observation (all four empty to skip).  'cash' is summed over the observation and
+						// the virtual bars that belong to it, 'openEQ' and 'netLiq' are end of observation values and
+						// 'returns' their bar to bar change.
+		ntpResult *virtualBars;		// When not NULL receives exactly what numTicksProfit returns
+
+		ntpPlOutputs() : virtualBars(NULL) {}
+	};
+
+	// numTicksProfit followed by calcProfitLoss of its output in a single forward pass.
+	// Profits are merged with the input observations as they are found and the merged rows are
+	// streamed through the calcProfitLoss ledger (btPlStream.h), so virtual bars are never stored
+	// unless 'out.virtualBars' asks for them.
+	//
+	// Returns the statistics of the merged rows, i.e. calcProfitLossStats of the numTicksProfit output.
+	plStats numTicksProfitPL(const ohlcSeries &bars, span<const double> sig, double minTick, double numTicks, int openAvg,
+		double bigPoint, double cost, const ntpPlOutputs &out = ntpPlOutputs());
+
+	// numTicksProfitPL statistics for several profit targets in a single scan.  Element 't' equals
+	// numTicksProfitPL(bars, sig, minTick, numTicks[t], openAvg, bigPoint, cost).
+	std::vector<plStats> numTicksProfitPLTargets(const ohlcSeries &bars, span<const double> sig, double minTick,
+		span<const double> numTicks, int openAvg, double bigPoint, double cost);
+}
+
+#endif // BTNUMTICKSPROFIT_H
@@ -0,0 +1,101 @@
+// btParallel.h
+//
+// Minimal fork | join helper for the backtest core.
+// Runs fn(idx) for idx in [0, count) on up to 'threads' workers pulling indices from a shared
+// counter so uneven column costs balance themselves.  The calling thread is one of the workers.
+// The first exception thrown by any task is rethrown on the calling thread after all workers join.
+// If a worker thread cannot be started the work runs on those that were (at least the caller).
+//
+// The core never touches the MatLab API so it is safe to call from within a MEX gateway.
+
+#ifndef BTPARALLEL_H
+#define BTPARALLEL_H
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace openAlgo
+{
+	// 0 = one worker per hardware thread
+	inline unsigned resolveThreads(unsigned threads, size_t count)
+	{
+		if (threads == 0)
+		{
+			threads = std::thread::hardware_concurrency();
+			if (threads == 0)
+				threads = 1;
+		}
+
+		if (count < threads)
+			threads = unsigned(count);
+
+		return threads == 0 ? 1 : threads;
+	}
+
+	template <typename F>
+	void parallelFor(size_t count, unsigned threads, F fn)
+	{
+		threads = resolveThreads(threads, count);
+
+		// Nothing to gain from spawning
+		if (threads <= 1)
+		{
+			for (size_t idx = 0; idx < count; idx++)
+				fn(idx);
+			return;
+		}
+
+		std::atomic<size_t> next(0);
+		std::exception_ptr firstErr;
+		std::mutex errLock;
+
+		auto worker = [&]()
+		{
+			for (size_t idx = next++; idx < count; idx = next++)
+			{
+				try
+				{
+					fn(idx);
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> guard(errLock);
+					if (!firstErr)
+						firstErr = std::current_exception();
+					// Stop handing out work
+					next = count;
+				}
+			}
+		};
+
+		// A worker that cannot be started leaves its share to the workers already running.  Letting
+		// the std::system_error out would destroy joinable threads (std::terminate).
+		std::vector<std::thread> pool;
+		pool.reserve(threads - 1);
+		for (unsigned tt = 1; tt < threads; tt++)
+		{
+			try
+			{
+				pool.emplace_back(worker);
+			}
+			catch (const std::system_error &)
+			{
+				break;
+			}
+		}
+
+		worker();
+
+		for (size_t tt = 0; tt < pool.size(); tt++)
+			pool[tt].join();
+
+		if (firstErr)
+			std::rethrow_exception(firstErr);
+	}
+}
+
+#endif // BTPARALLEL_H
@@ -0,0 +1,154 @@
+// btPlStep.h
+//
+// One signal of the calcProfitLoss ledger.
+//
+// Shared by the batch ledger (btProfitLoss.cpp) and the streaming ledger (btPlStream.cpp) so
+// both book exactly the same trades at exactly the same prices.
+
+#ifndef BTPLSTEP_H
+#define BTPLSTEP_H
+
+#include "btLedger.h"
+#include "btSignal.h"
+#include "btError.h"
+#include "myMath.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace openAlgo
+{
+	inline void throwUnknownAdvSig(double advSig)
+	{
+		char msg[160];
+		snprintf(msg, sizeof(msg), "A signal contained an advanced fractional instruction %f that we could not interpret. Aborting.", advSig);
+		throw btError("calcProfitLoss:AdvancedSignal:fractionUnknown", msg);
+	}
+
+	// Side of the fill for a signal (+1 purchase | -1 sale)
+	inline int fillSide(double sig)
+	{
+		return (sig > 0) ? 1 : -1;
+	}
+
+	// Apply the non-zero signal 'sig' raised on observation 'ii' at execution price 'fillPx'.
+	// 'Price' is double or, for the integer tick mode, int64 ticks.
+	// Every closing fill is reported to 'onTrade(lot, qty, pnl)' with the line item it closes
+	// against, the signed quantity closed (the sign of the line item) and its P&L, and the cash
+	// they book is returned.
+	// An uninterpretable signal throws before the ledger or 'openPosition' is modified.
+	template <typename Price, typename TradeFn>
+	inline Price applySignal(basicTradeLedger<Price> &openLedger, int &openPosition, int ii, double sig, Price fillPx,
+		Price bigPoint, Price cost, TradeFn &&onTrade)
+	{
+		const Price BIG_POINT = bigPoint;
+		const Price COST = cost;
+
+		Price barCash = 0;
+
+		// Is this an advanced signal?
+		if (fraction(sig))
+		{
+			// Check for known advanced signal type
+			if (!knownAdvSig(sig))
+				throwUnknownAdvSig(sig);
+
+			// Check for additive or reductive
+			// We ignore reverse advance instructions when they are additive
+			if (!((openPosition <= 0 && sig <= -1) || (openPosition >= 0 && sig >= 1)))
+			{
+				// Reductive reverse instruction.  Liquidate any open position
+				while (!openLedger.empty())
+				{
+					// Aggregate cash for corresponding observations (signal + 1)
+					Price pnl = ((fillPx - openLedger.front().price) * openLedger.front().quantity * BIG_POINT) -
+						(abs(openLedger.front().quantity) * COST);
+					barCash = barCash + pnl;
+					onTrade(openLedger.front(), openLedger.front().quantity, pnl);
+					openLedger.pop_front();
+				}
+
+				openPosition = 0;
+			}
+		}
+
+		// Any integer and if so Additive or reductive ?
+		if ((openPosition <= 0 && sig <= -1) || (openPosition >= 0 && sig >= 1))
+		{
+			// Trade is additive. Add or create existing position --> openLedger
+			openLedger.push_back(ii, int(sig), fillPx);
+			openPosition = openPosition + int(sig);
+		}
+		// Reductive
+		else
+		{
+			// Signal is effectively a reverse or liquidate
+			if (abs(int(sig)) >= abs(openPosition))
+			{
+				// New trade is larger than or equal to existing position. Calculate cash on all ledger lines
+				while (!openLedger.empty())
+				{
+					// Aggregate cash for corresponding observations (signal + 1)
+					Price pnl = ((fillPx - openLedger.front().price) * openLedger.front().quantity * BIG_POINT) -
+						(abs(openLedger.front().quantity) * COST);
+					barCash = barCash + pnl;
+					onTrade(openLedger.front(), openLedger.front().quantity, pnl);
+					openLedger.pop_front();
+				}
+
+				// update open position tracker
+				openPosition = int(sig) + openPosition;
+
+				// if there is a 'remainder', this is the new net open position
+				// put it on the openLedger
+				if (openPosition != 0)
+				{
+					openLedger.push_back(ii, openPosition, fillPx);
+				}
+			}
+			// partial liquidation
+			else
+			{
+				// New trade is smaller than the current open position.
+				// How many do we need to reduce by?  (opposite sign to the open position)
+				int needQty = int(sig);
+
+				// Prepare to iterate until we are satisfied
+				while (needQty != 0)
+				{
+					// Is the current line item quantity larger than what we need?
+					if (abs(openLedger.front().quantity) > abs(needQty))
+					{
+						// If so we will P&L the quantity we need and reduce the open position size
+						Price pnl = ((fillPx - openLedger.front().price) * -needQty * BIG_POINT) -
+							(abs(needQty) * COST);
+						barCash = barCash + pnl;
+						onTrade(openLedger.front(), -needQty, pnl);
+						// Reduce the position size.  We are aggregating so we add (e.g. 5 Purchases + 4 Sales = 1 Long)
+						openLedger.reduceFront(needQty);
+						// We are satisfied and don't need any more contracts
+						needQty = 0;
+					}
+					// Current line item quantity is equal to or smaller than what we need.  Process P&L and remove.
+					else
+					{
+						// P&L entire quantity
+						Price pnl = ((fillPx - openLedger.front().price) * openLedger.front().quantity * BIG_POINT) -
+							(abs(openLedger.front().quantity) * COST);
+						barCash = barCash + pnl;
+						onTrade(openLedger.front(), openLedger.front().quantity, pnl);
+						// Reduce needed quantity by what we've been provided
+						needQty = needQty + openLedger.front().quantity;
+						// Remove the line item (FIFO)
+						openLedger.pop_front();
+					}
+				}
+				// update open position tracker
+				openPosition = openPosition + int(sig);
+			}
+		}
+
+		return barCash;
+	}
+}
+
+#endif // BTPLSTEP_H
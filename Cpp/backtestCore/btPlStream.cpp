@@ -0,0 +1,178 @@
+// btPlStream.cpp
+//
+// Streaming calcProfitLoss.  See btPlStream.h.
+
+#include "btPlStream.h"
+#include "btError.h"
+
+using namespace std;
+
+namespace openAlgo
+{
+	// Checkpoint layout
+	enum
+	{
+		CKPT_VERSION = 1,
+		CKPT_HEADER = 13,			// Scalars before the line items
+		CKPT_LOT = 3				// index | quantity | price per line item
+	};
+
+	plStream::plStream(double bigPoint, double cost)
+		: m_bigPoint(bigPoint), m_cost(cost), m_bars(0), m_phase(0), m_pendSig(0), m_openPosition(0),
+		m_heldCash(0), m_heldOpenEQ(0), m_runSum(0), m_prevNetLiq(0)
+	{
+		// Grows on demand.  There is no signal count to size it from.
+		m_ledger.reset(16);
+	}
+
+	void plStream::release(double openEQ, plBar &out)
+	{
+		const size_t idx = m_bars - 1;
+
+		m_runSum = m_runSum + m_heldCash;
+		double netLiq = m_runSum + openEQ;
+
+		out.index = idx;
+		out.cash = m_heldCash;
+		out.openEQ = openEQ;
+		out.netLiq = netLiq;
+		out.returns = (idx > 0) ? netLiq - m_prevNetLiq : 0;
+
+		m_prevNetLiq = netLiq;
+	}
+
+	bool plStream::current(plBar &out) const
+	{
+		if (m_bars == 0)
+			return false;
+
+		const size_t idx = m_bars - 1;
+		double netLiq = (m_runSum + m_heldCash) + m_heldOpenEQ;
+
+		out.index = idx;
+		out.cash = m_heldCash;
+		out.openEQ = m_heldOpenEQ;
+		out.netLiq = netLiq;
+		out.returns = (idx > 0) ? netLiq - m_prevNetLiq : 0;
+
+		return true;
+	}
+
+	vector<double> plStream::checkpoint() const
+	{
+		vector<double> state;
+		state.reserve(CKPT_HEADER + CKPT_LOT * m_ledger.size());
+
+		state.push_back(CKPT_VERSION);
+		state.push_back(m_bigPoint);
+		state.push_back(m_cost);
+		state.push_back(double(m_bars));
+		state.push_back(m_phase);
+		state.push_back(m_pendSig);
+		state.push_back(m_openPosition);
+		state.push_back(m_heldCash);
+		state.push_back(m_heldOpenEQ);
+		state.push_back(m_runSum);
+		state.push_back(m_prevNetLiq);
+		state.push_back(m_ledger.sumQtyPrice());
+		state.push_back(double(m_ledger.size()));
+
+		for (size_t ii = 0; ii < m_ledger.size(); ii++)
+		{
+			const tradeEntry &lot = m_ledger.at(ii);
+			state.push_back(lot.index);
+			state.push_back(lot.quantity);
+			state.push_back(lot.price);
+		}
+
+		return state;
+	}
+
+	void plStream::restore(span<const double> state)
+	{
+		if (state.size() < CKPT_HEADER || state[0] != CKPT_VERSION ||
+			state.size() != CKPT_HEADER + CKPT_LOT * size_t(state[12]) ||
+			(state[4] != 0 && state[4] != 1 && state[4] != 2))
+			throw btError("plStream:Restore:BadCheckpoint",
+			"The state was not produced by plStream::checkpoint. Aborting.");
+
+		const size_t lots = size_t(state[12]);
+		vector<tradeEntry> entries(lots);
+		for (size_t ii = 0; ii < lots; ii++)
+		{
+			const double *lot = state.data() + CKPT_HEADER + CKPT_LOT * ii;
+			entries[ii].index = int(lot[0]);
+			entries[ii].quantity = int(lot[1]);
+			entries[ii].price = lot[2];
+		}
+
+		m_ledger.restore(entries.data(), lots, state[11]);
+		m_bigPoint = state[1];
+		m_cost = state[2];
+		m_bars = size_t(state[3]);
+		m_phase = int(state[4]);
+		m_pendSig = state[5];
+		m_openPosition = int(state[6]);
+		m_heldCash = state[7];
+		m_heldOpenEQ = state[8];
+		m_runSum = state[9];
+		m_prevNetLiq = state[10];
+	}
+}
+
+//
+//  -------------------------------------------------------------------------
+//                                  _    _ 
+//         ___  _ __   ___ _ __    / \  | | __ _  ___   ___  _ __ __ _ 
+//        / _ \| '_ \ / _ \ '_ \  / _ \ | |/ _` |/ _ \ / _ \| '__/ _` |
+//       | (_) | |_) |  __/ | | |/ ___ \| | (_| | (_) | (_) | | | (_| |
+//        \___/| .__/ \___|_| |_/_/   \_\_|\__, |\___(_)___/|_|  \__, |
+//             |_|                         |___/                 |___/
+//  -------------------------------------------------------------------------
+//        This code is distributed in the hope that it will be useful,
+//
+//                         WITHOUT ANY WARRANTY AND
+//
+//                  WITHOUT CLAIM AS TO MERCHANTABILITY
+//
+//                  OR FITNESS FOR A PARTICULAR PURPOSE
+//
+//                           EXPRESSED OR IMPLIED.
+//
+//   Use of this code, pseudocode, algorithmic or trading logic contained
+//   herein, whether sound or faulty for any purpose is the sole
+//   responsibility of the USER. Any such use of these algorithms, coding
+//   logic or concepts in whole or in part carry no covenant of correctness
+//   or recommended usage from the AUTHOR or any of the possible
+//   contributors listed or unlisted, known or unknown.
+//
+//	 Redistribution and use in source and binary forms, with or without
+//	 modification, are permitted provided that the following conditions are met: 
+//
+//	 1. Redistributions of source code must retain the below copyright notice, 
+//	 this list of conditions and the following disclaimer. 
+//	 2. Redistributions in binary form must reproduce the below copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution. 
+//
+//   The public sharing of this code does not relinquish, reduce, restrict or
+//   encumber any rights the AUTHOR has in respect to claims of intellectual
+//   property.
+//
+//   IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY
+//   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+//   OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+//   STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//   ANY WAY OUT OF THE USE OF THIS SOFTWARE, CODE, OR CODE FRAGMENT(S), EVEN
+//   IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//   -------------------------------------------------------------------------
+//
+//                             ALL RIGHTS RESERVED
+//
+//   -------------------------------------------------------------------------
+//
+//   Author:	Mark Tompkins
+//
@@ -0,0 +1,156 @@
+// btPlStream.h
+//
+// Streaming form of calcProfitLoss.
+//
+// Consumes one observation (Open, Close, signal) at a time and keeps the open ledger, running
+// cash and netLiq between calls, so each new bar costs O(1) amortized instead of a re-run over
+// the whole history.  Signals follow the calcProfitLoss conventions (see btProfitLoss.h) and are
+// booked by the same ledger step as the batch form (btPlStep.h).
+//
+// Timing:
+//		The signal of observation 'k' is filled at the Open of observation 'k+1', so 'push' of
+//		observation 'k' books the signal of 'k-1' and marks open equity to the Close of 'k'.
+//		The openEQ cleaning of calcProfitLoss adjusts observation 'k' from observation 'k+1', so
+//		observation 'k' is final only once 'k+1' has been pushed.  'push' returns the newest
+//		final observation and 'current' reports the newest observation as it would appear if the
+//		series ended now.
+//
+// After pushing N observations the N-1 bars returned by 'push' followed by 'current' equal
+// calcProfitLoss over the same N observations.  netLiq is the scalar running sum, which is
+// bit-identical to calcProfitLoss except where btPostPass.h documents vector kernel rounding.
+//
+// Signals are stricter than in calcProfitLoss.  An unknown fractional signal is rejected when it
+// is pushed, whatever the phase.  calcProfitLoss only rejects one it fills, so it accepts such a
+// signal before the first trade, on the first trade (whose integer portion is used) and on the
+// last observation.  Checking on push keeps a rejected observation from leaving a signal in the
+// state that would make every later push throw.
+//
+// 'checkpoint' saves the complete state as a flat array of doubles and 'restore' resumes from it.
+
+#ifndef BTPLSTREAM_H
+#define BTPLSTREAM_H
+
+#include "btSpan.h"
+#include "btLedger.h"
+#include "btPlStep.h"
+#include <vector>
+
+namespace openAlgo
+{
+	// One observation of calcProfitLoss output
+	struct plBar
+	{
+		size_t index;			// Observation number (0 based)
+		double cash;
+		double openEQ;
+		double netLiq;
+		double returns;
+	};
+
+	class plStream
+	{
+	public:
+		plStream(double bigPoint, double cost);
+
+		// Consume observation 'bars()'.  Returns true and sets 'out' when an earlier observation
+		// became final.  Throws btError on an uninterpretable signal (any unknown fraction, see
+		// above) without changing the state.
+		bool push(double open, double close, double sig, plBar &out)
+		{
+			return push(open, close, sig, out, [](double) {});
+		}
+
+		// As above and reports the P&L of every closing fill to 'onTrade(double)'
+		template <typename TradeFn>
+		bool push(double open, double close, double sig, plBar &out, TradeFn &&onTrade);
+
+		// The newest observation as if the series ended here.  Returns false before the first push.
+		bool current(plBar &out) const;
+
+		// Number of observations consumed
+		size_t bars() const { return m_bars; }
+
+		// Net open position
+		int position() const { return m_openPosition; }
+
+		std::vector<double> checkpoint() const;
+
+		// Throws btError if 'state' was not produced by checkpoint()
+		void restore(span<const double> state);
+
+	private:
+		// Release the held observation with its cleaned openEQ
+		void release(double openEQ, plBar &out);
+
+		double m_bigPoint;
+		double m_cost;
+
+		size_t m_bars;				// Observations consumed
+		int m_phase;				// 0 no trade yet | 1 first trade awaiting its fill | 2 trading
+		double m_pendSig;			// Signal of the newest observation (filled on the next push)
+
+		tradeLedger m_ledger;
+		int m_openPosition;
+
+		// Newest observation, held back for the openEQ cleaning
+		double m_heldCash;
+		double m_heldOpenEQ;
+
+		double m_runSum;			// Cumulative cash of released observations
+		double m_prevNetLiq;			// netLiq of the last released observation
+	};
+
+	template <typename TradeFn>
+	bool plStream::push(double open, double close, double sig, plBar &out, TradeFn &&onTrade)
+	{
+		// Rejected here, before any member changes, rather than when it is filled on the next push
+		if (fraction(sig) && !knownAdvSig(sig))
+			throwUnknownAdvSig(sig);
+
+		const int kk = int(m_bars);
+		double barCash = 0;
+		double barOpenEQ = 0;
+
+		// Cash and open equity of observation 'kk'.  Nothing below may throw once the ledger has changed.
+		if (m_phase == 2)
+		{
+			if (m_pendSig != 0)
+				barCash = applySignal(m_ledger, m_openPosition, kk - 1, m_pendSig, open, m_bigPoint, m_cost,
+					[&onTrade](const tradeEntry &, int, double pnl) { onTrade(pnl); });
+
+			if (m_openPosition != 0)
+				barOpenEQ = m_ledger.openEquity(close, m_bigPoint);
+		}
+		else if (m_phase == 1)
+		{
+			// First trade.  Only the integer portion is used and its fill observation carries no open equity.
+			m_ledger.push_back(kk - 1, int(m_pendSig), open);
+			m_openPosition = int(m_pendSig);
+			m_phase = 2;
+		}
+		else if (isTrade(sig))
+			m_phase = 1;
+
+		m_pendSig = sig;
+
+		// The held observation is final now that its successor is known
+		bool released = false;
+		if (kk >= 1)
+		{
+			double heldOpenEQ = m_heldOpenEQ;
+			if (kk - 1 >= 1 && heldOpenEQ != barCash && barOpenEQ == 0 && barCash > 0)
+				heldOpenEQ = barCash;
+
+			release(heldOpenEQ, out);
+			released = true;
+		}
+
+		m_heldCash = barCash;
+		m_heldOpenEQ = barOpenEQ;
+		m_bars++;
+
+		return released;
+	}
+}
+
+#endif // BTPLSTREAM_H
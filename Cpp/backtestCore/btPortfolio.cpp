@@ -0,0 +1,186 @@
+// btPortfolio.cpp
+//
+// Multi-instrument portfolio P&L.  See btPortfolio.h.
+
+#include "btPortfolio.h"
+#include "btProfitLoss.h"
+#include "btParallel.h"
+#include "btError.h"
+#include <cmath>
+#include <string>
+
+using namespace std;
+
+namespace openAlgo
+{
+	// Observations per reduction task
+	static const size_t REDUCE_CHUNK = 4096;
+
+	// netLiq of one instrument aligned to its input observations
+	static void runInstrument(const instrumentSpec &inst, size_t rows, double *netLiqOut)
+	{
+		vector<double> cash(rows), openEQ(rows), returns(rows);
+
+		plOutputs out;
+		out.cash = cash;
+		out.openEQ = openEQ;
+		out.netLiq = span<double>(netLiqOut, rows);
+		out.returns = returns;
+
+		// Profit taking.  Virtual bars are folded onto the observation they were taken in as they are found.
+		if (inst.numTicks > 0 && inst.minTick > 0)
+		{
+			ntpPlOutputs ntpOut;
+			ntpOut.bars = out;
+			numTicksProfitPL(inst.bars, inst.sig, inst.minTick, inst.numTicks, inst.openAvg, inst.bigPoint, inst.cost, ntpOut);
+			return;
+		}
+
+		calcProfitLoss(inst.bars.open, inst.bars.close, inst.sig, inst.bigPoint, inst.cost, out);
+	}
+
+	portfolioResult runPortfolio(span<const instrumentSpec> instruments, unsigned threads)
+	{
+		if (instruments.empty())
+			throw btError("MATLAB:portfolioProfitLoss:NumInputs",
+			"At least one instrument is required. Aborting.");
+
+		const size_t rows = instruments[0].sig.size();
+		const size_t numInst = instruments.size();
+
+		for (size_t mm = 0; mm < numInst; mm++)
+		{
+			const instrumentSpec &inst = instruments[mm];
+
+			if (inst.sig.size() != rows || inst.bars.open.size() != rows || inst.bars.close.size() != rows)
+				throw btError("MATLAB:portfolioProfitLoss:ArrayMismatch",
+				"Every instrument must have the same number of timestamp aligned observations (instrument " + to_string(mm + 1) + "). Aborting.");
+
+			if (inst.numTicks < 0)
+				throw btError("MATLAB:portfolioProfitLoss:BadInputType",
+				"Input 'numTicks' must be greater than or equal to zero (instrument " + to_string(mm + 1) + "). Aborting.");
+		}
+
+		portfolioResult result;
+		result.rows = rows;
+		result.instruments = numInst;
+		result.netLiq.assign(rows * numInst, 0);
+		result.returns.assign(rows * numInst, 0);
+		result.totalNetLiq.assign(rows, 0);
+		result.totalReturns.assign(rows, 0);
+		result.sharpe = 0;
+		result.maxDrawdown = 0;
+
+		// Map: one instrument per task
+		parallelFor(numInst, threads, [&](size_t mm)
+		{
+			try
+			{
+				runInstrument(instruments[mm], rows, result.netLiq.data() + mm * rows);
+			}
+			catch (const btError &err)
+			{
+				throw btError(err.id(), string(err.what()) + " (instrument " + to_string(mm + 1) + ")");
+			}
+		});
+
+		// Reduce: sum across instruments in a fixed order so results do not depend on the thread count
+		const size_t chunks = (rows + REDUCE_CHUNK - 1) / REDUCE_CHUNK;
+		parallelFor(chunks, threads, [&](size_t chunk)
+		{
+			const size_t first = chunk * REDUCE_CHUNK;
+			const size_t last = (first + REDUCE_CHUNK < rows) ? first + REDUCE_CHUNK : rows;
+
+			for (size_t mm = 0; mm < numInst; mm++)
+			{
+				const double *netLiq = result.netLiq.data() + mm * rows;
+				double *returns = result.returns.data() + mm * rows;
+
+				for (size_t rr = first; rr < last; rr++)
+				{
+					result.totalNetLiq[rr] += netLiq[rr];
+					returns[rr] = (rr > 0) ? netLiq[rr] - netLiq[rr - 1] : 0;
+				}
+			}
+		});
+
+		// Aggregate returns and statistics
+		double mean = 0, m2 = 0, peak = 0;
+		for (size_t rr = 0; rr < rows; rr++)
+		{
+			result.totalReturns[rr] = (rr > 0) ? result.totalNetLiq[rr] - result.totalNetLiq[rr - 1] : 0;
+
+			// Welford
+			double delta = result.totalReturns[rr] - mean;
+			mean += delta / double(rr + 1);
+			m2 += delta * (result.totalReturns[rr] - mean);
+
+			if (result.totalNetLiq[rr] > peak)
+				peak = result.totalNetLiq[rr];
+			if (peak - result.totalNetLiq[rr] > result.maxDrawdown)
+				result.maxDrawdown = peak - result.totalNetLiq[rr];
+		}
+
+		double stdev = (rows > 1) ? sqrt(m2 / double(rows - 1)) : 0;
+		result.sharpe = (stdev > 0) ? mean / stdev : 0;
+
+		return result;
+	}
+}
+
+//
+//  -------------------------------------------------------------------------
+//                                  _    _ 
+//         ___  _ __   ___ _ __    / \  | | __ _  ___   ___  _ __ __ _ 
+//        / _ \| '_ \ / _ \ '_ \  / _ \ | |/ _` |/ _ \ / _ \| '__/ _` |
+//       | (_) | |_) |  __/ | | |/ ___ \| | (_| | (_) | (_) | | | (_| |
+//        \___/| .__/ \___|_| |_/_/   \_\_|\__, |\___(_)___/|_|  \__, |
+//             |_|                         |___/                 |___/
+//  -------------------------------------------------------------------------
+//        This code is distributed in the hope that it will be useful,
+//
+//                         WITHOUT ANY WARRANTY AND
+//
+//                  WITHOUT CLAIM AS TO MERCHANTABILITY
+//
+//                  OR FITNESS FOR A PARTICULAR PURPOSE
+//
+//                           EXPRESSED OR IMPLIED.
+//
+//   Use of this code, pseudocode, algorithmic or trading logic contained
+//   herein, whether sound or faulty for any purpose is the sole
+//   responsibility of the USER. Any such use of these algorithms, coding
+//   logic or concepts in whole or in part carry no covenant of correctness
+//   or recommended usage from the AUTHOR or any of the possible
+//   contributors listed or unlisted, known or unknown.
+//
+//	 Redistribution and use in source and binary forms, with or without
+//	 modification, are permitted provided that the following conditions are met: 
+//
+//	 1. Redistributions of source code must retain the below copyright notice, 
+//	 this list of conditions and the following disclaimer. 
+//	 2. Redistributions in binary form must reproduce the below copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution. 
+//
+//   The public sharing of this code does not relinquish, reduce, restrict or
+//   encumber any rights the AUTHOR has in respect to claims of intellectual
+//   property.
+//
+//   IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY
+//   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+//   OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+//   STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//   ANY WAY OUT OF THE USE OF THIS SOFTWARE, CODE, OR CODE FRAGMENT(S), EVEN
+//   IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//   -------------------------------------------------------------------------
+//
+//                             ALL RIGHTS RESERVED
+//
+//   -------------------------------------------------------------------------
+//
+//   Author:	Mark Tompkins
+//
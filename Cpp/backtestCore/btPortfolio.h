@@ -0,0 +1,52 @@
+// btPortfolio.h
+//
+// Multi-instrument portfolio P&L built on calcProfitLoss semantics.
+//
+// Each instrument carries its own prices, signal, bigPoint, cost and (optionally) numTicksProfit
+// profit taking parameters.  Bars must be timestamp aligned: observation 'r' of every instrument
+// refers to the same moment in time so all instruments have the same number of observations.
+//
+// Instruments are evaluated in parallel.  When profit taking inserts virtual bars, the virtual
+// rows are folded back onto the observation they were taken in (end of observation netLiq) so
+// every per-instrument curve is aligned with the input bars.  The aggregate curve is the
+// reduction (sum) of the per-instrument netLiq curves.
+
+#ifndef BTPORTFOLIO_H
+#define BTPORTFOLIO_H
+
+#include "btSpan.h"
+#include "btNumTicksProfit.h"
+#include <vector>
+
+namespace openAlgo
+{
+	struct instrumentSpec
+	{
+		ohlcSeries bars;		// Open | High | Low | Close.  High and Low are only required with profit taking.
+		span<const double> sig;		// Signal per observation
+		double bigPoint;		// Full tick dollar value
+		double cost;			// Per contract commission
+		double minTick;			// Minimum tick increment
+		double numTicks;		// Profit target in ticks.  0 disables numTicksProfit.
+		int openAvg;			// numTicksProfit 'openAvg' (0 = atomic | 1 = average)
+
+		instrumentSpec() : bigPoint(1), cost(0), minTick(0), numTicks(0), openAvg(0) {}
+	};
+
+	struct portfolioResult
+	{
+		size_t rows;			// Aligned observations
+		size_t instruments;		// Number of instruments (M)
+		std::vector<double> netLiq;	// rows x M column major per instrument netLiq
+		std::vector<double> returns;	// rows x M column major per instrument returns
+		std::vector<double> totalNetLiq;	// Aggregate netLiq
+		std::vector<double> totalReturns;	// Aggregate bar to bar returns
+		double sharpe;			// mean / std (N-1) of totalReturns.  Equals MatLab sharpe(totalReturns,0).
+		double maxDrawdown;		// Largest peak to trough decline of totalNetLiq
+	};
+
+	// Throws btError on misaligned inputs or an uninterpretable signal (the message identifies the instrument).
+	portfolioResult runPortfolio(span<const instrumentSpec> instruments, unsigned threads = 0);
+}
+
+#endif // BTPORTFOLIO_H
@@ -0,0 +1,279 @@
+// btPostPass.cpp
+//
+// Scalar, AVX2 and AVX-512 kernels for the fused calcProfitLoss post-processing pass.
+// See btPostPass.h for the definition of the pass and its numerical tolerance.
+//
+// The vector kernels are compiled with per-function target attributes (GCC | Clang) so the rest
+// of the library needs no special compiler flags.  MSVC accepts the intrinsics without flags.
+
+#include "btPostPass.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BT_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(BT_X86) && (defined(__GNUC__) || defined(__clang__))
+#define BT_TARGET(isa) __attribute__((target(isa)))
+#else
+#define BT_TARGET(isa)
+#endif
+
+namespace openAlgo
+{
+	// Observation 'k' of the pass.  Shared by every kernel for the head and tail.
+	static inline void postPassOne(double *cash, double *openEQ, double *netLiq, double *returns, size_t rows, size_t k,
+		double &runSum)
+	{
+		if (k >= 1 && k + 1 < rows)
+		{
+			if (openEQ[k] != cash[k + 1] && openEQ[k + 1] == 0 && cash[k + 1] > 0)
+				openEQ[k] = cash[k + 1];
+		}
+
+		runSum = runSum + cash[k];
+		netLiq[k] = runSum + openEQ[k];
+		returns[k] = (k > 0) ? netLiq[k] - netLiq[k - 1] : 0;
+	}
+
+	static void postPassScalar(double *cash, double *openEQ, double *netLiq, double *returns, size_t rows)
+	{
+		double runSum = 0;
+		for (size_t k = 0; k < rows; k++)
+			postPassOne(cash, openEQ, netLiq, returns, rows, k, runSum);
+	}
+
+#ifdef BT_X86
+	BT_TARGET("avx2")
+	static void postPassAVX2(double *cash, double *openEQ, double *netLiq, double *returns, size_t rows)
+	{
+		double runSum = 0;
+		size_t k = 0;
+
+		// Observation 0 is never cleaned and has no return
+		if (rows > 0)
+			postPassOne(cash, openEQ, netLiq, returns, rows, k++, runSum);
+
+		const __m256d zero = _mm256_setzero_pd();
+		__m256d carry = _mm256_set1_pd(runSum);
+		__m256d prevNet = _mm256_set1_pd(rows > 0 ? netLiq[0] : 0);
+
+		// Vector body needs observations k .. k+4 (cleaning looks one ahead) and k+3 <= rows-2
+		for (; k + 4 < rows; k += 4)
+		{
+			// Cleaning
+			__m256d eq = _mm256_loadu_pd(openEQ + k);
+			__m256d eqNext = _mm256_loadu_pd(openEQ + k + 1);
+			__m256d cashNext = _mm256_loadu_pd(cash + k + 1);
+			__m256d clean = _mm256_and_pd(_mm256_and_pd(
+				_mm256_cmp_pd(eq, cashNext, _CMP_NEQ_UQ),
+				_mm256_cmp_pd(eqNext, zero, _CMP_EQ_OQ)),
+				_mm256_cmp_pd(cashNext, zero, _CMP_GT_OQ));
+			eq = _mm256_blendv_pd(eq, cashNext, clean);
+			_mm256_storeu_pd(openEQ + k, eq);
+
+			// Inclusive prefix sum of cash
+			__m256d scan = _mm256_loadu_pd(cash + k);
+			scan = _mm256_add_pd(scan, _mm256_blend_pd(_mm256_permute4x64_pd(scan, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x1));
+			scan = _mm256_add_pd(scan, _mm256_blend_pd(_mm256_permute4x64_pd(scan, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x3));
+			__m256d run = _mm256_add_pd(carry, scan);
+			carry = _mm256_permute4x64_pd(run, _MM_SHUFFLE(3, 3, 3, 3));
+
+			// netLiq and first difference
+			__m256d net = _mm256_add_pd(run, eq);
+			_mm256_storeu_pd(netLiq + k, net);
+			__m256d shifted = _mm256_blend_pd(_mm256_permute4x64_pd(net, _MM_SHUFFLE(2, 1, 0, 0)), prevNet, 0x1);
+			_mm256_storeu_pd(returns + k, _mm256_sub_pd(net, shifted));
+			prevNet = _mm256_permute4x64_pd(net, _MM_SHUFFLE(3, 3, 3, 3));
+		}
+
+		runSum = _mm256_cvtsd_f64(carry);
+		for (; k < rows; k++)
+			postPassOne(cash, openEQ, netLiq, returns, rows, k, runSum);
+	}
+
+	BT_TARGET("avx512f")
+	static void postPassAVX512(double *cash, double *openEQ, double *netLiq, double *returns, size_t rows)
+	{
+		double runSum = 0;
+		size_t k = 0;
+
+		if (rows > 0)
+			postPassOne(cash, openEQ, netLiq, returns, rows, k++, runSum);
+
+		const __m512d zero = _mm512_setzero_pd();
+		const __m512i shift1 = _mm512_set_epi64(6, 5, 4, 3, 2, 1, 0, 0);
+		const __m512i shift2 = _mm512_set_epi64(5, 4, 3, 2, 1, 0, 0, 0);
+		const __m512i shift4 = _mm512_set_epi64(3, 2, 1, 0, 0, 0, 0, 0);
+		// Lane 7 broadcast.  Used through the masked permute with a zero source because the unmasked
+		// form reads an undefined vector (-Wmaybe-uninitialized).
+		const __m512i last = _mm512_set1_epi64(7);
+		__m512d carry = _mm512_set1_pd(runSum);
+		__m512d prevNet = _mm512_set1_pd(rows > 0 ? netLiq[0] : 0);
+
+		for (; k + 8 < rows; k += 8)
+		{
+			// Cleaning
+			__m512d eq = _mm512_loadu_pd(openEQ + k);
+			__m512d eqNext = _mm512_loadu_pd(openEQ + k + 1);
+			__m512d cashNext = _mm512_loadu_pd(cash + k + 1);
+			__mmask8 clean = _mm512_cmp_pd_mask(eq, cashNext, _CMP_NEQ_UQ) &
+				_mm512_cmp_pd_mask(eqNext, zero, _CMP_EQ_OQ) &
+				_mm512_cmp_pd_mask(cashNext, zero, _CMP_GT_OQ);
+			eq = _mm512_mask_blend_pd(clean, eq, cashNext);
+			_mm512_storeu_pd(openEQ + k, eq);
+
+			// Inclusive prefix sum of cash
+			__m512d scan = _mm512_loadu_pd(cash + k);
+			scan = _mm512_add_pd(scan, _mm512_maskz_permutexvar_pd(0xFE, shift1, scan));
+			scan = _mm512_add_pd(scan, _mm512_maskz_permutexvar_pd(0xFC, shift2, scan));
+			scan = _mm512_add_pd(scan, _mm512_maskz_permutexvar_pd(0xF0, shift4, scan));
+			__m512d run = _mm512_add_pd(carry, scan);
+			carry = _mm512_mask_permutexvar_pd(zero, 0xFF, last, run);
+
+			// netLiq and first difference
+			__m512d net = _mm512_add_pd(run, eq);
+			_mm512_storeu_pd(netLiq + k, net);
+			__m512d shifted = _mm512_mask_permutexvar_pd(prevNet, 0xFE, shift1, net);
+			_mm512_storeu_pd(returns + k, _mm512_sub_pd(net, shifted));
+			prevNet = _mm512_mask_permutexvar_pd(zero, 0xFF, last, net);
+		}
+
+		runSum = _mm512_cvtsd_f64(carry);
+		for (; k < rows; k++)
+			postPassOne(cash, openEQ, netLiq, returns, rows, k, runSum);
+	}
+
+	static simdLevel cpuSimdLevel()
+	{
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return simdScalar;
+
+		// OS must save the YMM (and for AVX-512 the ZMM | opmask) state
+		__cpuid(info, 1);
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+		if (!osxsave || !avx)
+			return simdScalar;
+
+		unsigned long long xcr0 = _xgetbv(0);
+		__cpuidex(info, 7, 0);
+		bool avx2 = (info[1] & (1 << 5)) != 0;
+		bool avx512f = (info[1] & (1 << 16)) != 0;
+
+		if (avx512f && (xcr0 & 0xE6) == 0xE6)
+			return simdAVX512;
+		if (avx2 && (xcr0 & 0x6) == 0x6)
+			return simdAVX2;
+		return simdScalar;
+#elif defined(__GNUC__) || defined(__clang__)
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f"))
+			return simdAVX512;
+		if (__builtin_cpu_supports("avx2"))
+			return simdAVX2;
+		return simdScalar;
+#else
+		return simdScalar;
+#endif
+	}
+#endif // BT_X86
+
+	simdLevel detectSimdLevel()
+	{
+#ifdef BT_X86
+		static const simdLevel level = cpuSimdLevel();
+		return level;
+#else
+		return simdScalar;
+#endif
+	}
+
+	void plPostPass(double *cash, double *openEQ, double *netLiq, double *returns, size_t rows)
+	{
+		plPostPass(cash, openEQ, netLiq, returns, rows, detectSimdLevel());
+	}
+
+	void plPostPass(double *cash, double *openEQ, double *netLiq, double *returns, size_t rows, simdLevel level)
+	{
+		if (level > detectSimdLevel())
+			level = detectSimdLevel();
+
+#ifdef BT_X86
+		if (level == simdAVX512)
+		{
+			postPassAVX512(cash, openEQ, netLiq, returns, rows);
+			return;
+		}
+		if (level == simdAVX2)
+		{
+			postPassAVX2(cash, openEQ, netLiq, returns, rows);
+			return;
+		}
+#endif
+		postPassScalar(cash, openEQ, netLiq, returns, rows);
+	}
+}
+
+//
+//  -------------------------------------------------------------------------
+//                                  _    _ 
+//         ___  _ __   ___ _ __    / \  | | __ _  ___   ___  _ __ __ _ 
+//        / _ \| '_ \ / _ \ '_ \  / _ \ | |/ _` |/ _ \ / _ \| '__/ _` |
+//       | (_) | |_) |  __/ | | |/ ___ \| | (_| | (_) | (_) | | | (_| |
+//        \___/| .__/ \___|_| |_/_/   \_\_|\__, |\___(_)___/|_|  \__, |
+//             |_|                         |___/                 |___/
+//  -------------------------------------------------------------------------
+//        This code is distributed in the hope that it will be useful,
+//
+//                         WITHOUT ANY WARRANTY AND
+//
+//                  WITHOUT CLAIM AS TO MERCHANTABILITY
+//
+//                  OR FITNESS FOR A PARTICULAR PURPOSE
+//
+//                           EXPRESSED OR IMPLIED.
+//
+//   Use of this code, pseudocode, algorithmic or trading logic contained
+//   herein, whether sound or faulty for any purpose is the sole
+//   responsibility of the USER. Any such use of these algorithms, coding
+//   logic or concepts in whole or in part carry no covenant of correctness
+//   or recommended usage from the AUTHOR or any of the possible
+//   contributors listed or unlisted, known or unknown.
+//
+//	 Redistribution and use in source and binary forms, with or without
+//	 modification, are permitted provided that the following conditions are met: 
+//
+//	 1. Redistributions of source code must retain the below copyright notice, 
+//	 this list of conditions and the following disclaimer. 
+//	 2. Redistributions in binary form must reproduce the below copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution. 
+//
+//   The public sharing of this code does not relinquish, reduce, restrict or
+//   encumber any rights the AUTHOR has in respect to claims of intellectual
+//   property.
+//
+//   IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY
+//   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+//   OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+//   STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//   ANY WAY OUT OF THE USE OF THIS SOFTWARE, CODE, OR CODE FRAGMENT(S), EVEN
+//   IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//   -------------------------------------------------------------------------
+//
+//                             ALL RIGHTS RESERVED
+//
+//   -------------------------------------------------------------------------
+//
+//   Author:	Mark Tompkins
+//
@@ -0,0 +1,45 @@
+// btPostPass.h
+//
+// Fused post-processing pass of calcProfitLoss.
+//
+// For each observation 'k' in one sweep:
+//		openEQ[k]	cleaned:  if openEQ[k] != cash[k+1] && openEQ[k+1] == 0 && cash[k+1] > 0 (1 <= k <= rows-2)
+//				then openEQ[k] = cash[k+1]
+//		netLiq[k]	cumulative cash + openEQ[k]
+//		returns[k]	netLiq[k] - netLiq[k-1]  (returns[0] = 0)
+//
+// The cleaning of 'k' only reads the uncleaned value of 'k+1', so the three original loops fuse
+// without changing the result.
+//
+// AVX2 and AVX-512 kernels are selected at run time from the CPU and fall back to scalar code on
+// other processors or compilers.  The cleaning and the difference are exact.  The vector kernels
+// form the running cash sum with an in-register prefix scan which changes the order of additions,
+// so netLiq may differ from the scalar result by a few ulps of the running cash total.  Results
+// are bit-identical whenever cash values are exactly representable partial sums (e.g. whole
+// dollar P&L), which is the common case.
+
+#ifndef BTPOSTPASS_H
+#define BTPOSTPASS_H
+
+#include <cstddef>
+
+namespace openAlgo
+{
+	enum simdLevel
+	{
+		simdScalar = 0,
+		simdAVX2 = 1,
+		simdAVX512 = 2
+	};
+
+	// Best level supported by both this build and the running CPU
+	simdLevel detectSimdLevel();
+
+	// Run the pass with the detected level
+	void plPostPass(double *cash, double *openEQ, double *netLiq, double *returns, size_t rows);
+
+	// Run the pass with a specific level.  Levels above detectSimdLevel() fall back to the best supported.
+	void plPostPass(double *cash, double *openEQ, double *netLiq, double *returns, size_t rows, simdLevel level);
+}
+
+#endif // BTPOSTPASS_H
@@ -0,0 +1,757 @@
+// btProfitLoss.cpp
+//
+// MEX-free implementation of calcProfitLoss.  See btProfitLoss.h for the interface and
+// Matlab/MEX/Cpp/calcProfitLoss/calcProfitLoss.cpp for the MatLab gateway.
+//
+// The ledger is written once as 'runLedger' and templated on a sink that receives each
+// observation's cash and open equity as soon as they are final, plus each closing fill.
+// The array sink stores them for the post-processing pass.  The stats sink streams them
+// through online accumulators so no per observation storage is needed.
+//
+// The signal handling itself is 'applySignal' (btPlStep.h) which the streaming form shares.
+// The ledger is also templated on the fill policy (see btFill.h).  The default entry points use
+// fillNextOpen which compiles to the original 'fillPx' load.
+//
+// Price and signal storage types are template parameters as well.  Single precision prices and
+// single precision or int8 signals are widened to double as they are read.
+
+#include "btProfitLoss.h"
+#include "btSignal.h"
+#include "btError.h"
+#include "btParallel.h"
+#include "btLedger.h"
+#include "btPlStep.h"
+#include "btPostPass.h"
+#include "btFill.h"
+#include "myMath.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+using namespace std;
+
+namespace openAlgo
+{
+	template <typename T, typename S>
+	static void checkInputs(const basicOhlcSeries<T> &bars, span<const S> sig, const fillModel &fill)
+	{
+		if (bars.open.size() != sig.size() || bars.close.size() != sig.size())
+			throw btError("MATLAB:calcProfitLoss:ArrayMismatch",
+			"The number of rows in the data array and the signal array are different. Aborting.");
+
+		if (fill.needsRange() && (bars.high.size() != sig.size() || bars.low.size() != sig.size()))
+			throw btError("MATLAB:calcProfitLoss:ArrayMismatch",
+			"The selected fill model requires High and Low for every observation. Aborting.");
+
+		if (fill.base != fillOpen && fill.base != fillClose && fill.base != fillVWAP)
+			throw btError("MATLAB:calcProfitLoss:BadFillModel", "Unknown fill model. Aborting.");
+	}
+
+	template <typename S>
+	static void checkOutputs(span<const S> sig, const plOutputs &out)
+	{
+		if (out.cash.size() != sig.size() || out.openEQ.size() != sig.size() ||
+			out.netLiq.size() != sig.size() || out.returns.size() != sig.size())
+			throw btError("MATLAB:calcProfitLoss:ArrayMismatch",
+			"The output arrays must be the same length as the signal array. Aborting.");
+	}
+
+	// Sink for the full per observation outputs
+	struct plArraySink
+	{
+		double *cash;
+		double *openEQ;
+
+		void bar(int idx, double barCash, double barOpenEQ)
+		{
+			cash[idx] = barCash;
+			openEQ[idx] = barOpenEQ;
+		}
+
+		void trade(double) {}
+	};
+
+	// Sink that reproduces the post-processing pass one observation at a time.
+	// The openEQ cleaning of observation 'll' depends on observation 'll+1', so each observation
+	// is held back by one before it is released to the accumulators.
+	struct plStatsSink
+	{
+		plStatsAccumulator accum;
+
+		bool havePending;
+		int pendIdx;
+		double pendCash;
+		double pendOpenEQ;
+
+		double runSum;				// Cumulative cash
+		double prevNetLiq;
+		bool released;
+
+		plStatsSink() : havePending(false), pendIdx(0), pendCash(0), pendOpenEQ(0), runSum(0), prevNetLiq(0), released(false) {}
+
+		void bar(int idx, double barCash, double barOpenEQ)
+		{
+			if (havePending)
+			{
+				// Same 'dirty' cleaning as the array pass
+				if (pendIdx >= 1 && pendOpenEQ != barCash && barOpenEQ == 0 && barCash > 0)
+					pendOpenEQ = barCash;
+
+				release(pendCash, pendOpenEQ);
+			}
+
+			havePending = true;
+			pendIdx = idx;
+			pendCash = barCash;
+			pendOpenEQ = barOpenEQ;
+		}
+
+		void trade(double pnl)
+		{
+			accum.trade(pnl);
+		}
+
+		void release(double barCash, double barOpenEQ)
+		{
+			runSum = runSum + barCash;
+			double netLiq = runSum + barOpenEQ;
+			double ret = released ? netLiq - prevNetLiq : 0;
+			prevNetLiq = netLiq;
+			released = true;
+
+			accum.bar(netLiq, ret);
+		}
+
+		plStats finish()
+		{
+			if (havePending)
+				release(pendCash, pendOpenEQ);
+			havePending = false;
+
+			return accum.finish();
+		}
+	};
+
+	// Running extremes for trade excursions.  The lowest Low and highest High from any observation
+	// on are kept as monotonic stacks, so each observation is added in amortized O(1) and the
+	// extreme since a line item's fill is a binary search instead of a per line item update.
+	class excursionTracker
+	{
+	public:
+		void clear()
+		{
+			m_lows.clear();
+			m_highs.clear();
+		}
+
+		void bar(int idx, double high, double low)
+		{
+			while (!m_lows.empty() && m_lows.back().second >= low)
+				m_lows.pop_back();
+			m_lows.push_back(extreme(idx, low));
+
+			while (!m_highs.empty() && m_highs.back().second <= high)
+				m_highs.pop_back();
+			m_highs.push_back(extreme(idx, high));
+		}
+
+		// Lowest Low | highest High of observations 'from' onwards (NaN if none)
+		double lowFrom(int from) const { return suffix(m_lows, from); }
+		double highFrom(int from) const { return suffix(m_highs, from); }
+
+	private:
+		typedef pair<int, double> extreme;	// Observation | price
+
+		static double suffix(const vector<extreme> &stack, int from)
+		{
+			vector<extreme>::const_iterator it = lower_bound(stack.begin(), stack.end(), from,
+				[](const extreme &item, int idx) { return item.first < idx; });
+			return (it == stack.end()) ? NAN : it->second;
+		}
+
+		vector<extreme> m_lows;			// Ascending Lows, each the lowest from its observation on
+		vector<extreme> m_highs;		// Descending Highs, each the highest from its observation on
+	};
+
+	// The ledger.  Every observation is reported to the sink exactly once and in order and every
+	// closing fill is appended to 'trades' when it is not NULL.
+	template <typename Fill, typename Sink, typename T, typename S>
+	static void runLedger(const Fill &fill, const basicOhlcSeries<T> &bars, span<const S> sig,
+		double bigPoint, double cost, Sink &sink, tradeList *trades)
+	{
+		const int rows = int(sig.size());
+		const double BIG_POINT = bigPoint;
+		span<const T> close = bars.close;
+
+		// Excursions need the range of every observation
+		const bool excursions = (trades != NULL) && bars.high.size() == sig.size() && bars.low.size() == sig.size();
+		excursionTracker tracker;
+
+		// Initialize variables
+		int sigIdx;					// Iterator that will store the index of the referenced signal
+
+		if (trades != NULL)
+			trades->clear();
+
+		// Check that we have at least one signal (at least one trade)
+		for (sigIdx = 0; sigIdx < rows; sigIdx++)
+		{
+			if (isTrade(sig[sigIdx]))
+				break;
+		}
+
+		// No trades or signal on the last observation.  Return zeros.
+		if (sigIdx >= rows - 1)
+		{
+			for (int mm = 0; mm < rows; mm++)
+				sink.bar(mm, 0, 0);
+			return;
+		}
+
+		// Nothing can happen before the first fill
+		for (int mm = 0; mm <= sigIdx + 1; mm++)
+			sink.bar(mm, 0, 0);
+
+		// Every line item is created by a trade so the remaining trade count bounds the ledger size
+		size_t maxLots = 0;
+		for (int ii = sigIdx; ii < rows - 1; ii++)
+		{
+			if (isTrade(sig[ii]))
+				maxLots++;
+		}
+
+		// Initialize a ledger for open positions
+		tradeLedger openLedger;
+		openLedger.reset(maxLots);
+
+		// Every line item closes at least once so the trade count is a good first size
+		if (trades != NULL)
+			trades->reserve(maxLots);
+		if (excursions)
+		{
+			trades->mae.reserve(maxLots);
+			trades->mfe.reserve(maxLots);
+			tracker.bar(sigIdx + 1, bars.high[sigIdx + 1], bars.low[sigIdx + 1]);
+		}
+
+		// Put first trade on ledger
+		// price is 'sigIdx+1' because execution price lags signal by one observation
+		// We only need the integer portion of the first trade
+		openLedger.push_back(sigIdx, int(sig[sigIdx]), fill.price(sigIdx + 1, fillSide(sig[sigIdx])));
+
+		// Initialize position trackers
+		int openPosition = int(sig[sigIdx]);
+
+		// ITERATE
+		// Start iterating at next observation
+		// Finish at observation before last in signal array
+		// Cash and open equity of observation 'ii + 1' are complete at the end of each iteration
+		for (int ii = sigIdx + 1; ii < rows - 1; ii++)
+		{
+			double barCash = 0;
+			double barOpenEQ = 0;
+
+			if (sig[ii] != 0)
+			{
+				// Every line item touched by this signal executes at the same price
+				const double fillPx = fill.price(ii + 1, fillSide(sig[ii]));
+
+				barCash = applySignal(openLedger, openPosition, ii, sig[ii], fillPx, bigPoint, cost,
+					[&](const tradeEntry &lot, int qty, double pnl)
+				{
+					sink.trade(pnl);
+					if (trades != NULL)
+						trades->push_back(lot.index, ii, qty, lot.price, fillPx, pnl);
+
+					if (excursions)
+					{
+						// Observations 'lot.index + 1' (entry fill) to 'ii' (before the exit fill)
+						const double high = fmax(tracker.highFrom(lot.index + 1), fmax(lot.price, fillPx));
+						const double low = fmin(tracker.lowFrom(lot.index + 1), fmin(lot.price, fillPx));
+						const double best = (qty > 0) ? high : low;
+						const double worst = (qty > 0) ? low : high;
+						trades->mae.push_back((worst - lot.price) * qty * BIG_POINT);
+						trades->mfe.push_back((best - lot.price) * qty * BIG_POINT);
+					}
+				});
+			}
+
+			if (excursions)
+			{
+				// Nothing before a fill is needed once the position is flat
+				if (openPosition == 0)
+					tracker.clear();
+				tracker.bar(ii + 1, bars.high[ii + 1], bars.low[ii + 1]);
+			}
+
+			// Calculate current openEQ if there are any positions
+			// !!!!!!!!!!!!!!!!!!!!!!
+			// !! IMPORTANT
+			// !!!!!!!!!!!!!!!!!!!!!!
+			// Because we are using virtual bars for calculations, we have introduced a known issue
+			// that a profit may occur within an observation High or Low.  To offset this we will
+			// clean certain openEQ calculations below. This will cause some invalid depictions
+			// of open equity between observations but would be effectively be a margining issue
+			if (openPosition != 0)
+			{
+				// The ledger aggregates all line items as they are booked
+				barOpenEQ = openLedger.openEquity(close[ii + 1], BIG_POINT);
+			}
+
+			sink.bar(ii + 1, barCash, barOpenEQ);
+		} // end for
+	}
+
+	// Select the compiled ledger for a run time fill model.  Evaluated once per call.
+	template <typename Base, typename Sink, typename T, typename S>
+	static void runFill(const basicOhlcSeries<T> &bars, span<const S> sig, double bigPoint, double cost,
+		const fillModel &model, Sink &sink, tradeList *trades)
+	{
+		if (model.adjusted())
+			runLedger(fillAdjusted<Base, T>(bars, model.slippageTicks * model.minTick, model.rangeSpread), bars, sig, bigPoint, cost, sink, trades);
+		else
+			runLedger(Base(bars), bars, sig, bigPoint, cost, sink, trades);
+	}
+
+	template <typename Sink, typename T, typename S>
+	static void runModel(const basicOhlcSeries<T> &bars, span<const S> sig, double bigPoint, double cost,
+		const fillModel &model, Sink &sink, tradeList *trades)
+	{
+		switch (model.base)
+		{
+		case fillClose:
+			runFill<fillNextClose<T> >(bars, sig, bigPoint, cost, model, sink, trades);
+			break;
+		case fillVWAP:
+			runFill<fillBarVWAP<T> >(bars, sig, bigPoint, cost, model, sink, trades);
+			break;
+		default:
+			runFill<fillNextOpen<T> >(bars, sig, bigPoint, cost, model, sink, trades);
+			break;
+		}
+	}
+
+	static ohlcSeries openClose(span<const double> open, span<const double> close)
+	{
+		ohlcSeries bars;
+		bars.open = open;
+		bars.close = close;
+		return bars;
+	}
+
+	void calcProfitLoss(span<const double> open, span<const double> close, span<const double> sig,
+		double bigPoint, double cost, const plOutputs &out)
+	{
+		calcProfitLoss(openClose(open, close), sig, bigPoint, cost, fillModel(), out);
+	}
+
+	// calcProfitLoss of any storage type
+	template <typename T, typename S>
+	static void profitLossArrays(const basicOhlcSeries<T> &bars, span<const S> sig, double bigPoint, double cost,
+		const fillModel &fill, const plOutputs &out)
+	{
+		const int rows = int(sig.size());
+
+		checkInputs(bars, sig, fill);
+		checkOutputs(sig, out);
+
+		double *cashIdx = out.cash.data();
+		double *openEQIdx = out.openEQ.data();
+
+		plArraySink sink;
+		sink.cash = cashIdx;
+		sink.openEQ = openEQIdx;
+		runModel(bars, sig, bigPoint, cost, fill, sink, out.trades);
+
+		// A 'dirty' cleaning of trades that were closed on the next observation, then netLiq and returns.
+		// Because we are creating a vBar for profit objectives, if the openEquity is greater than the next
+		// observation's cash, we'll reduce openEquity to equal cash.  This should normalize some spikes.
+		// The three passes are fused and vectorized (see btPostPass.h).
+		plPostPass(cashIdx, openEQIdx, out.netLiq.data(), out.returns.data(), size_t(rows));
+	}
+
+	void calcProfitLoss(const ohlcSeries &bars, span<const double> sig, double bigPoint, double cost,
+		const fillModel &fill, const plOutputs &out)
+	{
+		profitLossArrays(bars, sig, bigPoint, cost, fill, out);
+	}
+
+	// Whole ticks of 'price'.  Throws if it is not on a tick.
+	static int64_t toTicks(double price, double minTick)
+	{
+		const double ticks = price / minTick;
+		const double whole = floor(ticks + 0.5);
+
+		// Allows for the representation error of the division.  NaN fails the test.
+		if (!(fabs(ticks - whole) <= 1e-6))
+		{
+			char msg[160];
+			snprintf(msg, sizeof(msg), "The price %f is not a multiple of 'minTick' %f. Aborting.", price, minTick);
+			throw btError("MATLAB:calcProfitLoss:notOnTick", msg);
+		}
+
+		return int64_t(whole);
+	}
+
+	// The ledger in whole ticks.  Each observation records the ticks booked, the contracts traded
+	// (for the cost) and the open equity in ticks.  Observations are as in runLedger.
+	template <typename Fill>
+	static void runTickLedger(const Fill &fill, span<const double> close, span<const double> sig, double minTick,
+		vector<int64_t> &cashTicks, vector<int64_t> &cashLots, vector<int64_t> &eqTicks)
+	{
+		const int rows = int(sig.size());
+
+		int sigIdx;
+		for (sigIdx = 0; sigIdx < rows; sigIdx++)
+		{
+			if (isTrade(sig[sigIdx]))
+				break;
+		}
+
+		// No trades or signal on the last observation.  Everything stays zero.
+		if (sigIdx >= rows - 1)
+			return;
+
+		size_t maxLots = 0;
+		for (int ii = sigIdx; ii < rows - 1; ii++)
+		{
+			if (isTrade(sig[ii]))
+				maxLots++;
+		}
+
+		tickLedger openLedger;
+		openLedger.reset(maxLots);
+		openLedger.push_back(sigIdx, int(sig[sigIdx]), toTicks(fill.price(sigIdx + 1, fillSide(sig[sigIdx])), minTick));
+		int openPosition = int(sig[sigIdx]);
+
+		for (int ii = sigIdx + 1; ii < rows - 1; ii++)
+		{
+			if (sig[ii] != 0)
+			{
+				const int64_t fillPx = toTicks(fill.price(ii + 1, fillSide(sig[ii])), minTick);
+				int64_t lots = 0;
+
+				// One tick per point and no cost.  Contracts are counted and costed on output.
+				cashTicks[ii + 1] = applySignal(openLedger, openPosition, ii, sig[ii], fillPx, int64_t(1), int64_t(0),
+					[&lots](const tickLedger::entry &, int qty, int64_t) { lots += abs(qty); });
+				cashLots[ii + 1] = lots;
+			}
+
+			if (openPosition != 0)
+				eqTicks[ii + 1] = openLedger.openEquity(toTicks(close[ii + 1], minTick), 1);
+		}
+	}
+
+	template <typename Base>
+	static void runTickFill(const ohlcSeries &bars, span<const double> sig, double minTick, const fillModel &model,
+		vector<int64_t> &cashTicks, vector<int64_t> &cashLots, vector<int64_t> &eqTicks)
+	{
+		if (model.adjusted())
+			runTickLedger(fillAdjusted<Base, double>(bars, model.slippageTicks * model.minTick, model.rangeSpread), bars.close, sig,
+				minTick, cashTicks, cashLots, eqTicks);
+		else
+			runTickLedger(Base(bars), bars.close, sig, minTick, cashTicks, cashLots, eqTicks);
+	}
+
+	void calcProfitLossTicks(const ohlcSeries &bars, span<const double> sig, double minTick, double bigPoint,
+		double cost, const fillModel &fill, const plOutputs &out)
+	{
+		const size_t rows = sig.size();
+
+		checkInputs(bars, sig, fill);
+		checkOutputs(sig, out);
+
+		if (!(minTick > 0))
+			throw btError("MATLAB:calcProfitLoss:minTickError",
+			"Input 'minTick' must be greater than zero for integer tick arithmetic. Aborting.");
+
+		vector<int64_t> cashTicks(rows, 0), cashLots(rows, 0), eqTicks(rows, 0);
+		switch (fill.base)
+		{
+		case fillClose:
+			runTickFill<fillNextClose<double> >(bars, sig, minTick, fill, cashTicks, cashLots, eqTicks);
+			break;
+		case fillVWAP:
+			runTickFill<fillBarVWAP<double> >(bars, sig, minTick, fill, cashTicks, cashLots, eqTicks);
+			break;
+		default:
+			runTickFill<fillNextOpen<double> >(bars, sig, minTick, fill, cashTicks, cashLots, eqTicks);
+			break;
+		}
+
+		// The post-processing pass of btPostPass.h on exact (ticks, contracts) pairs.  A cleaned openEQ
+		// takes the pair of the next observation's cash.
+		const double tickValue = minTick * bigPoint;
+		auto value = [tickValue, cost](int64_t ticks, int64_t lots)
+		{
+			return double(ticks) * tickValue - double(lots) * cost;
+		};
+
+		int64_t sumTicks = 0;
+		int64_t sumLots = 0;
+		double prevNetLiq = 0;
+		for (size_t k = 0; k < rows; k++)
+		{
+			int64_t eqT = eqTicks[k];
+			int64_t eqL = 0;
+
+			if (k >= 1 && k + 1 < rows)
+			{
+				const double nextCash = value(cashTicks[k + 1], cashLots[k + 1]);
+				if (value(eqT, 0) != nextCash && eqTicks[k + 1] == 0 && nextCash > 0)
+				{
+					eqT = cashTicks[k + 1];
+					eqL = cashLots[k + 1];
+				}
+			}
+
+			sumTicks += cashTicks[k];
+			sumLots += cashLots[k];
+			const double netLiq = value(sumTicks + eqT, sumLots + eqL);
+
+			out.cash[k] = value(cashTicks[k], cashLots[k]);
+			out.openEQ[k] = value(eqT, eqL);
+			out.netLiq[k] = netLiq;
+			out.returns[k] = (k > 0) ? netLiq - prevNetLiq : 0;
+			prevNetLiq = netLiq;
+		}
+	}
+
+	plStats calcProfitLossStats(span<const double> open, span<const double> close, span<const double> sig,
+		double bigPoint, double cost)
+	{
+		return calcProfitLossStats(openClose(open, close), sig, bigPoint, cost, fillModel());
+	}
+
+	template <typename T, typename S>
+	static plStats profitLossStats(const basicOhlcSeries<T> &bars, span<const S> sig, double bigPoint, double cost,
+		const fillModel &fill, tradeList *trades)
+	{
+		checkInputs(bars, sig, fill);
+
+		plStatsSink sink;
+		runModel(bars, sig, bigPoint, cost, fill, sink, trades);
+
+		return sink.finish();
+	}
+
+	plStats calcProfitLossStats(const ohlcSeries &bars, span<const double> sig, double bigPoint, double cost,
+		const fillModel &fill, tradeList *trades)
+	{
+		return profitLossStats(bars, sig, bigPoint, cost, fill, trades);
+	}
+
+	// Rethrow a column's error with the MatLab column number appended
+	static void throwColumnError(const btError &err, size_t col)
+	{
+		throw btError(err.id(), std::string(err.what()) + " (signal column " + std::to_string(col + 1) + ")");
+	}
+
+	template <typename T, typename S>
+	static void checkBatchInputs(const basicOhlcSeries<T> &bars, span<const S> sig, size_t cols)
+	{
+		const size_t rows = bars.size();
+
+		if (bars.close.size() != rows || sig.size() != rows * cols)
+			throw btError("MATLAB:calcProfitLoss:ArrayMismatch",
+			"The number of rows in the data array and the signal array are different. Aborting.");
+	}
+
+	void calcProfitLossBatch(span<const double> open, span<const double> close, span<const double> sig, size_t cols,
+		double bigPoint, double cost, const plOutputs &out, unsigned threads)
+	{
+		calcProfitLossBatch(openClose(open, close), sig, cols, bigPoint, cost, fillModel(), out, threads);
+	}
+
+	void calcProfitLossBatch(const ohlcSeries &bars, span<const double> sig, size_t cols,
+		double bigPoint, double cost, const fillModel &fill, const plOutputs &out, unsigned threads)
+	{
+		calcProfitLossBatch<double, double>(bars, sig, cols, bigPoint, cost, fill, out, threads);
+	}
+
+	template <typename T, typename S>
+	void calcProfitLossBatch(const basicOhlcSeries<T> &bars, span<const S> sig, size_t cols,
+		double bigPoint, double cost, const fillModel &fill, const plOutputs &out, unsigned threads)
+	{
+		const size_t rows = bars.size();
+
+		checkBatchInputs(bars, sig, cols);
+
+		if (out.cash.size() != rows * cols || out.openEQ.size() != rows * cols ||
+			out.netLiq.size() != rows * cols || out.returns.size() != rows * cols)
+			throw btError("MATLAB:calcProfitLoss:ArrayMismatch",
+			"The output arrays must be the same size as the signal array. Aborting.");
+
+		// Every column reads the same price series so it stays resident in a shared cache level
+		// while each worker owns its own slice of the outputs.
+		parallelFor(cols, threads, [&](size_t col)
+		{
+			const size_t offset = col * rows;
+
+			plOutputs colOut;
+			colOut.cash = out.cash.subspan(offset, rows);
+			colOut.openEQ = out.openEQ.subspan(offset, rows);
+			colOut.netLiq = out.netLiq.subspan(offset, rows);
+			colOut.returns = out.returns.subspan(offset, rows);
+			colOut.trades = (out.trades != NULL) ? out.trades + col : NULL;
+
+			try
+			{
+				profitLossArrays(bars, sig.subspan(offset, rows), bigPoint, cost, fill, colOut);
+			}
+			catch (const btError &err)
+			{
+				throwColumnError(err, col);
+			}
+		});
+	}
+
+	void calcProfitLossTicksBatch(const ohlcSeries &bars, span<const double> sig, size_t cols, double minTick,
+		double bigPoint, double cost, const fillModel &fill, const plOutputs &out, unsigned threads)
+	{
+		const size_t rows = bars.size();
+
+		checkBatchInputs(bars, sig, cols);
+
+		if (out.cash.size() != rows * cols || out.openEQ.size() != rows * cols ||
+			out.netLiq.size() != rows * cols || out.returns.size() != rows * cols)
+			throw btError("MATLAB:calcProfitLoss:ArrayMismatch",
+			"The output arrays must be the same size as the signal array. Aborting.");
+
+		parallelFor(cols, threads, [&](size_t col)
+		{
+			const size_t offset = col * rows;
+
+			plOutputs colOut;
+			colOut.cash = out.cash.subspan(offset, rows);
+			colOut.openEQ = out.openEQ.subspan(offset, rows);
+			colOut.netLiq = out.netLiq.subspan(offset, rows);
+			colOut.returns = out.returns.subspan(offset, rows);
+
+			try
+			{
+				calcProfitLossTicks(bars, sig.subspan(offset, rows), minTick, bigPoint, cost, fill, colOut);
+			}
+			catch (const btError &err)
+			{
+				throwColumnError(err, col);
+			}
+		});
+	}
+
+	void calcProfitLossStatsBatch(span<const double> open, span<const double> close, span<const double> sig, size_t cols,
+		double bigPoint, double cost, span<plStats> out, unsigned threads)
+	{
+		calcProfitLossStatsBatch(openClose(open, close), sig, cols, bigPoint, cost, fillModel(), out, threads);
+	}
+
+	void calcProfitLossStatsBatch(const ohlcSeries &bars, span<const double> sig, size_t cols,
+		double bigPoint, double cost, const fillModel &fill, span<plStats> out, unsigned threads, tradeList *trades)
+	{
+		calcProfitLossStatsBatch<double, double>(bars, sig, cols, bigPoint, cost, fill, out, threads, trades);
+	}
+
+	template <typename T, typename S>
+	void calcProfitLossStatsBatch(const basicOhlcSeries<T> &bars, span<const S> sig, size_t cols,
+		double bigPoint, double cost, const fillModel &fill, span<plStats> out, unsigned threads, tradeList *trades)
+	{
+		const size_t rows = bars.size();
+
+		checkBatchInputs(bars, sig, cols);
+
+		if (out.size() != cols)
+			throw btError("MATLAB:calcProfitLoss:ArrayMismatch",
+			"One statistics output is required per signal column. Aborting.");
+
+		parallelFor(cols, threads, [&](size_t col)
+		{
+			try
+			{
+				out[col] = profitLossStats(bars, sig.subspan(col * rows, rows), bigPoint, cost, fill,
+					(trades != NULL) ? trades + col : NULL);
+			}
+			catch (const btError &err)
+			{
+				throwColumnError(err, col);
+			}
+		});
+	}
+
+	// Storage types of the templated batch forms
+#define BT_PL_INSTANTIATE(T, S) \
+	template void calcProfitLossBatch<T, S>(const basicOhlcSeries<T> &, span<const S>, size_t, double, double, \
+		const fillModel &, const plOutputs &, unsigned); \
+	template void calcProfitLossStatsBatch<T, S>(const basicOhlcSeries<T> &, span<const S>, size_t, double, double, \
+		const fillModel &, span<plStats>, unsigned, tradeList *);
+
+	BT_PL_INSTANTIATE(double, double)
+	BT_PL_INSTANTIATE(double, float)
+	BT_PL_INSTANTIATE(double, int8_t)
+	BT_PL_INSTANTIATE(float, double)
+	BT_PL_INSTANTIATE(float, float)
+	BT_PL_INSTANTIATE(float, int8_t)
+
+#undef BT_PL_INSTANTIATE
+}
+
+//
+//  -------------------------------------------------------------------------
+//                                  _    _ 
+//         ___  _ __   ___ _ __    / \  | | __ _  ___   ___  _ __ __ _ 
+//        / _ \| '_ \ / _ \ '_ \  / _ \ | |/ _` |/ _ \ / _ \| '__/ _` |
+//       | (_) | |_) |  __/ | | |/ ___ \| | (_| | (_) | (_) | | | (_| |
+//        \___/| .__/ \___|_| |_/_/   \_\_|\__, |\___(_)___/|_|  \__, |
+//             |_|                         |___/                 |___/
+//  -------------------------------------------------------------------------
+//        This code is distributed in the hope that it will be useful,
+//
+//                         WITHOUT ANY WARRANTY AND
+//
+//                  WITHOUT CLAIM AS TO MERCHANTABILITY
+//
+//                  OR FITNESS FOR A PARTICULAR PURPOSE
+//
+//                           EXPRESSED OR IMPLIED.
+//
+//   Use of this code, pseudocode, algorithmic or trading logic contained
+//   herein, whether sound or faulty for any purpose is the sole
+//   responsibility of the USER. Any such use of these algorithms, coding
+//   logic or concepts in whole or in part carry no covenant of correctness
+//   or recommended usage from the AUTHOR or any of the possible
+//   contributors listed or unlisted, known or unknown.
+//
+//	 Redistribution and use in source and binary forms, with or without
+//	 modification, are permitted provided that the following conditions are met: 
+//
+//	 1. Redistributions of source code must retain the below copyright notice, 
+//	 this list of conditions and the following disclaimer. 
+//	 2. Redistributions in binary form must reproduce the below copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution. 
+//
+//   The public sharing of this code does not relinquish, reduce, restrict or
+//   encumber any rights the AUTHOR has in respect to claims of intellectual
+//   property.
+//
+//   IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY
+//   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+//   OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+//   STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//   ANY WAY OUT OF THE USE OF THIS SOFTWARE, CODE, OR CODE FRAGMENT(S), EVEN
+//   IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//   -------------------------------------------------------------------------
+//
+//                             ALL RIGHTS RESERVED
+//
+//   -------------------------------------------------------------------------
+//
+//   Author:	Mark Tompkins
+//
@@ -0,0 +1,251 @@
+// btProfitLoss.h
+//
+// MEX-free core of calcProfitLoss.
+//
+// Produces bar by bar cash, open equity, net liquidation value and returns for a single
+// instrument from a price series and a signal array.  Signals follow the fractional
+// convention documented in Matlab/MEX/Cpp/calcProfitLoss/calcProfitLoss.cpp:
+//
+//		SIGNAL =  0		No action
+//		SIGNAL =  X		Buy or Sell X (additive or reductive to the current position)
+//		SIGNAL = +/-0.5		Close out any position
+//		SIGNAL = +/-X.5		Reverse to a net position of +/-X
+//
+// Execution lags the signal by one observation: a signal on bar 'i' is filled at the Open of
+// bar 'i+1'.  Open equity is marked to the Close.
+//
+// The overloads taking an ohlcSeries and a fillModel replace the Open fill with another
+// price and/or adverse slippage (see btFill.h).  The default fillModel is the Open fill.
+
+#ifndef BTPROFITLOSS_H
+#define BTPROFITLOSS_H
+
+#include "btSpan.h"
+#include "btSeries.h"
+#include "btFill.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace openAlgo
+{
+	// Trade list.  One row per closing fill (a plStats trade) in struct of arrays layout.
+	// Indices are signal indices.  Both fills execute on the following observation.
+	//
+	// Excursions are tracked when High and Low are supplied for every observation and are empty
+	// otherwise.  They are the worst (MAE) and best (MFE) open P&L of the quantity closed over the
+	// entry and exit prices and the High | Low of every observation from the entry fill up to the
+	// one before the exit fill.  Both are before cost, so 'mae' <= 0 <= 'mfe'.
+	struct tradeList
+	{
+		std::vector<int> entryIndex;		// Signal that opened the line item
+		std::vector<int> exitIndex;		// Signal that closed it
+		std::vector<int> quantity;		// Signed quantity closed (+ long | - short)
+		std::vector<double> entryPrice;		// Execution prices
+		std::vector<double> exitPrice;
+		std::vector<double> pnl;		// Trade P&L net of the per contract cost
+		std::vector<double> mae;		// Maximum adverse excursion
+		std::vector<double> mfe;		// Maximum favorable excursion
+
+		size_t size() const { return pnl.size(); }
+
+		void clear()
+		{
+			entryIndex.clear();
+			exitIndex.clear();
+			quantity.clear();
+			entryPrice.clear();
+			exitPrice.clear();
+			pnl.clear();
+			mae.clear();
+			mfe.clear();
+		}
+
+		void reserve(size_t rows)
+		{
+			entryIndex.reserve(rows);
+			exitIndex.reserve(rows);
+			quantity.reserve(rows);
+			entryPrice.reserve(rows);
+			exitPrice.reserve(rows);
+			pnl.reserve(rows);
+		}
+
+		void push_back(int entry, int exit, int qty, double entryPx, double exitPx, double tradePnl)
+		{
+			entryIndex.push_back(entry);
+			exitIndex.push_back(exit);
+			quantity.push_back(qty);
+			entryPrice.push_back(entryPx);
+			exitPrice.push_back(exitPx);
+			pnl.push_back(tradePnl);
+		}
+	};
+
+	// Caller owned output arrays.  Each must be the same length as the price series.
+	struct plOutputs
+	{
+		span<double> cash;		// Cash debits and credits
+		span<double> openEQ;		// Bar to bar open equity if there is an open position
+		span<double> netLiq;		// Aggregated cash plus the current open equity
+		span<double> returns;		// Bar to bar change in netLiq
+		tradeList *trades;		// When not NULL receives the trade list (replacing its contents).
+						// The batched forms expect one tradeList per signal column.
+
+		plOutputs() : trades(NULL) {}
+	};
+
+	// Summary statistics accumulated while the ledger runs (no per observation output).
+	// Returns are the bar to bar change in netLiq exactly as produced by calcProfitLoss, including
+	// the leading zero, so 'sharpe' equals MatLab's sharpe(returns,0).
+	// A trade is one closing fill against an open line item.  A lot closed in pieces counts once
+	// per piece.  Trade P&L is net of the per contract cost.
+	struct plStats
+	{
+		size_t bars;			// Number of observations
+		double meanReturn;		// Welford mean of returns
+		double varReturn;		// Sample variance of returns (N-1)
+		double stdReturn;		// Sample standard deviation of returns
+		double sharpe;			// meanReturn / stdReturn (0 if stdReturn is 0)
+		double maxDrawdown;		// Largest peak to trough decline of netLiq (positive number)
+		size_t trades;			// Closing fills
+		size_t winners;			// Closing fills with a P&L greater than zero
+		double winRate;			// winners / trades (0 if no trades)
+		double grossProfit;		// Sum of winning trade P&L
+		double grossLoss;		// Sum of losing trade P&L (zero or negative)
+		double netProfit;		// grossProfit + grossLoss (closed trades only)
+		double netLiq;			// Final netLiq including any open equity
+	};
+
+	// Online accumulator behind plStats.  Observations are fed in order once they are final.
+	class plStatsAccumulator
+	{
+	public:
+		plStatsAccumulator() : m_m2(0), m_peak(0), m_lastNetLiq(0)
+		{
+			m_stats = plStats();
+		}
+
+		void bar(double netLiq, double ret)
+		{
+			// Welford
+			m_stats.bars++;
+			double delta = ret - m_stats.meanReturn;
+			m_stats.meanReturn += delta / double(m_stats.bars);
+			m_m2 += delta * (ret - m_stats.meanReturn);
+
+			if (netLiq > m_peak)
+				m_peak = netLiq;
+			if (m_peak - netLiq > m_stats.maxDrawdown)
+				m_stats.maxDrawdown = m_peak - netLiq;
+
+			m_lastNetLiq = netLiq;
+		}
+
+		void trade(double pnl)
+		{
+			m_stats.trades++;
+			if (pnl > 0)
+			{
+				m_stats.winners++;
+				m_stats.grossProfit += pnl;
+			}
+			else
+				m_stats.grossLoss += pnl;
+		}
+
+		plStats finish() const
+		{
+			plStats stats = m_stats;
+			stats.varReturn = (stats.bars > 1) ? m_m2 / double(stats.bars - 1) : 0;
+			stats.stdReturn = std::sqrt(stats.varReturn);
+			stats.sharpe = (stats.stdReturn > 0) ? stats.meanReturn / stats.stdReturn : 0;
+			stats.winRate = (stats.trades > 0) ? double(stats.winners) / double(stats.trades) : 0;
+			stats.netProfit = stats.grossProfit + stats.grossLoss;
+			stats.netLiq = m_lastNetLiq;
+			return stats;
+		}
+
+	private:
+		plStats m_stats;
+		double m_m2;				// Welford sum of squared differences
+		double m_peak;				// Highest netLiq so far
+		double m_lastNetLiq;
+	};
+
+	// Inputs:
+	//		open		Open price per observation
+	//		close		Close price per observation
+	//		sig		Quantity bought or sold on a given observation
+	//		bigPoint	Full tick dollar value of the contract being P&L'd
+	//		cost		Per contract commission
+	//
+	// Throws btError on an uninterpretable signal or mismatched array lengths.
+	void calcProfitLoss(span<const double> open, span<const double> close, span<const double> sig,
+		double bigPoint, double cost, const plOutputs &out);
+
+	// Configurable fill.  High and Low are only required when fill.needsRange().
+	void calcProfitLoss(const ohlcSeries &bars, span<const double> sig, double bigPoint, double cost,
+		const fillModel &fill, const plOutputs &out);
+
+	// Integer tick arithmetic.  Every fill price and every Close marked against an open position
+	// must be a whole multiple of 'minTick' (minTick > 0).  Prices are converted once to int64 tick
+	// counts, the ledger books whole ticks and contracts traded, and each output is scaled from
+	// exact integer sums:
+	//
+	//		value	= ticks x (minTick x bigPoint) - contracts x cost
+	//
+	// so netLiq carries no accumulated rounding and results are reproducible run to run.  The trade
+	// list is not supported ('out.trades' is ignored).  Throws btError if a price is not on a tick.
+	void calcProfitLossTicks(const ohlcSeries &bars, span<const double> sig, double minTick, double bigPoint,
+		double cost, const fillModel &fill, const plOutputs &out);
+
+	// Statistics only.  Runs the same ledger as calcProfitLoss without allocating any per observation output.
+	plStats calcProfitLossStats(span<const double> open, span<const double> close, span<const double> sig,
+		double bigPoint, double cost);
+
+	plStats calcProfitLossStats(const ohlcSeries &bars, span<const double> sig, double bigPoint, double cost,
+		const fillModel &fill, tradeList *trades = NULL);
+
+	// Batched form for parametric sweeps.
+	// 'sig' is a rows x cols column major matrix of signals evaluated against the same price
+	// series.  Each output in 'out' is a rows x cols column major matrix.  Columns are independent
+	// and are processed in parallel on up to 'threads' workers (0 = hardware concurrency).
+	//
+	// Throws btError on mismatched array lengths or if any column contains an uninterpretable
+	// signal.  The message identifies the offending column.
+	void calcProfitLossBatch(span<const double> open, span<const double> close, span<const double> sig, size_t cols,
+		double bigPoint, double cost, const plOutputs &out, unsigned threads = 0);
+
+	// Batched integer tick form (see calcProfitLossTicks)
+	void calcProfitLossTicksBatch(const ohlcSeries &bars, span<const double> sig, size_t cols, double minTick,
+		double bigPoint, double cost, const fillModel &fill, const plOutputs &out, unsigned threads = 0);
+
+	// Batched statistics.  'out' holds one plStats per signal column.
+	void calcProfitLossStatsBatch(span<const double> open, span<const double> close, span<const double> sig, size_t cols,
+		double bigPoint, double cost, span<plStats> out, unsigned threads = 0);
+
+	void calcProfitLossBatch(const ohlcSeries &bars, span<const double> sig, size_t cols,
+		double bigPoint, double cost, const fillModel &fill, const plOutputs &out, unsigned threads = 0);
+
+	// 'trades' is NULL or 'cols' trade lists
+	void calcProfitLossStatsBatch(const ohlcSeries &bars, span<const double> sig, size_t cols,
+		double bigPoint, double cost, const fillModel &fill, span<plStats> out, unsigned threads = 0,
+		tradeList *trades = NULL);
+
+	// Compact storage.  Prices 'T' are double or float and signals 'S' are double, float or int8_t.
+	// Inputs are widened to double as they are read so the ledger, every sum and the outputs are
+	// computed exactly as for double inputs of the same values.  int8 signals carry whole
+	// quantities only (no fractional instructions).
+	template <typename T, typename S>
+	void calcProfitLossBatch(const basicOhlcSeries<T> &bars, span<const S> sig, size_t cols,
+		double bigPoint, double cost, const fillModel &fill, const plOutputs &out, unsigned threads = 0);
+
+	template <typename T, typename S>
+	void calcProfitLossStatsBatch(const basicOhlcSeries<T> &bars, span<const S> sig, size_t cols,
+		double bigPoint, double cost, const fillModel &fill, span<plStats> out, unsigned threads = 0,
+		tradeList *trades = NULL);
+}
+
+#endif // BTPROFITLOSS_H
@@ -0,0 +1,162 @@
+// btRelStrIdx.cpp
+//
+// MEX-free implementation of relStrIdx.  See btRelStrIdx.h for the interface and
+// Matlab/MEX/Cpp/relStrIdx/relStrIdx.cpp for the MatLab gateway.
+
+#include "btRelStrIdx.h"
+#include "btError.h"
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace std;
+
+namespace openAlgo
+{
+	void relStrIdx(span<const double> price, int lookback, span<double> rsi)
+	{
+		const int rowsData = int(price.size());
+
+		if (rsi.size() != price.size())
+			throw btError("MATLAB:relStrIdx:ArrayMismatch",
+			"The output array must be the same length as the price array. Aborting.");
+
+		if (lookback < 1)
+			throw btError("MATLAB:relStrIdx:BadInputType",
+			"The observation lookback must be a positive integer >= 1. Aborting.");
+
+		if (lookback > rowsData)
+			throw btError("MATLAB:relStrIdx:BadInputType",
+			"The lookback cannot be greater than the number of observations. Aborting.");
+
+		const double m_Nan = std::numeric_limits<double>::quiet_NaN();
+
+		// Create temporary arrays for calculations
+		vector<double> advances(rowsData, 0);
+		vector<double> declines(rowsData, 0);
+		vector<double> avgGain(rowsData, 0);
+		vector<double> avgLoss(rowsData, 0);
+
+		/////////////
+		// START
+		/////////////
+
+		// Calculate advances & declines
+		// starting at one because we are doing a difference of the observation prior
+		for (int ii = 1; ii < rowsData; ii++)
+		{
+			if (price[ii] - price[ii - 1] > 0)
+			{
+				advances[ii] = abs(price[ii] - price[ii - 1]);
+				declines[ii] = 0;
+			}
+			else
+			{
+				advances[ii] = 0;
+				declines[ii] = abs(price[ii] - price[ii - 1]);
+			}
+		}
+
+		// Calculate avgGains & avgLosses
+		// Note: these are not averages in the formal sense
+		for (int ii = lookback; ii < rowsData; ii++)
+		{
+			if (ii == lookback)
+			{
+				double sumAdv = 0;
+				double sumDec = 0;
+
+				for (int jj = 0; jj != lookback; jj++)
+				{
+					sumAdv = sumAdv + advances[ii - jj];
+					sumDec = sumDec + declines[ii - jj];
+				}
+
+				avgGain[ii] = sumAdv / lookback;
+				avgLoss[ii] = sumDec / lookback;
+			}
+			else
+			{
+				avgGain[ii] = ((avgGain[ii - 1] * (lookback - 1)) + advances[ii]) / lookback;
+				avgLoss[ii] = ((avgLoss[ii - 1] * (lookback - 1)) + declines[ii]) / lookback;
+			}
+		}
+
+		// Assign RSI values to output array
+		for (int ii = 0; ii < rowsData; ii++)
+		{
+			if (ii < lookback)
+			{
+				rsi[ii] = m_Nan;
+			}
+			else
+			{
+				if (avgLoss[ii] == 0)
+				{
+					rsi[ii] = 100;
+				}
+				else
+				{
+					rsi[ii] = 100 - (100 / (1 + avgGain[ii] / avgLoss[ii]));
+				}
+			}
+		}
+	}
+}
+
+//
+//  -------------------------------------------------------------------------
+//                                  _    _ 
+//         ___  _ __   ___ _ __    / \  | | __ _  ___   ___  _ __ __ _ 
+//        / _ \| '_ \ / _ \ '_ \  / _ \ | |/ _` |/ _ \ / _ \| '__/ _` |
+//       | (_) | |_) |  __/ | | |/ ___ \| | (_| | (_) | (_) | | | (_| |
+//        \___/| .__/ \___|_| |_/_/   \_\_|\__, |\___(_)___/|_|  \__, |
+//             |_|                         |___/                 |___/
+//  -------------------------------------------------------------------------
+//        This code is distributed in the hope that it will be useful,
+//
+//                         WITHOUT ANY WARRANTY AND
+//
+//                  WITHOUT CLAIM AS TO MERCHANTABILITY
+//
+//                  OR FITNESS FOR A PARTICULAR PURPOSE
+//
+//                           EXPRESSED OR IMPLIED.
+//
+//   Use of this code, pseudocode, algorithmic or trading logic contained
+//   herein, whether sound or faulty for any purpose is the sole
+//   responsibility of the USER. Any such use of these algorithms, coding
+//   logic or concepts in whole or in part carry no covenant of correctness
+//   or recommended usage from the AUTHOR or any of the possible
+//   contributors listed or unlisted, known or unknown.
+//
+//	 Redistribution and use in source and binary forms, with or without
+//	 modification, are permitted provided that the following conditions are met: 
+//
+//	 1. Redistributions of source code must retain the below copyright notice, 
+//	 this list of conditions and the following disclaimer. 
+//	 2. Redistributions in binary form must reproduce the below copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution. 
+//
+//   The public sharing of this code does not relinquish, reduce, restrict or
+//   encumber any rights the AUTHOR has in respect to claims of intellectual
+//   property.
+//
+//   IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY
+//   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+//   OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+//   STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//   ANY WAY OUT OF THE USE OF THIS SOFTWARE, CODE, OR CODE FRAGMENT(S), EVEN
+//   IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//   -------------------------------------------------------------------------
+//
+//                             ALL RIGHTS RESERVED
+//
+//   -------------------------------------------------------------------------
+//
+//   Author:	Mark Tompkins
+//
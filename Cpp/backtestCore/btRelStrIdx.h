@@ -0,0 +1,32 @@
+// btRelStrIdx.h
+//
+// MEX-free core of relStrIdx (Relative Strength Index).
+// Description available: http://en.wikipedia.org/wiki/Relative_strength_index
+//
+// Formula: RSI = 100 - 100 / (1 + RS) where
+//
+//		RS[<N]	=	NaN
+//		RS[N]	=	Avg Gain / Avg Loss
+//		RS[>N]	=	(((Avg Gain[-1]*(N-1)) + Avg Gain[0]) / N)
+//				------------------------------------------
+//				(((Avg Loss[-1]*(N-1)) + Avg Loss[0]) / N)
+//
+// All state is local to the call so it may be run concurrently from many threads.
+
+#ifndef BTRELSTRIDX_H
+#define BTRELSTRIDX_H
+
+#include "btSpan.h"
+
+namespace openAlgo
+{
+	// Inputs:
+	//		price		A 1-D array of prices
+	//		lookback	The lookback period N (1 <= N <= number of observations)
+	//		rsi		Caller owned output the same length as 'price'
+	//
+	// Throws btError on an invalid lookback or mismatched lengths.
+	void relStrIdx(span<const double> price, int lookback, span<double> rsi);
+}
+
+#endif // BTRELSTRIDX_H
@@ -0,0 +1,32 @@
+// btSeries.h
+//
+// Column views of an Open | High | Low | Close price matrix shared by the backtest core.
+// A MatLab N x 4 array maps to four spans offset by N.  Functions that only need
+// Open | Close may leave High and Low empty.
+//
+// The element type is a template parameter so single precision data can be viewed without a
+// copy.  'ohlcSeries' is the double precision view used throughout the core.
+
+#ifndef BTSERIES_H
+#define BTSERIES_H
+
+#include "btSpan.h"
+
+namespace openAlgo
+{
+	template <typename T>
+	struct basicOhlcSeries
+	{
+		span<const T> open;
+		span<const T> high;
+		span<const T> low;
+		span<const T> close;
+
+		size_t size() const { return open.size(); }
+	};
+
+	typedef basicOhlcSeries<double> ohlcSeries;
+	typedef basicOhlcSeries<float> ohlcSeriesF;
+}
+
+#endif // BTSERIES_H
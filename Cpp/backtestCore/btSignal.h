@@ -0,0 +1,31 @@
+// btSignal.h
+//
+// Helpers shared by the backtest core for interpreting signal values.
+
+#ifndef BTSIGNAL_H
+#define BTSIGNAL_H
+
+#include <cmath>
+
+namespace openAlgo
+{
+	// Return true if the signal generates a position (|signal| >= 1)
+	inline bool isTrade(double isSig)
+	{
+		return std::abs(isSig) >= 1;
+	}
+
+	// We can check for known advanced signals to help in debugging
+	// by registering them here.  This can be a searchable array when
+	// more than one advanced signal exists.
+	// For now we only need to check for |0.5|
+	inline bool knownAdvSig(double advSig)
+	{
+		double frac = std::abs(advSig - int(advSig));
+
+		// Close any opposing open position
+		return frac == 0.5;
+	}
+}
+
+#endif // BTSIGNAL_H
@@ -0,0 +1,53 @@
+// btSpan.h
+//
+// A minimal non-owning view over a contiguous array.
+// C++17 does not provide std::span so the backtest core carries its own.  Only the members
+// the core needs are implemented.  Any front-end (MEX, CLI, C ABI) can wrap its buffers
+// without copying: e.g. an N x 4 mxArray is four spans offset by N.
+
+#ifndef BTSPAN_H
+#define BTSPAN_H
+
+#include <cstddef>
+#include <vector>
+
+namespace openAlgo
+{
+	template <typename T>
+	class span
+	{
+	public:
+		typedef T element_type;
+		typedef T* iterator;
+
+		span() : m_data(nullptr), m_size(0) {}
+		span(T *data, size_t size) : m_data(data), m_size(size) {}
+
+		// Allow a mutable vector to be viewed as a const or mutable span
+		template <typename U>
+		span(std::vector<U> &v) : m_data(v.data()), m_size(v.size()) {}
+		template <typename U>
+		span(const std::vector<U> &v) : m_data(v.data()), m_size(v.size()) {}
+
+		// span<T> --> span<const T>
+		template <typename U>
+		span(const span<U> &other) : m_data(other.data()), m_size(other.size()) {}
+
+		T *data() const { return m_data; }
+		size_t size() const { return m_size; }
+		bool empty() const { return m_size == 0; }
+
+		T &operator[](size_t idx) const { return m_data[idx]; }
+
+		iterator begin() const { return m_data; }
+		iterator end() const { return m_data + m_size; }
+
+		span subspan(size_t offset, size_t count) const { return span(m_data + offset, count); }
+
+	private:
+		T *m_data;
+		size_t m_size;
+	};
+}
+
+#endif // BTSPAN_H
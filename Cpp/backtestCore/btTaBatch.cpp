@@ -0,0 +1,260 @@
+// btTaBatch.cpp
+//
+// TA-Lib compatible indicators for a vector of periods.  See btTaBatch.h for the interface and
+// Matlab/MEX/Cpp/taInvoke/taInvoke.cpp for the MatLab gateway.
+
+#include "btTaBatch.h"
+#include "btParallel.h"
+#include "btError.h"
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+namespace openAlgo
+{
+	// TA-Lib's TA_IS_ZERO and TA_IS_ZERO_OR_NEG
+	static inline bool taIsZero(double v) { return -1e-8 < v && v < 1e-8; }
+	static inline bool taIsZeroOrNeg(double v) { return v < 1e-8; }
+
+	static void checkBatch(const char *func, size_t rows, span<const int> periods, int minPeriod, span<double> out)
+	{
+		if (periods.empty())
+			throw btError(string("MATLAB:") + func + ":BadPeriod", "At least one period is required. Aborting.");
+
+		for (size_t kk = 0; kk < periods.size(); kk++)
+		{
+			if (periods[kk] < minPeriod || periods[kk] > 100000)
+				throw btError(string("MATLAB:") + func + ":BadPeriod",
+				"Period " + to_string(periods[kk]) + " is outside [" + to_string(minPeriod) + ", 100000]. Aborting.");
+		}
+
+		if (out.size() != rows * periods.size())
+			throw btError(string("MATLAB:") + func + ":ArrayMismatch",
+			"The output array must have one column of the input length per period. Aborting.");
+	}
+
+	// Column 'col' of 'out' with NaN up to the lookback.  Returns the first observation to compute.
+	static size_t nanPrefix(span<double> out, size_t rows, size_t col, size_t lookback)
+	{
+		double *colOut = out.data() + col * rows;
+		size_t nanRows = min(lookback, rows);
+
+		fill_n(colOut, nanRows, numeric_limits<double>::quiet_NaN());
+		return nanRows;
+	}
+
+	void sumBatch(span<const double> data, span<const int> periods, bool average, span<double> out, unsigned threads)
+	{
+		const size_t rows = data.size();
+
+		checkBatch("sumBatch", rows, periods, 2, out);
+
+		// TA_SUM | TA_SMA's running window total, so each column matches its single period call
+		parallelFor(periods.size(), threads, [&](size_t col)
+		{
+			const size_t period = size_t(periods[col]);
+			double *colOut = out.data() + col * rows;
+
+			size_t ii = nanPrefix(out, rows, col, period - 1);
+			if (ii >= rows)
+				return;
+
+			double periodTotal = 0;
+			for (size_t jj = ii + 1 - period; jj < ii; jj++)
+				periodTotal += data[jj];
+
+			for (size_t trailing = ii + 1 - period; ii < rows; ii++, trailing++)
+			{
+				periodTotal += data[ii];
+				colOut[ii] = average ? periodTotal / double(period) : periodTotal;
+				periodTotal -= data[trailing];
+			}
+		});
+	}
+
+	void varBatch(span<const double> data, span<const int> periods, bool stdDev, double numDev, span<double> out,
+		unsigned threads)
+	{
+		const size_t rows = data.size();
+
+		checkBatch(stdDev ? "stdDevBatch" : "varBatch", rows, periods, stdDev ? 2 : 1, out);
+
+		// The squares are shared by every column
+		vector<double> squares(rows);
+		for (size_t ii = 0; ii < rows; ii++)
+			squares[ii] = data[ii] * data[ii];
+
+		// TA_VAR's running window totals.  Sums over the whole series would leave meanSq - mean^2 to
+		// cancel catastrophically once prices drift.
+		parallelFor(periods.size(), threads, [&](size_t col)
+		{
+			const size_t period = size_t(periods[col]);
+			double *colOut = out.data() + col * rows;
+
+			size_t ii = nanPrefix(out, rows, col, period - 1);
+			if (ii >= rows)
+				return;
+
+			double periodTotal1 = 0, periodTotal2 = 0;
+			for (size_t jj = ii + 1 - period; jj < ii; jj++)
+			{
+				periodTotal1 += data[jj];
+				periodTotal2 += squares[jj];
+			}
+
+			for (size_t trailing = ii + 1 - period; ii < rows; ii++, trailing++)
+			{
+				periodTotal1 += data[ii];
+				periodTotal2 += squares[ii];
+
+				double mean = periodTotal1 / double(period);
+				double var = periodTotal2 / double(period) - mean * mean;
+
+				periodTotal1 -= data[trailing];
+				periodTotal2 -= squares[trailing];
+
+				if (!stdDev)
+					colOut[ii] = var;
+				else
+					colOut[ii] = taIsZeroOrNeg(var) ? 0.0 : sqrt(var) * numDev;
+			}
+		});
+	}
+
+	void trueRange(span<const double> high, span<const double> low, span<const double> close, span<double> tr)
+	{
+		const size_t rows = close.size();
+
+		if (high.size() != rows || low.size() != rows || tr.size() != rows)
+			throw btError("MATLAB:trueRange:ArrayMismatch",
+			"The High, Low, Close and output arrays must be the same length. Aborting.");
+
+		if (rows == 0)
+			return;
+
+		tr[0] = numeric_limits<double>::quiet_NaN();
+
+		for (size_t ii = 1; ii < rows; ii++)
+		{
+			double greatest = high[ii] - low[ii];
+			double upper = fabs(high[ii] - close[ii - 1]);
+			double lower = fabs(low[ii] - close[ii - 1]);
+
+			if (upper > greatest)
+				greatest = upper;
+			if (lower > greatest)
+				greatest = lower;
+
+			tr[ii] = greatest;
+		}
+	}
+
+	void atrBatch(span<const double> high, span<const double> low, span<const double> close, span<const int> periods,
+		bool normalized, span<double> out, unsigned threads)
+	{
+		const size_t rows = close.size();
+		const char *func = normalized ? "natrBatch" : "atrBatch";
+
+		if (high.size() != rows || low.size() != rows)
+			throw btError(string("MATLAB:") + func + ":ArrayMismatch",
+			"The High, Low and Close arrays must be the same length. Aborting.");
+
+		checkBatch(func, rows, periods, 2, out);
+
+		vector<double> tr(rows);
+		trueRange(high, low, close, tr);
+
+		// Wilder smoothing seeded with the mean of the first 'period' true ranges.  The operations
+		// and their order are TA-Lib's so the columns match TA_ATR | TA_NATR exactly.
+		parallelFor(periods.size(), threads, [&](size_t col)
+		{
+			const size_t period = size_t(periods[col]);
+			double *colOut = out.data() + col * rows;
+
+			size_t ii = nanPrefix(out, rows, col, period);
+			if (ii >= rows)
+				return;
+
+			double prevATR = 0;
+			for (size_t jj = 1; jj <= period; jj++)
+				prevATR += tr[jj];
+			prevATR /= double(period);
+
+			for (;;)
+			{
+				if (!normalized)
+					colOut[ii] = prevATR;
+				else
+					colOut[ii] = taIsZero(close[ii]) ? 0.0 : (prevATR / close[ii]) * 100.0;
+
+				if (++ii >= rows)
+					break;
+
+				prevATR *= double(period - 1);
+				prevATR += tr[ii];
+				prevATR /= double(period);
+			}
+		});
+	}
+}
+
+//
+//  -------------------------------------------------------------------------
+//                                  _    _ 
+//         ___  _ __   ___ _ __    / \  | | __ _  ___   ___  _ __ __ _ 
+//        / _ \| '_ \ / _ \ '_ \  / _ \ | |/ _` |/ _ \ / _ \| '__/ _` |
+//       | (_) | |_) |  __/ | | |/ ___ \| | (_| | (_) | (_) | | | (_| |
+//        \___/| .__/ \___|_| |_/_/   \_\_|\__, |\___(_)___/|_|  \__, |
+//             |_|                         |___/                 |___/
+//  -------------------------------------------------------------------------
+//        This code is distributed in the hope that it will be useful,
+//
+//                         WITHOUT ANY WARRANTY AND
+//
+//                  WITHOUT CLAIM AS TO MERCHANTABILITY
+//
+//                  OR FITNESS FOR A PARTICULAR PURPOSE
+//
+//                           EXPRESSED OR IMPLIED.
+//
+//   Use of this code, pseudocode, algorithmic or trading logic contained
+//   herein, whether sound or faulty for any purpose is the sole
+//   responsibility of the USER. Any such use of these algorithms, coding
+//   logic or concepts in whole or in part carry no covenant of correctness
+//   or recommended usage from the AUTHOR or any of the possible
+//   contributors listed or unlisted, known or unknown.
+//
+//	 Redistribution and use in source and binary forms, with or without
+//	 modification, are permitted provided that the following conditions are met: 
+//
+//	 1. Redistributions of source code must retain the below copyright notice, 
+//	 this list of conditions and the following disclaimer. 
+//	 2. Redistributions in binary form must reproduce the below copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution. 
+//
+//   The public sharing of this code does not relinquish, reduce, restrict or
+//   encumber any rights the AUTHOR has in respect to claims of intellectual
+//   property.
+//
+//   IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY
+//   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+//   OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+//   STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//   ANY WAY OUT OF THE USE OF THIS SOFTWARE, CODE, OR CODE FRAGMENT(S), EVEN
+//   IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//   -------------------------------------------------------------------------
+//
+//                             ALL RIGHTS RESERVED
+//
+//   -------------------------------------------------------------------------
+//
+//   Author:	Mark Tompkins
+//
@@ -0,0 +1,43 @@
+// btTaBatch.h
+//
+// TA-Lib compatible indicators for a vector of periods in one call.  Work that does not depend on
+// the period is done once and shared by every column:
+//
+//		VAR | STDDEV		The squares of the observations
+//		ATR | NATR		One true range series
+//
+// Output layout:
+//		'out' is rows x periods.size(), column major.  Column k holds periods[k] and the
+//		observations before its TA-Lib lookback are NaN, as taInvoke returns them.
+//
+// Numerics:
+//		Every column repeats TA-Lib's operations in its order (running window totals for
+//		SUM | SMA | VAR | STDDEV, Wilder smoothing for ATR | NATR) so it matches the single period
+//		TA-Lib call exactly.
+//
+// Columns are computed concurrently on up to 'threads' workers (0 = one per hardware thread).
+// All state is local to the call.
+
+#ifndef BTTABATCH_H
+#define BTTABATCH_H
+
+#include "btSpan.h"
+
+namespace openAlgo
+{
+	// TA_SUM (average = false) or TA_SMA (average = true).  Periods >= 2.
+	void sumBatch(span<const double> data, span<const int> periods, bool average, span<double> out, unsigned threads = 0);
+
+	// TA_VAR (periods >= 1) or, with stdDev, TA_STDDEV scaled by 'numDev' (periods >= 2)
+	void varBatch(span<const double> data, span<const int> periods, bool stdDev, double numDev, span<double> out,
+		unsigned threads = 0);
+
+	// TA_TRANGE.  'tr' is the length of the inputs and tr[0] is NaN.
+	void trueRange(span<const double> high, span<const double> low, span<const double> close, span<double> tr);
+
+	// TA_ATR (normalized = false) or TA_NATR (normalized = true).  Periods >= 2.
+	void atrBatch(span<const double> high, span<const double> low, span<const double> close, span<const int> periods,
+		bool normalized, span<double> out, unsigned threads = 0);
+}
+
+#endif // BTTABATCH_H
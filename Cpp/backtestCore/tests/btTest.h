@@ -0,0 +1,51 @@
+// btTest.h
+//
+// Minimal assertion helpers for the backtest core unit tests.  Each test executable
+// returns non-zero if any check failed so it can be registered directly with CTest.
+
+#ifndef BTTEST_H
+#define BTTEST_H
+
+#include <cmath>
+#include <cstdio>
+
+static int btTestFailures = 0;
+
+#define BT_CHECK(cond) \
+	do { if (!(cond)) { btTestFailures++; fprintf(stderr, "%s(%d): CHECK failed: %s\n", __FILE__, __LINE__, #cond); } } while (0)
+
+#define BT_CHECK_NEAR(a, b, tol) \
+	do { double _a = (a), _b = (b); if (!(std::fabs(_a - _b) <= (tol))) { btTestFailures++; \
+		fprintf(stderr, "%s(%d): CHECK_NEAR failed: %s = %.17g, %s = %.17g\n", __FILE__, __LINE__, #a, _a, #b, _b); } } while (0)
+
+#define BT_CHECK_THROWS(expr, type) \
+	do { bool _thrown = false; try { expr; } catch (const type &) { _thrown = true; } \
+		if (!_thrown) { btTestFailures++; fprintf(stderr, "%s(%d): expected %s from %s\n", __FILE__, __LINE__, #type, #expr); } } while (0)
+
+// Compare two arrays element by element
+template <typename A, typename B>
+static void btCheckArray(const A &actual, const B &expected, size_t n, double tol, const char *name, int line)
+{
+	for (size_t ii = 0; ii < n; ii++)
+	{
+		if (!(std::fabs(double(actual[ii]) - double(expected[ii])) <= tol))
+		{
+			btTestFailures++;
+			fprintf(stderr, "%s(%d): %s[%zu] = %.17g expected %.17g\n", __FILE__, line, name, ii, double(actual[ii]), double(expected[ii]));
+			return;
+		}
+	}
+}
+
+#define BT_CHECK_ARRAY(actual, expected, n, tol) btCheckArray(actual, expected, n, tol, #actual, __LINE__)
+
+static int btTestResult(const char *suite)
+{
+	if (btTestFailures == 0)
+		printf("%s: all checks passed\n", suite);
+	else
+		printf("%s: %d check(s) failed\n", suite, btTestFailures);
+	return btTestFailures == 0 ? 0 : 1;
+}
+
+#endif // BTTEST_H
@@ -0,0 +1,121 @@
+// testConcurrency.cpp
+//
+// Runs many numTicksProfit and relStrIdx evaluations concurrently, each with different
+// parameters, and checks every result against the same evaluation run serially.  Any shared
+// state between calls shows up as a mismatch.
+
+#include "btNumTicksProfit.h"
+#include "btRelStrIdx.h"
+#include "btParallel.h"
+#include "btTest.h"
+#include <cmath>
+#include <vector>
+
+using namespace std;
+using namespace openAlgo;
+
+static const size_t ROWS = 2000;
+static const size_t EVALS = 64;
+
+struct marketData
+{
+	vector<double> open, high, low, close;
+	vector<vector<double> > sigs;
+};
+
+static marketData makeData()
+{
+	marketData data;
+	data.open.resize(ROWS);
+	data.high.resize(ROWS);
+	data.low.resize(ROWS);
+	data.close.resize(ROWS);
+
+	double px = 1500;
+	for (size_t ii = 0; ii < ROWS; ii++)
+	{
+		px += 2 * sin(ii * 0.13) + cos(ii * 0.71);
+		data.open[ii] = px;
+		data.high[ii] = px + 1.5 + fabs(sin(ii * 0.37)) * 3;
+		data.low[ii] = px - 1.5 - fabs(cos(ii * 0.29)) * 3;
+		data.close[ii] = px + sin(ii * 0.53);
+	}
+
+	// A different reversing signal per evaluation
+	data.sigs.resize(EVALS);
+	for (size_t ee = 0; ee < EVALS; ee++)
+	{
+		data.sigs[ee].assign(ROWS, 0);
+		size_t period = 5 + ee % 17;
+		for (size_t ii = ee % 3; ii < ROWS; ii += period)
+			data.sigs[ee][ii] = ((ii / period) % 2) ? 1.5 : -1.5;
+	}
+
+	return data;
+}
+
+static ntpResult runNtp(const marketData &data, size_t ee)
+{
+	ohlcSeries series;
+	series.open = data.open;
+	series.high = data.high;
+	series.low = data.low;
+	series.close = data.close;
+
+	// Parameters differ per evaluation so leaked state would change results
+	return numTicksProfit(series, data.sigs[ee], 0.25, double(4 + ee % 9), int(ee % 2));
+}
+
+static vector<double> runRsi(const marketData &data, size_t ee)
+{
+	vector<double> rsi(ROWS);
+	relStrIdx(data.close, int(2 + ee % 30), rsi);
+	return rsi;
+}
+
+int main()
+{
+	marketData data = makeData();
+
+	vector<ntpResult> serialNtp(EVALS), parallelNtp(EVALS);
+	vector<vector<double> > serialRsi(EVALS), parallelRsi(EVALS);
+
+	for (size_t ee = 0; ee < EVALS; ee++)
+	{
+		serialNtp[ee] = runNtp(data, ee);
+		serialRsi[ee] = runRsi(data, ee);
+	}
+
+	parallelFor(EVALS, 8, [&](size_t ee)
+	{
+		parallelNtp[ee] = runNtp(data, ee);
+		parallelRsi[ee] = runRsi(data, ee);
+	});
+
+	for (size_t ee = 0; ee < EVALS; ee++)
+	{
+		BT_CHECK(serialNtp[ee].modified);
+		BT_CHECK(parallelNtp[ee].modified == serialNtp[ee].modified);
+		BT_CHECK(parallelNtp[ee].rows == serialNtp[ee].rows);
+		BT_CHECK(parallelNtp[ee].sig == serialNtp[ee].sig);
+		BT_CHECK(parallelNtp[ee].bars == serialNtp[ee].bars);
+
+		for (size_t ii = 0; ii < ROWS; ii++)
+		{
+			bool same = (serialRsi[ee][ii] == parallelRsi[ee][ii]) ||
+				(std::isnan(serialRsi[ee][ii]) && std::isnan(parallelRsi[ee][ii]));
+			BT_CHECK(same);
+		}
+	}
+
+	// Sanity check of the RSI core: a steadily rising series is 100 after the lookback
+	vector<double> rising(20), rsi(20);
+	for (size_t ii = 0; ii < rising.size(); ii++)
+		rising[ii] = double(ii);
+	relStrIdx(rising, 5, rsi);
+	BT_CHECK(std::isnan(rsi[4]));
+	BT_CHECK_NEAR(rsi[5], 100, 0);
+	BT_CHECK_NEAR(rsi[19], 100, 0);
+
+	return btTestResult("testConcurrency");
+}
@@ -0,0 +1,238 @@
+// testExits.cpp
+//
+// Unit tests for the exit engine.
+
+#include "btExits.h"
+#include "btError.h"
+#include "btTest.h"
+#include <vector>
+
+using namespace std;
+using namespace openAlgo;
+
+// Column storage for Open | High | Low | Close test data
+struct testBars
+{
+	vector<double> open, high, low, close;
+
+	ohlcSeries series() const
+	{
+		ohlcSeries s;
+		s.open = open;
+		s.high = high;
+		s.low = low;
+		s.close = close;
+		return s;
+	}
+};
+
+static exitParams params(unsigned kinds)
+{
+	exitParams p;
+	p.kinds = kinds;
+	p.minTick = 1;
+	p.targetTicks = 2;
+	p.stopTicks = 2;
+	return p;
+}
+
+// A fixed stop inside the range of the entry observation
+static void testStop()
+{
+	testBars bars;
+	bars.open = { 10, 10, 10, 10 };
+	bars.high = { 10, 11, 10, 10 };
+	bars.low = { 10, 7, 10, 10 };
+	bars.close = { 10, 9, 10, 10 };
+	vector<double> sig = { 1, 0, 0, 0 };
+
+	ntpResult res = exitEngine(bars.series(), sig, params(exitStop));
+	BT_CHECK(res.modified && res.rows == 5);
+
+	double sigOut[] = { 1, -1, 0, 0, 0 };
+	double openOut[] = { 10, 10, 8, 10, 10 };
+	double barIndex[] = { 0, 1, 1, 2, 3 };
+	BT_CHECK_ARRAY(res.sig, sigOut, 5, 0);
+	BT_CHECK_ARRAY(res.bars, openOut, 5, 0);
+	BT_CHECK_ARRAY(res.barIndex, barIndex, 5, 0);
+
+	// The stop is assumed first when the target is also inside the range
+	bars.high[1] = 13;
+	res = exitEngine(bars.series(), sig, params(exitStop | exitTarget));
+	BT_CHECK_ARRAY(res.bars, openOut, 5, 0);
+
+	// The same stop from a volatility of 1 and a multiple of 2
+	vector<double> vol(4, 1);
+	exitParams vp = params(exitVolStop);
+	vp.vol = vol;
+	vp.volMult = 2;
+	res = exitEngine(bars.series(), sig, vp);
+	BT_CHECK_ARRAY(res.bars, openOut, 5, 0);
+}
+
+// A short stop and a long position gapping through its stop on the Open
+static void testGapAndShort()
+{
+	testBars bars;
+	bars.open = { 10, 10, 6, 6 };
+	bars.high = { 10, 11, 7, 6 };
+	bars.low = { 10, 9, 5, 6 };
+	bars.close = { 10, 10, 6, 6 };
+	vector<double> sig = { 1, 0, 0, 0 };
+
+	ntpResult res = exitEngine(bars.series(), sig, params(exitStop));
+	double sigOut[] = { 1, 0, -1, 0, 0 };
+	double openOut[] = { 10, 10, 6, 6, 6 };
+	BT_CHECK_ARRAY(res.sig, sigOut, 5, 0);
+	BT_CHECK_ARRAY(res.bars, openOut, 5, 0);
+
+	bars.high[1] = 12.5;
+	sig[0] = -1;
+	res = exitEngine(bars.series(), sig, params(exitStop));
+	double shortSig[] = { -1, 1, 0, 0, 0 };
+	double shortOpen[] = { 10, 10, 12, 6, 6 };
+	BT_CHECK_ARRAY(res.sig, shortSig, 5, 0);
+	BT_CHECK_ARRAY(res.bars, shortOpen, 5, 0);
+}
+
+// An Open gapping through the target fills at the Open even when the range later reaches the stop
+static void testGapThroughTarget()
+{
+	testBars bars;
+	bars.open = { 100, 100, 110, 110 };
+	bars.high = { 100, 101, 111, 110 };
+	bars.low = { 100, 99, 90, 110 };
+	bars.close = { 100, 100, 100, 110 };
+	vector<double> sig = { 1, 0, 0, 0 };
+
+	exitParams p = params(exitStop | exitTarget);
+	p.targetTicks = 4;
+	p.stopTicks = 4;
+
+	ntpResult res = exitEngine(bars.series(), sig, p);
+	double sigOut[] = { 1, 0, -1, 0, 0 };
+	double openOut[] = { 100, 100, 110, 110, 110 };
+	BT_CHECK_ARRAY(res.sig, sigOut, 5, 0);
+	BT_CHECK_ARRAY(res.bars, openOut, 5, 0);
+}
+
+// Trailing, break-even and maximum bars exits
+static void testTrailingBreakEvenMaxBars()
+{
+	testBars bars;
+	bars.open = { 10, 10, 13, 13 };
+	bars.high = { 10, 14, 13, 13 };
+	bars.low = { 10, 10, 11, 13 };
+	bars.close = { 10, 13, 12, 13 };
+	vector<double> sig = { 1, 0, 0, 0 };
+
+	exitParams trail = params(exitTrailing);
+	trail.trailTicks = 2;
+	ntpResult res = exitEngine(bars.series(), sig, trail);
+	double trailOpen[] = { 10, 10, 13, 12, 13 };
+	BT_CHECK_ARRAY(res.bars, trailOpen, 5, 0);
+
+	bars.open = { 10, 10, 12, 12 };
+	bars.high = { 10, 13.5, 12, 12 };
+	bars.low = { 10, 9, 9.5, 12 };
+	bars.close = { 10, 12, 11, 12 };
+	exitParams be = params(exitBreakEven | exitStop);
+	be.stopTicks = 5;
+	be.breakEvenTicks = 3;
+	res = exitEngine(bars.series(), sig, be);
+	double beOpen[] = { 10, 10, 12, 10, 12 };
+	BT_CHECK_ARRAY(res.bars, beOpen, 5, 0);
+
+	exitParams mb = params(exitMaxBars);
+	mb.maxBars = 2;
+	res = exitEngine(bars.series(), sig, mb);
+	double mbSig[] = { 1, 0, -1, 0, 0 };
+	double mbOpen[] = { 10, 10, 12, 11, 12 };
+	BT_CHECK_ARRAY(res.sig, mbSig, 5, 0);
+	BT_CHECK_ARRAY(res.bars, mbOpen, 5, 0);
+}
+
+// A finer series decides a bar in which both the stop and the target were reached
+static void testIntrabar()
+{
+	testBars bars;
+	bars.open = { 10, 10, 10, 10 };
+	bars.high = { 10, 13, 10, 10 };
+	bars.low = { 10, 7, 10, 10 };
+	bars.close = { 10, 9, 10, 10 };
+	vector<double> sig = { 1, 0, 0, 0 };
+
+	vector<double> barTimes = { 1, 2, 3, 4 };
+	vector<double> subTimes = { 1, 1.3, 1.6, 2, 2.5, 3, 4 };
+	vector<size_t> subIndex = subBarIndex(barTimes, subTimes);
+	size_t expectedIndex[] = { 0, 1, 4, 6, 7 };
+	BT_CHECK(subIndex.size() == 5);
+	BT_CHECK_ARRAY(subIndex, expectedIndex, 5, 0);
+
+	// Observation 1 runs up through the target before falling through the stop
+	testBars sub;
+	sub.open = { 10, 10, 12.5, 11, 10, 10, 10 };
+	sub.high = { 10, 12.5, 13, 11, 10, 10, 10 };
+	sub.low = { 10, 9.5, 11, 7, 10, 10, 10 };
+	sub.close = { 10, 12.5, 11, 9, 10, 10, 10 };
+
+	exitParams p = params(exitStop | exitTarget);
+	p.subBars = sub.series();
+	p.subIndex = subIndex;
+	ntpResult res = exitEngine(bars.series(), sig, p);
+	double targetFirst[] = { 10, 10, 12, 10, 10 };
+	BT_CHECK_ARRAY(res.bars, targetFirst, 5, 0);
+
+	// The second sub-bar gaps through the target on its Open
+	sub.open[2] = 12.75;
+	res = exitEngine(bars.series(), sig, p);
+	BT_CHECK_NEAR(res.bars[2], 12, 0);
+	sub.high[1] = 11;
+	res = exitEngine(bars.series(), sig, p);
+	BT_CHECK_NEAR(res.bars[2], 12.75, 0);
+
+	// A sub-bar reaching both is still taken stop first
+	sub.low[1] = 7.5;
+	res = exitEngine(bars.series(), sig, p);
+	BT_CHECK_NEAR(res.bars[2], 8, 0);
+
+	// A sub-bar that opens beyond the target fills at its Open even though it then falls through the stop
+	sub.open[1] = 12.5;
+	sub.high[1] = 12.5;
+	res = exitEngine(bars.series(), sig, p);
+	BT_CHECK_NEAR(res.bars[2], 12.5, 0);
+
+	subIndex.pop_back();
+	p.subIndex = subIndex;
+	BT_CHECK_THROWS(exitEngine(bars.series(), sig, p), btError);
+}
+
+static void testUnchanged()
+{
+	testBars bars;
+	bars.open = { 10, 10, 10 };
+	bars.high = { 10, 20, 20 };
+	bars.low = { 10, 1, 1 };
+	bars.close = { 10, 10, 10 };
+	vector<double> sig = { 1.5, 0, 0 };
+
+	BT_CHECK(!exitEngine(bars.series(), sig, params(0)).modified);
+
+	exitParams bad = params(exitStop);
+	bad.stopTicks = 0;
+	BT_CHECK_THROWS(exitEngine(bars.series(), sig, bad), btError);
+	BT_CHECK_THROWS(exitEngine(bars.series(), sig, params(exitAll + 1)), btError);
+	BT_CHECK_THROWS(exitEngine(bars.series(), sig, params(exitVolStop)), btError);
+}
+
+int main()
+{
+	testStop();
+	testGapAndShort();
+	testGapThroughTarget();
+	testTrailingBreakEvenMaxBars();
+	testIntrabar();
+	testUnchanged();
+
+	return btTestResult("testExits");
+}
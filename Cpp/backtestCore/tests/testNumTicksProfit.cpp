@@ -0,0 +1,456 @@
+// testNumTicksProfit.cpp
+//
+// Unit tests for the numTicksProfit core.
+
+#include "btNumTicksProfit.h"
+#include "btProfitLoss.h"
+#include "btCross.h"
+#include "btError.h"
+#include "btTest.h"
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+using namespace openAlgo;
+
+// Column storage for Open | High | Low | Close test data
+struct testBars
+{
+	vector<double> open, high, low, close;
+
+	ohlcSeries series() const
+	{
+		ohlcSeries s;
+		s.open = open;
+		s.high = high;
+		s.low = low;
+		s.close = close;
+		return s;
+	}
+};
+
+// A long position reaches its objective on the High of a later bar
+static void testLongProfitOnHigh()
+{
+	testBars bars;
+	bars.open = { 10, 10, 10, 11, 12 };
+	bars.high = { 10, 11, 11, 13, 12 };
+	bars.low = { 10, 9, 9, 10, 12 };
+	bars.close = { 10, 10, 10, 12, 12 };
+	vector<double> sig = { 1.5, 0, 0, 0, 0 };
+
+	ntpResult res = numTicksProfit(bars.series(), sig, 1, 2, 0);
+
+	BT_CHECK(res.modified);
+	BT_CHECK(res.rows == 6);
+
+	double sigOut[] = { 1.5, 0, 0, -1, 0, 0 };
+	double barsOut[] = { 10, 10, 10, 11, 12, 12,
+		10, 11, 11, 13, 12, 12,
+		10, 9, 9, 10, 12, 12,
+		10, 10, 10, 12, 12, 12 };
+	BT_CHECK_ARRAY(res.sig, sigOut, 6, 0);
+	BT_CHECK_ARRAY(res.bars, barsOut, 24, 0);
+
+	// The virtual bar belongs to the observation whose High reached the objective
+	double barIndex[] = { 0, 1, 2, 3, 3, 4 };
+	BT_CHECK_ARRAY(res.barIndex, barIndex, 6, 0);
+
+	// The virtual bar books the profit in calcProfitLoss
+	size_t rows = res.rows;
+	vector<double> cash(rows), openEQ(rows), netLiq(rows), returns(rows);
+	plOutputs out;
+	out.cash = cash;
+	out.openEQ = openEQ;
+	out.netLiq = netLiq;
+	out.returns = returns;
+	calcProfitLoss(span<const double>(res.bars.data(), rows), span<const double>(res.bars.data() + 3 * rows, rows),
+		res.sig, 1, 0, out);
+	double netLiqOut[] = { 0, 0, 0, 2, 2, 2 };
+	BT_CHECK_ARRAY(netLiq, netLiqOut, 6, 0);
+}
+
+// A short position reaches its objective on the bar it was opened
+static void testShortSameBar()
+{
+	testBars bars;
+	bars.open = { 10, 10, 9, 9 };
+	bars.high = { 10, 11, 9, 9 };
+	bars.low = { 10, 7, 9, 9 };
+	bars.close = { 10, 8, 9, 9 };
+	vector<double> sig = { -1.5, 0, 0, 0 };
+
+	ntpResult res = numTicksProfit(bars.series(), sig, 1, 2, 0);
+
+	BT_CHECK(res.modified);
+	double sigOut[] = { -1.5, 1, 0, 0, 0 };
+	double openOut[] = { 10, 10, 8, 9, 9 };
+	BT_CHECK_ARRAY(res.sig, sigOut, 5, 0);
+	BT_CHECK_ARRAY(res.bars, openOut, 5, 0);
+}
+
+// A long position gaps through its objective on the Open
+static void testGapOpen()
+{
+	testBars bars;
+	bars.open = { 10, 10, 13, 13 };
+	bars.high = { 10, 11, 14, 13 };
+	bars.low = { 10, 9, 13, 13 };
+	bars.close = { 10, 10, 13, 13 };
+	vector<double> sig = { 1, 0, 0, 0 };
+
+	ntpResult res = numTicksProfit(bars.series(), sig, 1, 2, 0);
+
+	BT_CHECK(res.modified);
+	double sigOut[] = { 1, 0, -1, 0, 0 };
+	double openOut[] = { 10, 10, 13, 13, 13 };
+	BT_CHECK_ARRAY(res.sig, sigOut, 5, 0);
+	BT_CHECK_ARRAY(res.bars, openOut, 5, 0);
+}
+
+// Averaging the open position takes a single combined profit
+static void testOpenAverage()
+{
+	testBars bars;
+	bars.open = { 10, 10, 11, 12, 12 };
+	bars.high = { 10, 11, 12, 14, 12 };
+	bars.low = { 10, 10, 11, 12, 12 };
+	bars.close = { 10, 11, 12, 13, 12 };
+	vector<double> sig = { 1, 1, 0, 0, 0 };
+
+	ntpResult res = numTicksProfit(bars.series(), sig, 1, 2, 1);
+
+	BT_CHECK(res.modified);
+	double sigOut[] = { 1, 1, 0, -2, 0, 0 };
+	double openOut[] = { 10, 10, 11, 12, 12.5, 12 };
+	BT_CHECK_ARRAY(res.sig, sigOut, 6, 0);
+	BT_CHECK_ARRAY(res.bars, openOut, 6, 0);
+}
+
+// Per contract lots are taken by profit price, not entry order, after a FIFO reduction
+static void testLotsByPrice()
+{
+	testBars bars;
+	bars.open = { 10, 10, 11, 10, 11, 12, 12 };
+	bars.high = { 10, 11, 11, 10, 12.5, 13.5, 12 };
+	bars.low = { 10, 10, 11, 10, 11, 12, 12 };
+	bars.close = { 10, 11, 11, 10, 12, 13, 12 };
+	vector<double> sig = { 1, 1, 1, -1, 0, 0, 0 };
+
+	ntpResult res = numTicksProfit(bars.series(), sig, 1, 2, 0);
+
+	BT_CHECK(res.modified && res.rows == 9);
+	double sigOut[] = { 1, 1, 1, -1, -1, 0, -1, 0, 0 };
+	double openOut[] = { 10, 10, 11, 10, 11, 12, 12, 13, 12 };
+	BT_CHECK_ARRAY(res.sig, sigOut, 9, 0);
+	BT_CHECK_ARRAY(res.bars, openOut, 9, 0);
+}
+
+// More than 64 open lots crossed on one bar.  Removing them compacts the ledger part way through.
+static void testManyLots()
+{
+	testBars bars;
+	vector<double> sig;
+	for (int ii = 0; ii < 81; ii++)
+	{
+		// The buy on observation 70 fills at 18.5 and stays open when the others reach 19
+		const double px = (ii == 71) ? 18.5 : 17;
+		bars.open.push_back(px);
+		bars.high.push_back(px);
+		bars.low.push_back(px);
+		bars.close.push_back(px);
+		sig.push_back(1);
+	}
+	const double tail[][5] = { { 20, 20, 20, 20, 1 }, { 15, 15, 15, 15, 1 }, { 15, 15, 15, 15, -2 }, { 15, 15, 15, 15, 0 },
+		{ 20, 21, 20, 20, 0 }, { 15, 15, 15, 15, 0 } };
+	for (size_t ii = 0; ii < 6; ii++)
+	{
+		bars.open.push_back(tail[ii][0]);
+		bars.high.push_back(tail[ii][1]);
+		bars.low.push_back(tail[ii][2]);
+		bars.close.push_back(tail[ii][3]);
+		sig.push_back(tail[ii][4]);
+	}
+
+	// The sale of 2 closes the lots at 18.5 and 20 (FIFO) so only the two at 15 remain for the High of 21
+	vector<ntpProfit> profits = numTicksProfitScan(bars.series(), sig, 1, 2, 0);
+
+	BT_CHECK(profits.size() == 2);
+	BT_CHECK(profits[0].barIndex == 80 && profits[0].qtyProfit == -79);
+	BT_CHECK_NEAR(profits[0].profitPrice, 20, 0);
+	BT_CHECK(profits[1].barIndex == 84 && profits[1].qtyProfit == -2);
+	BT_CHECK_NEAR(profits[1].profitPrice, 17, 0);
+}
+
+static void testUnchanged()
+{
+	testBars bars;
+	bars.open = { 10, 10, 10 };
+	bars.high = { 10, 20, 20 };
+	bars.low = { 10, 1, 1 };
+	bars.close = { 10, 10, 10 };
+	vector<double> sig = { 1.5, 0, 0 };
+	vector<double> none = { 0, 0, 0 };
+
+	BT_CHECK(!numTicksProfit(bars.series(), sig, 0, 2, 0).modified);
+	BT_CHECK(!numTicksProfit(bars.series(), none, 1, 2, 0).modified);
+	BT_CHECK_THROWS(numTicksProfit(bars.series(), sig, 1, 2, 3), btError);
+	BT_CHECK_THROWS(numTicksProfit(bars.series(), sig, -1, 2, 0), btError);
+}
+
+// Quarter point random walk with reverses, pyramids and partial exits
+static testBars randomBars(size_t rows, vector<double> &sig)
+{
+	testBars bars;
+	unsigned seed = 777;
+	double px = 2000;
+	const double signals[] = { 0, 0, 0, 0, 0, 1, -1, 2, 1.5, -1.5, 0.5 };
+
+	for (size_t ii = 0; ii < rows; ii++)
+	{
+		seed = seed * 1103515245u + 12345u;
+		px += 0.25 * (int((seed >> 16) % 9) - 4);
+		double up = 0.25 * ((seed >> 4) % 7);
+		double down = 0.25 * ((seed >> 8) % 7);
+		bars.open.push_back(px);
+		bars.high.push_back(px + up);
+		bars.low.push_back(px - down);
+		bars.close.push_back(px + 0.25 * (int((seed >> 12) % 5) - 2) * (up + down > 0 ? 0.5 : 0));
+		sig.push_back(signals[(seed >> 20) % 11]);
+	}
+	return bars;
+}
+
+// The fused kernel equals numTicksProfit followed by calcProfitLoss
+static void testFusedMatchesPipeline()
+{
+	const size_t rows = 3000;
+
+	for (int openAvg = 0; openAvg <= 1; openAvg++)
+	{
+		vector<double> sig;
+		testBars bars = randomBars(rows, sig);
+
+		ntpResult ntp = numTicksProfit(bars.series(), sig, 0.25, 4, openAvg);
+		BT_CHECK(ntp.modified);
+
+		const size_t vRows = ntp.rows;
+		span<const double> vOpen(ntp.bars.data(), vRows);
+		span<const double> vClose(ntp.bars.data() + 3 * vRows, vRows);
+		vector<double> cash(vRows), openEQ(vRows), netLiq(vRows), returns(vRows);
+		plOutputs out;
+		out.cash = cash;
+		out.openEQ = openEQ;
+		out.netLiq = netLiq;
+		out.returns = returns;
+		calcProfitLoss(vOpen, vClose, ntp.sig, 50, 2.5, out);
+		plStats expected = calcProfitLossStats(vOpen, vClose, ntp.sig, 50, 2.5);
+
+		// Statistics only.  Nothing is materialized.
+		plStats fused = numTicksProfitPL(bars.series(), sig, 0.25, 4, openAvg, 50, 2.5);
+		BT_CHECK(fused.bars == vRows);
+		BT_CHECK(fused.trades == expected.trades);
+		BT_CHECK_NEAR(fused.sharpe, expected.sharpe, 0);
+		BT_CHECK_NEAR(fused.maxDrawdown, expected.maxDrawdown, 0);
+		BT_CHECK_NEAR(fused.netLiq, netLiq[vRows - 1], 0);
+
+		// Per observation outputs and the materialized virtual bars
+		vector<double> fCash(rows), fOpenEQ(rows), fNetLiq(rows), fReturns(rows);
+		ntpResult fBars;
+		ntpPlOutputs fOut;
+		fOut.bars.cash = fCash;
+		fOut.bars.openEQ = fOpenEQ;
+		fOut.bars.netLiq = fNetLiq;
+		fOut.bars.returns = fReturns;
+		fOut.virtualBars = &fBars;
+		numTicksProfitPL(bars.series(), sig, 0.25, 4, openAvg, 50, 2.5, fOut);
+
+		BT_CHECK(fBars.modified && fBars.rows == vRows);
+		BT_CHECK(fBars.sig == ntp.sig);
+		BT_CHECK(fBars.bars == ntp.bars);
+		BT_CHECK(fBars.barIndex == ntp.barIndex);
+
+		vector<double> foldCash(rows, 0), foldNetLiq(rows, 0);
+		for (size_t row = 0; row < vRows; row++)
+		{
+			foldCash[ntp.barIndex[row]] += cash[row];
+			foldNetLiq[ntp.barIndex[row]] = netLiq[row];
+		}
+		// Average profit prices are not exact binary fractions so calcProfitLoss's vector prefix scan
+		// may round netLiq differently (see btPostPass.h)
+		BT_CHECK_ARRAY(fCash, foldCash, rows, 0);
+		BT_CHECK_ARRAY(fNetLiq, foldNetLiq, rows, 1e-8);
+		BT_CHECK_NEAR(fReturns[rows - 1], foldNetLiq[rows - 1] - foldNetLiq[rows - 2], 1e-8);
+	}
+}
+
+// Without profit taking the fused kernel is calcProfitLoss
+static void testFusedUnchanged()
+{
+	testBars bars;
+	bars.open = { 10, 10, 11, 12, 12 };
+	bars.high = { 10, 11, 12, 14, 12 };
+	bars.low = { 10, 10, 11, 12, 12 };
+	bars.close = { 10, 11, 12, 13, 12 };
+	vector<double> sig = { 1, 0, -1.5, 0, 0 };
+
+	vector<double> cash(5), openEQ(5), netLiq(5), returns(5);
+	plOutputs out;
+	out.cash = cash;
+	out.openEQ = openEQ;
+	out.netLiq = netLiq;
+	out.returns = returns;
+	calcProfitLoss(bars.open, bars.close, sig, 1, 0, out);
+
+	vector<double> fCash(5), fOpenEQ(5), fNetLiq(5), fReturns(5);
+	ntpResult fBars;
+	ntpPlOutputs fOut;
+	fOut.bars.cash = fCash;
+	fOut.bars.openEQ = fOpenEQ;
+	fOut.bars.netLiq = fNetLiq;
+	fOut.bars.returns = fReturns;
+	fOut.virtualBars = &fBars;
+	numTicksProfitPL(bars.series(), sig, 0, 2, 0, 1, 0, fOut);
+
+	BT_CHECK(!fBars.modified);
+	BT_CHECK_ARRAY(fCash, cash, 5, 0);
+	BT_CHECK_ARRAY(fOpenEQ, openEQ, 5, 0);
+	BT_CHECK_ARRAY(fNetLiq, netLiq, 5, 0);
+	BT_CHECK_ARRAY(fReturns, returns, 5, 0);
+}
+
+// The scan and merge stages write caller owned buffers identical to numTicksProfit
+static void testMergeBuffers()
+{
+	vector<double> sig;
+	testBars bars = randomBars(500, sig);
+
+	ntpResult res = numTicksProfit(bars.series(), sig, 0.25, 3, 0);
+	vector<ntpProfit> profits = numTicksProfitScan(bars.series(), sig, 0.25, 3, 0);
+	BT_CHECK(res.modified);
+	BT_CHECK(res.rows == sig.size() + profits.size());
+
+	const size_t rowsOut = res.rows;
+	vector<double> barsOut(4 * rowsOut), sigOut(rowsOut);
+	numTicksProfitMerge(bars.series(), sig, profits, barsOut, sigOut);
+	BT_CHECK(barsOut == res.bars);
+	BT_CHECK(sigOut == res.sig);
+
+	vector<double> shortSig(rowsOut - 1);
+	BT_CHECK_THROWS(numTicksProfitMerge(bars.series(), sig, profits, barsOut, shortSig), btError);
+}
+
+// One multi-target scan equals a call per target
+static void testTargets()
+{
+	vector<double> sig;
+	testBars bars = randomBars(2000, sig);
+	const vector<double> numTicks = { 2, 3, 5, 8, 13 };
+
+	for (int openAvg = 0; openAvg <= 1; openAvg++)
+	{
+		vector<ntpResult> results = numTicksProfitTargets(bars.series(), sig, 0.25, numTicks, openAvg);
+		vector<plStats> stats = numTicksProfitPLTargets(bars.series(), sig, 0.25, numTicks, openAvg, 50, 2.5);
+		BT_CHECK(results.size() == numTicks.size() && stats.size() == numTicks.size());
+
+		for (size_t tt = 0; tt < results.size() && tt < stats.size(); tt++)
+		{
+			ntpResult single = numTicksProfit(bars.series(), sig, 0.25, numTicks[tt], openAvg);
+			BT_CHECK(results[tt].modified == single.modified);
+			BT_CHECK(results[tt].sig == single.sig);
+			BT_CHECK(results[tt].bars == single.bars);
+
+			plStats singleStats = numTicksProfitPL(bars.series(), sig, 0.25, numTicks[tt], openAvg, 50, 2.5);
+			BT_CHECK(stats[tt].trades == singleStats.trades);
+			BT_CHECK_NEAR(stats[tt].netLiq, singleStats.netLiq, 0);
+			BT_CHECK_NEAR(stats[tt].sharpe, singleStats.sharpe, 0);
+		}
+	}
+
+	// No profit taking leaves every target unchanged
+	vector<ntpResult> none = numTicksProfitTargets(bars.series(), sig, 0, numTicks, 0);
+	BT_CHECK(none.size() == numTicks.size() && !none[0].modified);
+}
+
+// Single contract reverses take the fast path.  numTicksProfitPL still runs the general scan so
+// its virtual bars are the reference.
+static void testReverseFastPath()
+{
+	// Per contract objective reached exactly on the entry bar needs a price beyond it afterwards
+	testBars edge;
+	edge.open = { 10, 10, 10, 11, 11, 12 };
+	edge.high = { 10, 12, 12, 12.5, 11, 12 };
+	edge.low = { 10, 10, 10, 11, 11, 12 };
+	edge.close = { 10, 11, 11, 12, 11, 12 };
+	vector<double> edgeSig = { 1.5, 0, 0, 0, 0, 0 };
+
+	ntpResult atomic = numTicksProfit(edge.series(), edgeSig, 1, 2, 0);
+	BT_CHECK(atomic.rows == 7 && atomic.sig[3] == -1 && atomic.bars[4] == 12);
+	ntpResult average = numTicksProfit(edge.series(), edgeSig, 1, 2, 1);
+	BT_CHECK(average.rows == 7 && average.sig[1] == -1 && average.bars[2] == 12);
+
+	// Quarter point walk with gaps so objectives are often met exactly
+	for (int openAvg = 0; openAvg <= 1; openAvg++)
+	{
+		testBars bars;
+		vector<double> sig;
+		unsigned seed = 4242;
+		double px = 2000, last = -1.5;
+		for (size_t ii = 0; ii < 5000; ii++)
+		{
+			seed = seed * 1103515245u + 12345u;
+			double gap = 0.25 * (int((seed >> 12) % 5) - 2);
+			px += 0.25 * (int((seed >> 16) % 9) - 4);
+			bars.open.push_back(px + gap);
+			bars.high.push_back(max(px, px + gap) + 0.25 * ((seed >> 4) % 7));
+			bars.low.push_back(min(px, px + gap) - 0.25 * ((seed >> 8) % 7));
+			bars.close.push_back(px);
+			sig.push_back(((seed >> 20) % 9 == 0) ? (last = -last) : 0);
+		}
+
+		for (double numTicks : { 1.0, 2.0, 4.0, 9.0 })
+		{
+			ntpResult fast = numTicksProfit(bars.series(), sig, 0.25, numTicks, openAvg);
+			ntpResult general;
+			ntpPlOutputs out;
+			out.virtualBars = &general;
+			numTicksProfitPL(bars.series(), sig, 0.25, numTicks, openAvg, 50, 2.5, out);
+
+			BT_CHECK(fast.modified && fast.rows == general.rows);
+			BT_CHECK(fast.sig == general.sig);
+			BT_CHECK(fast.bars == general.bars);
+			BT_CHECK(fast.barIndex == general.barIndex);
+		}
+	}
+
+	// Every kernel finds the same observation
+	vector<double> open(37, 5), extreme(37, 5);
+	extreme[30] = 6;
+	open[33] = 7;
+	for (int simd = simdScalar; simd <= simdAVX512; simd++)
+	{
+		BT_CHECK(firstCross(open.data(), extreme.data(), 1, 37, 6, true, false, simdLevel(simd)) == 30);
+		BT_CHECK(firstCross(open.data(), extreme.data(), 1, 37, 6, true, true, simdLevel(simd)) == 33);
+		BT_CHECK(firstCross(open.data(), extreme.data(), 31, 33, 6, true, false, simdLevel(simd)) == 33);
+		BT_CHECK(firstCross(open.data(), extreme.data(), 0, 37, 5, false, false, simdLevel(simd)) == 0);
+		BT_CHECK(firstCross(open.data(), extreme.data(), 0, 37, 5, false, true, simdLevel(simd)) == 37);
+	}
+}
+
+int main()
+{
+	testLongProfitOnHigh();
+	testShortSameBar();
+	testGapOpen();
+	testOpenAverage();
+	testLotsByPrice();
+	testManyLots();
+	testUnchanged();
+	testFusedMatchesPipeline();
+	testFusedUnchanged();
+	testMergeBuffers();
+	testTargets();
+	testReverseFastPath();
+
+	return btTestResult("testNumTicksProfit");
+}
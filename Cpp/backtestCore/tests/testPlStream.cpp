@@ -0,0 +1,160 @@
+// testPlStream.cpp
+//
+// Unit tests for the streaming calcProfitLoss.
+
+#include "btPlStream.h"
+#include "btProfitLoss.h"
+#include "btError.h"
+#include "btTest.h"
+#include <vector>
+
+using namespace std;
+using namespace openAlgo;
+
+// Quarter point prices, pyramids, partial exits, flattens and reverses.
+// Every P&L is a multiple of 1/8 so the batch and streaming sums are exact.
+struct streamSeries
+{
+	vector<double> open, close, sig;
+
+	explicit streamSeries(size_t rows)
+	{
+		unsigned seed = 12345;
+		double px = 1000;
+		const double signals[] = { 0, 0, 0, 1, 2, -1, -3, 0.5, -0.5, 1.5, -2.5 };
+
+		for (size_t ii = 0; ii < rows; ii++)
+		{
+			seed = seed * 1103515245u + 12345u;
+			px += 0.25 * (int((seed >> 16) % 17) - 8);
+			open.push_back(px);
+			close.push_back(px + 0.25 * int((seed >> 8) % 5) - 0.5);
+			sig.push_back(signals[(seed >> 20) % 11]);
+		}
+	}
+};
+
+static void streamAll(plStream &stream, const streamSeries &ser, size_t from, size_t to, vector<plBar> &bars)
+{
+	for (size_t ii = from; ii < to; ii++)
+	{
+		plBar bar;
+		if (stream.push(ser.open[ii], ser.close[ii], ser.sig[ii], bar))
+			bars.push_back(bar);
+	}
+}
+
+// The released observations plus 'current' equal the batch outputs
+static void testMatchesBatch()
+{
+	const size_t rows = 2000;
+	streamSeries ser(rows);
+
+	vector<double> cash(rows), openEQ(rows), netLiq(rows), returns(rows);
+	plOutputs out;
+	out.cash = cash;
+	out.openEQ = openEQ;
+	out.netLiq = netLiq;
+	out.returns = returns;
+	calcProfitLoss(ser.open, ser.close, ser.sig, 50, 2.5, out);
+
+	plStream stream(50, 2.5);
+	vector<plBar> bars;
+	streamAll(stream, ser, 0, rows, bars);
+
+	plBar last;
+	BT_CHECK(stream.current(last));
+	bars.push_back(last);
+
+	BT_CHECK(bars.size() == rows);
+	for (size_t ii = 0; ii < bars.size() && ii < rows; ii++)
+	{
+		BT_CHECK(bars[ii].index == ii);
+		BT_CHECK_NEAR(bars[ii].cash, cash[ii], 0);
+		BT_CHECK_NEAR(bars[ii].openEQ, openEQ[ii], 0);
+		BT_CHECK_NEAR(bars[ii].netLiq, netLiq[ii], 0);
+		BT_CHECK_NEAR(bars[ii].returns, returns[ii], 0);
+	}
+}
+
+// A restored stream continues exactly like the original
+static void testCheckpointRestore()
+{
+	const size_t rows = 600;
+	streamSeries ser(rows);
+
+	plStream original(50, 2.5);
+	vector<plBar> before;
+	streamAll(original, ser, 0, 317, before);
+
+	vector<double> state = original.checkpoint();
+
+	plStream resumed(1, 0);
+	resumed.restore(state);
+	BT_CHECK(resumed.bars() == original.bars());
+	BT_CHECK(resumed.position() == original.position());
+
+	vector<plBar> expected, actual;
+	streamAll(original, ser, 317, rows, expected);
+	streamAll(resumed, ser, 317, rows, actual);
+
+	BT_CHECK(expected.size() == actual.size());
+	for (size_t ii = 0; ii < expected.size() && ii < actual.size(); ii++)
+	{
+		BT_CHECK(expected[ii].index == actual[ii].index);
+		BT_CHECK_NEAR(expected[ii].netLiq, actual[ii].netLiq, 0);
+		BT_CHECK_NEAR(expected[ii].openEQ, actual[ii].openEQ, 0);
+	}
+
+	state.pop_back();
+	BT_CHECK_THROWS(resumed.restore(state), btError);
+}
+
+// A bad signal throws when it is pushed, leaves the stream unchanged and the stream carries on
+static void testBadSignal()
+{
+	plStream stream(1, 0), clean(1, 0);
+	plBar bar, cleanBar;
+
+	stream.push(10, 10, 1, bar);
+	clean.push(10, 10, 1, cleanBar);
+
+	vector<double> before = stream.checkpoint();
+	BT_CHECK_THROWS(stream.push(11, 11, 0.25, bar), btError);
+	BT_CHECK(stream.checkpoint() == before);
+
+	// The rejected observation is pushed again with a valid signal
+	const double open[] = { 11, 12, 13, 12 };
+	const double sig[] = { 0, -2, 0, 1 };
+	for (size_t ii = 0; ii < 4; ii++)
+	{
+		bool released = stream.push(open[ii], open[ii], sig[ii], bar);
+		BT_CHECK(released == clean.push(open[ii], open[ii], sig[ii], cleanBar));
+		BT_CHECK_NEAR(bar.netLiq, cleanBar.netLiq, 0);
+	}
+	BT_CHECK(stream.position() == clean.position());
+
+	// Stricter than calcProfitLoss, which ignores an unknown fraction it never fills
+	vector<double> flatOpen = { 10, 11, 12 };
+	vector<double> flatSig = { 0.25, 0, 0.25 };
+	vector<double> cash(3), openEQ(3), netLiq(3), returns(3);
+	plOutputs out;
+	out.cash = cash;
+	out.openEQ = openEQ;
+	out.netLiq = netLiq;
+	out.returns = returns;
+	calcProfitLoss(flatOpen, flatOpen, flatSig, 1, 0, out);
+
+	plStream flat(1, 0);
+	BT_CHECK_THROWS(flat.push(10, 10, 0.25, bar), btError);
+	BT_CHECK(flat.bars() == 0);
+}
+
+int main()
+{
+	testMatchesBatch();
+	testCheckpointRestore();
+	testBadSignal();
+
+	return btTestResult("testPlStream");
+}
@@ -0,0 +1,146 @@
+// testPortfolio.cpp
+//
+// Unit tests for the multi-instrument portfolio engine.
+
+#include "btPortfolio.h"
+#include "btProfitLoss.h"
+#include "btError.h"
+#include "btTest.h"
+#include <cmath>
+#include <vector>
+
+using namespace std;
+using namespace openAlgo;
+
+// Column storage for one instrument
+struct testInstrument
+{
+	vector<double> open, high, low, close, sig;
+
+	instrumentSpec spec(double bigPoint, double cost) const
+	{
+		instrumentSpec inst;
+		inst.bars.open = open;
+		inst.bars.high = high;
+		inst.bars.low = low;
+		inst.bars.close = close;
+		inst.sig = sig;
+		inst.bigPoint = bigPoint;
+		inst.cost = cost;
+		return inst;
+	}
+};
+
+static testInstrument makeInstrument(size_t rows, double base, double phase, size_t period)
+{
+	testInstrument inst;
+	for (size_t ii = 0; ii < rows; ii++)
+	{
+		double px = base + 5 * sin(ii * 0.07 + phase);
+		inst.open.push_back(px);
+		inst.high.push_back(px + 1);
+		inst.low.push_back(px - 1);
+		inst.close.push_back(px + 0.25 * cos(ii * 0.4));
+		inst.sig.push_back((ii % period == 0) ? (((ii / period) % 2) ? 1.5 : -1.5) : 0);
+	}
+	return inst;
+}
+
+static vector<double> standaloneNetLiq(const testInstrument &inst, double bigPoint, double cost)
+{
+	size_t rows = inst.sig.size();
+	vector<double> cash(rows), openEQ(rows), netLiq(rows), returns(rows);
+	plOutputs out;
+	out.cash = cash;
+	out.openEQ = openEQ;
+	out.netLiq = netLiq;
+	out.returns = returns;
+	calcProfitLoss(inst.open, inst.close, inst.sig, bigPoint, cost, out);
+	return netLiq;
+}
+
+// Without profit taking every curve matches calcProfitLoss and the total is their sum
+static void testAggregate()
+{
+	const size_t rows = 10000;
+	testInstrument es = makeInstrument(rows, 2000, 0, 13);
+	testInstrument kc = makeInstrument(rows, 150, 1.3, 29);
+
+	vector<instrumentSpec> book;
+	book.push_back(es.spec(50, 2.5));
+	book.push_back(kc.spec(375, 4));
+
+	portfolioResult res = runPortfolio(book, 2);
+	BT_CHECK(res.rows == rows && res.instruments == 2);
+
+	vector<double> esNet = standaloneNetLiq(es, 50, 2.5);
+	vector<double> kcNet = standaloneNetLiq(kc, 375, 4);
+	BT_CHECK_ARRAY(&res.netLiq[0], esNet, rows, 0);
+	BT_CHECK_ARRAY(&res.netLiq[rows], kcNet, rows, 0);
+
+	double mean = 0;
+	for (size_t ii = 0; ii < rows; ii++)
+	{
+		BT_CHECK_NEAR(res.totalNetLiq[ii], esNet[ii] + kcNet[ii], 0);
+		mean += res.totalReturns[ii];
+	}
+	mean /= rows;
+
+	double var = 0;
+	for (size_t ii = 0; ii < rows; ii++)
+		var += (res.totalReturns[ii] - mean) * (res.totalReturns[ii] - mean);
+	var /= (rows - 1);
+	BT_CHECK_NEAR(res.sharpe, mean / sqrt(var), 1e-9);
+
+	// Deterministic regardless of thread count
+	portfolioResult serial = runPortfolio(book, 1);
+	BT_CHECK(serial.totalNetLiq == res.totalNetLiq);
+	BT_CHECK(serial.sharpe == res.sharpe);
+}
+
+// Profit taking virtual bars fold back onto the observation they were taken in
+static void testProfitTakingFold()
+{
+	testInstrument inst;
+	inst.open = { 10, 10, 10, 11, 12 };
+	inst.high = { 10, 11, 11, 13, 12 };
+	inst.low = { 10, 9, 9, 10, 12 };
+	inst.close = { 10, 10, 10, 12, 12 };
+	inst.sig = { 1.5, 0, 0, 0, 0 };
+
+	instrumentSpec spec = inst.spec(1, 0);
+	spec.minTick = 1;
+	spec.numTicks = 2;
+
+	vector<instrumentSpec> book(1, spec);
+	portfolioResult res = runPortfolio(book);
+
+	double netLiq[] = { 0, 0, 0, 2, 2 };
+	double returns[] = { 0, 0, 0, 2, 0 };
+	BT_CHECK(res.rows == 5);
+	BT_CHECK_ARRAY(res.netLiq, netLiq, 5, 0);
+	BT_CHECK_ARRAY(res.returns, returns, 5, 0);
+	BT_CHECK_ARRAY(res.totalNetLiq, netLiq, 5, 0);
+}
+
+static void testMisaligned()
+{
+	testInstrument aa = makeInstrument(100, 10, 0, 7);
+	testInstrument bb = makeInstrument(99, 10, 0, 7);
+
+	vector<instrumentSpec> book;
+	book.push_back(aa.spec(1, 0));
+	book.push_back(bb.spec(1, 0));
+
+	BT_CHECK_THROWS(runPortfolio(book), btError);
+	BT_CHECK_THROWS(runPortfolio(span<const instrumentSpec>()), btError);
+}
+
+int main()
+{
+	testAggregate();
+	testProfitTakingFold();
+	testMisaligned();
+
+	return btTestResult("testPortfolio");
+}
@@ -0,0 +1,89 @@
+// testPostPass.cpp
+//
+// Unit tests for the fused calcProfitLoss post-processing pass.  Every SIMD level supported
+// by the running CPU is checked against the original three loop scalar reference.
+
+#include "btPostPass.h"
+#include "btTest.h"
+#include <cstdlib>
+#include <vector>
+
+using namespace std;
+using namespace openAlgo;
+
+// The original passes from calcProfitLoss
+static void referencePass(vector<double> &cash, vector<double> &openEQ, vector<double> &netLiq, vector<double> &returns)
+{
+	const int rows = int(cash.size());
+
+	for (int ll = 1; ll < rows - 1; ll++)
+	{
+		if (openEQ[ll] != cash[ll + 1] && openEQ[ll + 1] == 0 && cash[ll + 1] > 0)
+			openEQ[ll] = cash[ll + 1];
+	}
+
+	double runSum = 0;
+	for (int kk = 0; kk < rows; kk++)
+	{
+		runSum = runSum + cash[kk];
+		netLiq[kk] = runSum + openEQ[kk];
+		returns[kk] = (kk > 0) ? netLiq[kk] - netLiq[kk - 1] : 0;
+	}
+}
+
+// Sparse cash with frequent 'close to flat' observations so the cleaning rule fires
+static void makeData(size_t rows, bool wholeDollars, vector<double> &cash, vector<double> &openEQ)
+{
+	srand(12345);
+	cash.assign(rows, 0);
+	openEQ.assign(rows, 0);
+
+	for (size_t ii = 0; ii < rows; ii++)
+	{
+		double value = (rand() % 2001 - 1000) * (wholeDollars ? 1.0 : 0.37);
+		if (rand() % 4 == 0)
+			cash[ii] = value;
+		else if (rand() % 3 != 0)
+			openEQ[ii] = value * 0.5;
+	}
+}
+
+static void checkLevel(simdLevel level, size_t rows, bool wholeDollars)
+{
+	vector<double> cash, openEQ;
+	makeData(rows, wholeDollars, cash, openEQ);
+
+	vector<double> refCash(cash), refEQ(openEQ), refNet(rows), refRet(rows);
+	referencePass(refCash, refEQ, refNet, refRet);
+
+	vector<double> net(rows, -1), ret(rows, -1);
+	plPostPass(cash.data(), openEQ.data(), net.data(), ret.data(), rows, level);
+
+	// Cleaning is exact and whole dollar sums are exact in any order
+	double tol = wholeDollars ? 0 : 1e-7;
+	BT_CHECK_ARRAY(openEQ, refEQ, rows, 0);
+	BT_CHECK_ARRAY(net, refNet, rows, tol);
+	BT_CHECK_ARRAY(ret, refRet, rows, tol);
+}
+
+int main()
+{
+	const simdLevel levels[] = { simdScalar, simdAVX2, simdAVX512 };
+	const size_t sizes[] = { 0, 1, 2, 3, 5, 8, 9, 10, 17, 1000, 1003 };
+
+	printf("detected SIMD level %d\n", int(detectSimdLevel()));
+
+	for (size_t ll = 0; ll < 3; ll++)
+	{
+		if (levels[ll] > detectSimdLevel())
+			continue;
+
+		for (size_t ss = 0; ss < sizeof(sizes) / sizeof(sizes[0]); ss++)
+		{
+			checkLevel(levels[ll], sizes[ss], true);
+			checkLevel(levels[ll], sizes[ss], false);
+		}
+	}
+
+	return btTestResult("testPostPass");
+}
@@ -0,0 +1,625 @@
+// testProfitLoss.cpp
+//
+// Unit tests for the calcProfitLoss core.
+
+#include "btProfitLoss.h"
+#include "btError.h"
+#include "btTest.h"
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+using namespace openAlgo;
+
+// Holds output storage for a single run
+struct plRun
+{
+	vector<double> cash, openEQ, netLiq, returns;
+
+	plRun(const vector<double> &open, const vector<double> &close, const vector<double> &sig, double bigPoint, double cost)
+		: cash(sig.size()), openEQ(sig.size()), netLiq(sig.size()), returns(sig.size())
+	{
+		plOutputs out;
+		out.cash = cash;
+		out.openEQ = openEQ;
+		out.netLiq = netLiq;
+		out.returns = returns;
+		calcProfitLoss(open, close, sig, bigPoint, cost, out);
+	}
+
+	plRun(const ohlcSeries &bars, const vector<double> &sig, double bigPoint, double cost, const fillModel &fill)
+		: cash(sig.size()), openEQ(sig.size()), netLiq(sig.size()), returns(sig.size())
+	{
+		plOutputs out;
+		out.cash = cash;
+		out.openEQ = openEQ;
+		out.netLiq = netLiq;
+		out.returns = returns;
+		calcProfitLoss(bars, sig, bigPoint, cost, fill, out);
+	}
+};
+
+// Long 1 lot then reverse to short 1 lot with a fractional signal
+static void testReverse()
+{
+	vector<double> open = { 100, 102, 104, 103, 101, 100 };
+	vector<double> close = { 101, 103, 105, 102, 100, 99 };
+	vector<double> sig = { 0, 1, 0, -1.5, 0, 0 };
+
+	plRun run(open, close, sig, 10, 1);
+
+	double cash[] = { 0, 0, 0, 0, -31, 0 };
+	double openEQ[] = { 0, 0, 0, -20, 10, 20 };
+	double netLiq[] = { 0, 0, 0, -20, -21, -11 };
+	double returns[] = { 0, 0, 0, -20, -1, 10 };
+
+	BT_CHECK_ARRAY(run.cash, cash, 6, 0);
+	BT_CHECK_ARRAY(run.openEQ, openEQ, 6, 0);
+	BT_CHECK_ARRAY(run.netLiq, netLiq, 6, 0);
+	BT_CHECK_ARRAY(run.returns, returns, 6, 0);
+}
+
+// Pyramid two long lots then reduce by one (FIFO)
+static void testPartialLiquidation()
+{
+	vector<double> px = { 10, 11, 12, 13, 14, 15 };
+	vector<double> sig = { 1, 1, 0, -1, 0, 0 };
+
+	plRun run(px, px, sig, 1, 0);
+
+	double cash[] = { 0, 0, 0, 0, 3, 0 };
+	double openEQ[] = { 0, 0, 1, 3, 2, 3 };
+	double netLiq[] = { 0, 0, 1, 3, 5, 6 };
+
+	BT_CHECK_ARRAY(run.cash, cash, 6, 0);
+	BT_CHECK_ARRAY(run.openEQ, openEQ, 6, 0);
+	BT_CHECK_ARRAY(run.netLiq, netLiq, 6, 0);
+}
+
+// No trades, or a trade that cannot be filled, returns zeros
+static void testNoTrades()
+{
+	vector<double> px = { 10, 11, 12 };
+	vector<double> none = { 0, 0.5, 0 };
+	vector<double> last = { 0, 0, 1 };
+	double zeros[] = { 0, 0, 0 };
+
+	plRun runNone(px, px, none, 1, 0);
+	BT_CHECK_ARRAY(runNone.netLiq, zeros, 3, 0);
+
+	plRun runLast(px, px, last, 1, 0);
+	BT_CHECK_ARRAY(runLast.netLiq, zeros, 3, 0);
+}
+
+static void testBadInputs()
+{
+	vector<double> px = { 10, 11, 12, 13 };
+	vector<double> badFrac = { 1, 0.25, 0, 0 };
+	vector<double> shortSig = { 1, 0 };
+
+	BT_CHECK_THROWS(plRun(px, px, badFrac, 1, 0), btError);
+	BT_CHECK_THROWS(plRun(px, px, shortSig, 1, 0), btError);
+}
+
+// Pyramid one lot per bar and check the O(1) ledger open equity against marking each lot
+static void testPyramidOpenEquity()
+{
+	const int rows = 80;
+	const int lots = 60;
+	vector<double> open(rows), close(rows), sig(rows, 0);
+
+	for (int ii = 0; ii < rows; ii++)
+	{
+		open[ii] = 1000.25 + 3 * sin(ii * 0.7);
+		close[ii] = open[ii] + 0.75 * cos(ii * 1.3);
+	}
+
+	for (int ii = 0; ii < lots; ii++)
+		sig[ii] = 1;
+	sig[lots] = -0.5;
+
+	plRun run(open, close, sig, 50, 0);
+
+	// The fill bar of the first trade carries no open equity
+	for (int ii = 2; ii <= lots; ii++)
+	{
+		double expected = 0;
+		for (int lot = 0; lot < ii; lot++)
+			expected += (close[ii] - open[lot + 1]) * 50;
+
+		BT_CHECK_NEAR(run.openEQ[ii], expected, 1e-6);
+	}
+
+	// Flat after the close out
+	BT_CHECK(run.openEQ[lots + 1] == 0);
+}
+
+// A batch of signal columns must match running each column on its own regardless of thread count
+static void testBatchMatchesSingle()
+{
+	const size_t rows = 200;
+	const size_t cols = 7;
+	vector<double> open(rows), close(rows), sig(rows * cols, 0);
+
+	for (size_t ii = 0; ii < rows; ii++)
+	{
+		open[ii] = 100 + 5 * sin(ii * 0.1);
+		close[ii] = open[ii] + cos(ii * 0.3);
+	}
+
+	// Each column trades a different period with a mix of additive and reversing signals
+	for (size_t cc = 0; cc < cols; cc++)
+		for (size_t ii = cc + 1; ii < rows; ii += cc + 3)
+			sig[cc * rows + ii] = ((ii / (cc + 3)) % 2) ? 1.5 : ((ii % 5) ? -1.5 : -1);
+
+	for (unsigned threads = 1; threads <= 4; threads += 3)
+	{
+		vector<double> cash(rows * cols), openEQ(rows * cols), netLiq(rows * cols), returns(rows * cols);
+		plOutputs out;
+		out.cash = cash;
+		out.openEQ = openEQ;
+		out.netLiq = netLiq;
+		out.returns = returns;
+
+		calcProfitLossBatch(open, close, sig, cols, 50, 2, out, threads);
+
+		for (size_t cc = 0; cc < cols; cc++)
+		{
+			vector<double> colSig(sig.begin() + cc * rows, sig.begin() + (cc + 1) * rows);
+			plRun run(open, close, colSig, 50, 2);
+
+			BT_CHECK_ARRAY(&cash[cc * rows], run.cash, rows, 0);
+			BT_CHECK_ARRAY(&openEQ[cc * rows], run.openEQ, rows, 0);
+			BT_CHECK_ARRAY(&netLiq[cc * rows], run.netLiq, rows, 0);
+			BT_CHECK_ARRAY(&returns[cc * rows], run.returns, rows, 0);
+		}
+	}
+
+	// A bad column is reported from the worker thread
+	sig[3 * rows + 10] = 0.25;
+	vector<double> cash(rows * cols), openEQ(rows * cols), netLiq(rows * cols), returns(rows * cols);
+	plOutputs out;
+	out.cash = cash;
+	out.openEQ = openEQ;
+	out.netLiq = netLiq;
+	out.returns = returns;
+	BT_CHECK_THROWS(calcProfitLossBatch(open, close, sig, cols, 50, 2, out, 4), btError);
+}
+
+// Streaming statistics must agree with statistics computed from the full outputs
+static void testStatsMatchArrays()
+{
+	const size_t rows = 300;
+	vector<double> open(rows), close(rows), sig(rows, 0);
+
+	for (size_t ii = 0; ii < rows; ii++)
+	{
+		open[ii] = 50 + 4 * sin(ii * 0.05) + sin(ii * 0.9);
+		close[ii] = open[ii] + 0.5 * cos(ii * 0.4);
+	}
+
+	// Pyramids, partial exits, reverses and a close out
+	for (size_t ii = 5; ii < rows - 20; ii += 7)
+		sig[ii] = ((ii / 7) % 4 == 0) ? -2.5 : (((ii / 7) % 4 == 1) ? 1 : (((ii / 7) % 4 == 2) ? -1 : 2.5));
+	sig[rows - 10] = 0.5;
+
+	plRun run(open, close, sig, 20, 1.5);
+	plStats stats = calcProfitLossStats(open, close, sig, 20, 1.5);
+
+	double mean = 0;
+	for (size_t ii = 0; ii < rows; ii++)
+		mean += run.returns[ii];
+	mean /= rows;
+
+	double var = 0, peak = 0, maxDD = 0, cashSum = 0;
+	for (size_t ii = 0; ii < rows; ii++)
+	{
+		var += (run.returns[ii] - mean) * (run.returns[ii] - mean);
+		if (run.netLiq[ii] > peak)
+			peak = run.netLiq[ii];
+		if (peak - run.netLiq[ii] > maxDD)
+			maxDD = peak - run.netLiq[ii];
+		cashSum += run.cash[ii];
+	}
+	var /= (rows - 1);
+
+	BT_CHECK(stats.bars == rows);
+	BT_CHECK_NEAR(stats.meanReturn, mean, 1e-9);
+	BT_CHECK_NEAR(stats.varReturn, var, 1e-6);
+	BT_CHECK_NEAR(stats.sharpe, mean / sqrt(var), 1e-9);
+	BT_CHECK_NEAR(stats.maxDrawdown, maxDD, 1e-9);
+	BT_CHECK_NEAR(stats.netLiq, run.netLiq[rows - 1], 1e-9);
+	BT_CHECK_NEAR(stats.netProfit, cashSum, 1e-9);
+	BT_CHECK(stats.trades > 0 && stats.winners <= stats.trades);
+	BT_CHECK_NEAR(stats.winRate, double(stats.winners) / stats.trades, 0);
+
+	// Batched statistics agree with single column statistics
+	vector<double> sig2(sig);
+	sig2.insert(sig2.end(), sig.begin(), sig.end());
+	for (size_t ii = rows; ii < 2 * rows; ii++)
+		sig2[ii] = -sig2[ii];
+
+	vector<plStats> batch(2);
+	calcProfitLossStatsBatch(open, close, sig2, 2, 20, 1.5, batch, 2);
+	BT_CHECK_NEAR(batch[0].sharpe, stats.sharpe, 0);
+	BT_CHECK(batch[1].trades == stats.trades);
+}
+
+// Closing fills are counted once per line item piece
+static void testStatsTrades()
+{
+	vector<double> px = { 10, 11, 12, 13, 14, 15 };
+	vector<double> sig = { 1, 1, 0, -1, 0, 0 };
+
+	plStats stats = calcProfitLossStats(px, px, sig, 1, 0);
+
+	BT_CHECK(stats.trades == 1);
+	BT_CHECK(stats.winners == 1);
+	BT_CHECK_NEAR(stats.grossProfit, 3, 0);
+	BT_CHECK_NEAR(stats.netLiq, 6, 0);
+	BT_CHECK_NEAR(stats.maxDrawdown, 0, 0);
+}
+
+// Every closing fill is listed with its line item, including pieces of a partially closed lot
+static void testTradeList()
+{
+	vector<double> px = { 10, 11, 12, 13, 14, 15, 16, 17, 18 };
+	vector<double> sig = { 2, 0, -1, 0, -1.5, 0, 0.5, 0, 0 };
+
+	tradeList trades;
+	vector<double> cash(9), openEQ(9), netLiq(9), returns(9);
+	plOutputs out;
+	out.cash = cash;
+	out.openEQ = openEQ;
+	out.netLiq = netLiq;
+	out.returns = returns;
+	out.trades = &trades;
+	calcProfitLoss(px, px, sig, 1, 0.5, out);
+
+	int entryIndex[] = { 0, 0, 4 };
+	int exitIndex[] = { 2, 4, 6 };
+	int quantity[] = { 1, 1, -1 };
+	double entryPrice[] = { 11, 11, 15 };
+	double exitPrice[] = { 13, 15, 17 };
+	double pnl[] = { 1.5, 3.5, -2.5 };
+
+	BT_CHECK(trades.size() == 3);
+	BT_CHECK(trades.entryIndex == vector<int>(entryIndex, entryIndex + 3));
+	BT_CHECK(trades.exitIndex == vector<int>(exitIndex, exitIndex + 3));
+	BT_CHECK(trades.quantity == vector<int>(quantity, quantity + 3));
+	BT_CHECK_ARRAY(trades.entryPrice, entryPrice, 3, 0);
+	BT_CHECK_ARRAY(trades.exitPrice, exitPrice, 3, 0);
+	BT_CHECK_ARRAY(trades.pnl, pnl, 3, 0);
+
+	// The statistics form lists the same trades and a rerun replaces the list
+	ohlcSeries bars;
+	bars.open = px;
+	bars.close = px;
+	plStats stats = calcProfitLossStats(bars, sig, 1, 0.5, fillModel(), &trades);
+	BT_CHECK(stats.trades == trades.size() && trades.size() == 3);
+	BT_CHECK_NEAR(stats.netProfit, pnl[0] + pnl[1] + pnl[2], 0);
+
+	// One list per column in the batched forms
+	vector<double> sig2(sig);
+	sig2.insert(sig2.end(), 9, 0);
+	sig2[9 + 1] = -1;
+	vector<double> cash2(18), openEQ2(18), netLiq2(18), returns2(18);
+	vector<tradeList> colTrades(2);
+	plOutputs out2;
+	out2.cash = cash2;
+	out2.openEQ = openEQ2;
+	out2.netLiq = netLiq2;
+	out2.returns = returns2;
+	out2.trades = colTrades.data();
+	calcProfitLossBatch(bars, sig2, 2, 1, 0.5, fillModel(), out2, 2);
+	BT_CHECK(colTrades[0].pnl == trades.pnl);
+	BT_CHECK(colTrades[1].size() == 0);
+
+	vector<plStats> batch(2);
+	calcProfitLossStatsBatch(bars, sig2, 2, 1, 0.5, fillModel(), batch, 2, colTrades.data());
+	BT_CHECK(colTrades[0].exitIndex == trades.exitIndex);
+	BT_CHECK(colTrades[1].size() == 0);
+}
+
+// Excursions of each closed quantity over the observations it was held
+static void testTradeExcursions()
+{
+	vector<double> px = { 10, 11, 12, 13, 14, 15, 16, 17, 18 };
+	vector<double> high, low;
+	for (size_t ii = 0; ii < px.size(); ii++)
+	{
+		high.push_back(px[ii] + 1);
+		low.push_back(px[ii] - 1);
+	}
+	vector<double> sig = { 2, 0, -1, 0, -1.5, 0, 0.5, 0, 0 };
+
+	ohlcSeries bars;
+	bars.open = px;
+	bars.high = high;
+	bars.low = low;
+	bars.close = px;
+
+	tradeList trades;
+	calcProfitLossStats(bars, sig, 1, 0.5, fillModel(), &trades);
+
+	double mae[] = { -1, -1, -2 };
+	double mfe[] = { 2, 4, 1 };
+	BT_CHECK(trades.size() == 3 && trades.mae.size() == 3 && trades.mfe.size() == 3);
+	BT_CHECK_ARRAY(trades.mae, mae, 3, 0);
+	BT_CHECK_ARRAY(trades.mfe, mfe, 3, 0);
+
+	// Not tracked without the range
+	ohlcSeries openClose;
+	openClose.open = px;
+	openClose.close = px;
+	calcProfitLossStats(openClose, sig, 1, 0.5, fillModel(), &trades);
+	BT_CHECK(trades.size() == 3 && trades.mae.empty() && trades.mfe.empty());
+
+	// A rescan of every trade agrees on pyramids, partial exits, reverses and close outs
+	const size_t rows = 400;
+	vector<double> open(rows), hi(rows), lo(rows), close(rows), rsig(rows, 0);
+	for (size_t ii = 0; ii < rows; ii++)
+	{
+		open[ii] = 50 + 4 * sin(ii * 0.05) + sin(ii * 0.9);
+		close[ii] = open[ii] + 0.5 * cos(ii * 0.4);
+		hi[ii] = max(open[ii], close[ii]) + 0.3 + 0.2 * sin(ii * 1.3);
+		lo[ii] = min(open[ii], close[ii]) - 0.3 - 0.2 * cos(ii * 0.7);
+	}
+	for (size_t ii = 5; ii < rows - 20; ii += 7)
+		rsig[ii] = ((ii / 7) % 5 == 0) ? -2.5 : (((ii / 7) % 5 == 1) ? 1 : (((ii / 7) % 5 == 2) ? -1 : (((ii / 7) % 5 == 3) ? 2.5 : 0.5)));
+
+	ohlcSeries rbars;
+	rbars.open = open;
+	rbars.high = hi;
+	rbars.low = lo;
+	rbars.close = close;
+	calcProfitLossStats(rbars, rsig, 20, 1.5, fillModel(), &trades);
+	BT_CHECK(trades.size() > 20 && trades.mae.size() == trades.size());
+
+	for (size_t tt = 0; tt < trades.size(); tt++)
+	{
+		double top = max(trades.entryPrice[tt], trades.exitPrice[tt]);
+		double bottom = min(trades.entryPrice[tt], trades.exitPrice[tt]);
+		for (int ii = trades.entryIndex[tt] + 1; ii <= trades.exitIndex[tt]; ii++)
+		{
+			top = max(top, hi[ii]);
+			bottom = min(bottom, lo[ii]);
+		}
+		const int qty = trades.quantity[tt];
+		BT_CHECK_NEAR(trades.mfe[tt], ((qty > 0 ? top : bottom) - trades.entryPrice[tt]) * qty * 20, 1e-12);
+		BT_CHECK_NEAR(trades.mae[tt], ((qty > 0 ? bottom : top) - trades.entryPrice[tt]) * qty * 20, 1e-12);
+	}
+}
+
+// Integer tick arithmetic agrees with the double ledger and carries no accumulated rounding
+static void testTicks()
+{
+	vector<double> open = { 100, 102, 104, 103, 101, 100 };
+	vector<double> close = { 101, 103, 105, 102, 100, 99 };
+	vector<double> sig = { 0, 1, 0, -1.5, 0, 0 };
+
+	ohlcSeries bars;
+	bars.open = open;
+	bars.close = close;
+
+	plRun legacy(open, close, sig, 10, 1);
+	vector<double> cash(6), openEQ(6), netLiq(6), returns(6);
+	plOutputs out;
+	out.cash = cash;
+	out.openEQ = openEQ;
+	out.netLiq = netLiq;
+	out.returns = returns;
+	calcProfitLossTicks(bars, sig, 0.25, 10, 1, fillModel(), out);
+	BT_CHECK_ARRAY(cash, legacy.cash.data(), 6, 0);
+	BT_CHECK_ARRAY(openEQ, legacy.openEQ.data(), 6, 0);
+	BT_CHECK_ARRAY(netLiq, legacy.netLiq.data(), 6, 0);
+	BT_CHECK_ARRAY(returns, legacy.returns.data(), 6, 0);
+
+	// Cent ticks are not binary fractions.  Every netLiq is still a whole number of ticks.
+	const size_t rows = 20000;
+	const double minTick = 0.01;
+	const double tickValue = minTick * 7;
+	vector<double> px(rows), rsig(rows, 0);
+	long cents = 12345;
+	for (size_t ii = 0; ii < rows; ii++)
+	{
+		cents += long((ii * 7919) % 11) - 5;
+		px[ii] = cents * minTick;
+		if (ii % 13 == 5)
+			rsig[ii] = ((ii / 13) % 2) ? 1.5 : -1.5;
+	}
+
+	ohlcSeries centBars;
+	centBars.open = px;
+	centBars.close = px;
+	vector<double> tCash(rows), tOpenEQ(rows), tNetLiq(rows), tReturns(rows);
+	plOutputs tOut;
+	tOut.cash = tCash;
+	tOut.openEQ = tOpenEQ;
+	tOut.netLiq = tNetLiq;
+	tOut.returns = tReturns;
+	calcProfitLossTicks(centBars, rsig, minTick, 7, 0, fillModel(), tOut);
+
+	plRun dbl(px, px, rsig, 7, 0);
+	bool whole = true;
+	for (size_t ii = 0; ii < rows; ii++)
+		whole = whole && tNetLiq[ii] == floor(tNetLiq[ii] / tickValue + 0.5) * tickValue;
+	BT_CHECK(whole);
+	BT_CHECK_ARRAY(tNetLiq, dbl.netLiq.data(), rows, 1e-6);
+
+	// Batched columns equal single runs
+	vector<double> sig2(rsig);
+	sig2.insert(sig2.end(), rsig.begin(), rsig.end());
+	for (size_t ii = rows; ii < 2 * rows; ii++)
+		sig2[ii] = -sig2[ii];
+	vector<double> bCash(2 * rows), bOpenEQ(2 * rows), bNetLiq(2 * rows), bReturns(2 * rows);
+	plOutputs bOut;
+	bOut.cash = bCash;
+	bOut.openEQ = bOpenEQ;
+	bOut.netLiq = bNetLiq;
+	bOut.returns = bReturns;
+	calcProfitLossTicksBatch(centBars, sig2, 2, minTick, 7, 0, fillModel(), bOut, 2);
+	BT_CHECK_ARRAY(bNetLiq.data(), tNetLiq, rows, 0);
+
+	// Prices must be on a tick and the tick must be positive
+	BT_CHECK_THROWS(calcProfitLossTicks(bars, sig, 0.3, 10, 1, fillModel(), out), btError);
+	BT_CHECK_THROWS(calcProfitLossTicks(bars, sig, 0, 10, 1, fillModel(), out), btError);
+}
+
+// Single precision prices and single precision or int8 signals give the double results of the same values
+static void testCompactStorage()
+{
+	const size_t rows = 500;
+	const size_t cols = 3;
+	vector<float> openF(rows), highF(rows), lowF(rows), closeF(rows), sigF(rows * cols, 0);
+	vector<int8_t> sig8(rows * cols, 0);
+
+	for (size_t ii = 0; ii < rows; ii++)
+	{
+		openF[ii] = float(1000 + 0.25 * int(40 * sin(ii * 0.07)));
+		closeF[ii] = openF[ii] + 0.25f * float(int(ii % 5) - 2);
+		highF[ii] = max(openF[ii], closeF[ii]) + 0.5f;
+		lowF[ii] = min(openF[ii], closeF[ii]) - 0.75f;
+	}
+	for (size_t cc = 0; cc < cols; cc++)
+		for (size_t ii = cc + 2; ii < rows; ii += 9 + cc)
+		{
+			sig8[cc * rows + ii] = int8_t(((ii / 9) % 3 == 0) ? 2 : (((ii / 9) % 3 == 1) ? -1 : -1));
+			sigF[cc * rows + ii] = ((ii / 9) % 2) ? 1.5f : -1.5f;
+		}
+
+	vector<double> open(openF.begin(), openF.end()), high(highF.begin(), highF.end());
+	vector<double> low(lowF.begin(), lowF.end()), close(closeF.begin(), closeF.end());
+	vector<double> sigD(sigF.begin(), sigF.end()), sig8D(sig8.begin(), sig8.end());
+
+	ohlcSeries bars;
+	bars.open = open;
+	bars.high = high;
+	bars.low = low;
+	bars.close = close;
+	ohlcSeriesF barsF;
+	barsF.open = openF;
+	barsF.high = highF;
+	barsF.low = lowF;
+	barsF.close = closeF;
+
+	fillModel fill;
+	fill.base = fillVWAP;
+	fill.slippageTicks = 1;
+	fill.minTick = 0.25;
+
+	struct batchRun
+	{
+		vector<double> cash, openEQ, netLiq, returns;
+		plOutputs out;
+
+		explicit batchRun(size_t size) : cash(size), openEQ(size), netLiq(size), returns(size)
+		{
+			out.cash = cash;
+			out.openEQ = openEQ;
+			out.netLiq = netLiq;
+			out.returns = returns;
+		}
+	};
+
+	batchRun ref(rows * cols), ref8(rows * cols), runF(rows * cols), run8(rows * cols), runDF(rows * cols);
+	calcProfitLossBatch(bars, sigD, cols, 50, 2, fill, ref.out, 2);
+	calcProfitLossBatch(bars, sig8D, cols, 50, 2, fill, ref8.out, 2);
+	calcProfitLossBatch(barsF, span<const float>(sigF), cols, 50, 2, fill, runF.out, 2);
+	calcProfitLossBatch(barsF, span<const int8_t>(sig8), cols, 50, 2, fill, run8.out, 2);
+	calcProfitLossBatch(bars, span<const float>(sigF), cols, 50, 2, fill, runDF.out, 2);
+
+	BT_CHECK(runF.netLiq == ref.netLiq && runF.cash == ref.cash && runF.openEQ == ref.openEQ);
+	BT_CHECK(runDF.netLiq == ref.netLiq && runDF.returns == ref.returns);
+	BT_CHECK(run8.netLiq == ref8.netLiq && run8.cash == ref8.cash);
+
+	vector<plStats> stats(cols), statsF(cols);
+	vector<tradeList> trades(cols), tradesF(cols);
+	calcProfitLossStatsBatch(bars, sigD, cols, 50, 2, fill, stats, 2, trades.data());
+	calcProfitLossStatsBatch(barsF, span<const float>(sigF), cols, 50, 2, fill, statsF, 2, tradesF.data());
+	for (size_t cc = 0; cc < cols; cc++)
+	{
+		BT_CHECK(statsF[cc].trades == stats[cc].trades);
+		BT_CHECK_NEAR(statsF[cc].sharpe, stats[cc].sharpe, 0);
+		BT_CHECK(tradesF[cc].pnl == trades[cc].pnl && tradesF[cc].mae == trades[cc].mae);
+	}
+}
+
+// Same ledger with a configurable fill
+static void testFillModels()
+{
+	vector<double> open = { 100, 102, 104, 103, 101, 100 };
+	vector<double> high = { 102, 104, 106, 104, 102, 101 };
+	vector<double> low = { 99, 101, 103, 101, 99, 98 };
+	vector<double> close = { 101, 103, 105, 102, 100, 99 };
+	vector<double> sig = { 0, 1, 0, -1.5, 0, 0 };
+
+	ohlcSeries bars;
+	bars.open = open;
+	bars.high = high;
+	bars.low = low;
+	bars.close = close;
+
+	// The default model is the legacy Open fill
+	plRun legacy(open, close, sig, 10, 1);
+	plRun dflt(bars, sig, 10, 1, fillModel());
+	BT_CHECK_ARRAY(dflt.cash, legacy.cash.data(), 6, 0);
+	BT_CHECK_ARRAY(dflt.netLiq, legacy.netLiq.data(), 6, 0);
+
+	// Close fill: long at 105, reverse at 100
+	fillModel atClose;
+	atClose.base = fillClose;
+	plRun closeRun(bars, sig, 10, 1, atClose);
+
+	double cash[] = { 0, 0, 0, 0, -51, 0 };
+	double openEQ[] = { 0, 0, 0, -30, 0, 10 };
+	double netLiq[] = { 0, 0, 0, -30, -51, -41 };
+	BT_CHECK_ARRAY(closeRun.cash, cash, 6, 0);
+	BT_CHECK_ARRAY(closeRun.openEQ, openEQ, 6, 0);
+	BT_CHECK_ARRAY(closeRun.netLiq, netLiq, 6, 0);
+
+	// One adverse tick on each side: buy 104.25, sell 100.75
+	fillModel slip;
+	slip.slippageTicks = 1;
+	slip.minTick = 0.25;
+	plRun slipRun(bars, sig, 10, 1, slip);
+	BT_CHECK_NEAR(slipRun.cash[4], -36, 1e-12);
+	BT_CHECK_NEAR(slipRun.openEQ[4], 7.5, 1e-12);
+
+	// Typical price of the fill observation
+	fillModel vwap;
+	vwap.base = fillVWAP;
+	plRun vwapRun(bars, sig, 10, 1, vwap);
+	BT_CHECK_NEAR(vwapRun.openEQ[3], (102 - (106.0 + 103 + 105) / 3) * 10, 1e-9);
+
+	// Statistics follow the same fill
+	plStats stats = calcProfitLossStats(bars, sig, 10, 1, atClose);
+	BT_CHECK_NEAR(stats.netLiq, -41, 1e-12);
+
+	// High and Low are required by range based fills
+	ohlcSeries openClose;
+	openClose.open = open;
+	openClose.close = close;
+	BT_CHECK_THROWS(calcProfitLossStats(openClose, sig, 10, 1, vwap), btError);
+}
+
+int main()
+{
+	testReverse();
+	testPartialLiquidation();
+	testNoTrades();
+	testBadInputs();
+	testPyramidOpenEquity();
+	testBatchMatchesSingle();
+	testStatsMatchArrays();
+	testStatsTrades();
+	testTradeList();
+	testTradeExcursions();
+	testTicks();
+	testCompactStorage();
+	testFillModels();
+
+	return btTestResult("testProfitLoss");
+}
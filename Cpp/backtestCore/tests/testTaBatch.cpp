@@ -0,0 +1,199 @@
+// testTaBatch.cpp
+//
+// Unit tests for the TA-Lib compatible period batches.  Each column is checked against a direct
+// evaluation of the TA-Lib algorithm for that period alone.
+
+#include "btTaBatch.h"
+#include "btError.h"
+#include "btTest.h"
+#include <cmath>
+#include <vector>
+
+using namespace std;
+using namespace openAlgo;
+
+static const size_t ROWS = 1500;
+
+struct hlcSeries
+{
+	vector<double> high, low, close;
+
+	hlcSeries()
+	{
+		double px = 2100;
+		for (size_t ii = 0; ii < ROWS; ii++)
+		{
+			px += 3 * sin(ii * 0.11) + cos(ii * 0.67);
+			high.push_back(px + 1 + fabs(sin(ii * 0.41)) * 4);
+			low.push_back(px - 1 - fabs(cos(ii * 0.23)) * 4);
+			close.push_back(px + 2 * sin(ii * 0.57));
+		}
+	}
+};
+
+// TA_SMA | TA_SUM, TA_VAR | TA_STDDEV and TA_ATR | TA_NATR for one period as TA-Lib evaluates them
+static vector<double> naiveWindow(const vector<double> &data, int period, int kind)
+{
+	vector<double> out(data.size(), NAN);
+	for (size_t ii = period - 1; ii < data.size(); ii++)
+	{
+		double sum = 0, sumSq = 0;
+		for (size_t jj = ii + 1 - period; jj <= ii; jj++)
+		{
+			sum += data[jj];
+			sumSq += data[jj] * data[jj];
+		}
+		double mean = sum / period, var = sumSq / period - mean * mean;
+		out[ii] = kind == 0 ? sum : kind == 1 ? mean : kind == 2 ? var : (var < 1e-8 ? 0 : sqrt(var) * 2);
+	}
+	return out;
+}
+
+static vector<double> naiveAtr(const hlcSeries &ser, int period, bool normalized)
+{
+	vector<double> out(ROWS, NAN), tr(ROWS, 0);
+	for (size_t ii = 1; ii < ROWS; ii++)
+		tr[ii] = fmax(ser.high[ii] - ser.low[ii], fmax(fabs(ser.high[ii] - ser.close[ii - 1]), fabs(ser.low[ii] - ser.close[ii - 1])));
+
+	double prev = 0;
+	for (int jj = 1; jj <= period; jj++)
+		prev += tr[jj];
+	prev /= period;
+
+	for (size_t ii = period; ii < ROWS; ii++)
+	{
+		if (ii > size_t(period))
+		{
+			prev *= period - 1;
+			prev += tr[ii];
+			prev /= period;
+		}
+		out[ii] = normalized ? (prev / ser.close[ii]) * 100.0 : prev;
+	}
+	return out;
+}
+
+static void checkColumn(const vector<double> &batch, size_t col, const vector<double> &expected, size_t lookback, double tol)
+{
+	const double *colOut = batch.data() + col * ROWS;
+
+	for (size_t ii = 0; ii < lookback; ii++)
+		BT_CHECK(std::isnan(colOut[ii]));
+	BT_CHECK_ARRAY(colOut + lookback, expected.data() + lookback, ROWS - lookback, tol);
+}
+
+static void testSumSma()
+{
+	hlcSeries ser;
+	vector<int> periods = { 2, 5, 14, 50, 200 };
+	vector<double> sums(ROWS * periods.size()), smas(ROWS * periods.size());
+
+	sumBatch(ser.close, periods, false, sums);
+	sumBatch(ser.close, periods, true, smas, 3);
+
+	for (size_t kk = 0; kk < periods.size(); kk++)
+	{
+		checkColumn(sums, kk, naiveWindow(ser.close, periods[kk], 0), periods[kk] - 1, 1e-6);
+		checkColumn(smas, kk, naiveWindow(ser.close, periods[kk], 1), periods[kk] - 1, 1e-9);
+	}
+}
+
+static void testVarStdDev()
+{
+	hlcSeries ser;
+	vector<int> periods = { 2, 10, 30, 120 };
+	vector<double> vars(ROWS * periods.size()), devs(ROWS * periods.size());
+
+	varBatch(ser.close, periods, false, 1, vars);
+	varBatch(ser.close, periods, true, 2, devs);
+
+	// Both forms lose digits to the level of the prices, in different places
+	for (size_t kk = 0; kk < periods.size(); kk++)
+	{
+		checkColumn(vars, kk, naiveWindow(ser.close, periods[kk], 2), periods[kk] - 1, 1e-5);
+		checkColumn(devs, kk, naiveWindow(ser.close, periods[kk], 3), periods[kk] - 1, 1e-5);
+	}
+
+	// A flat window has no deviation
+	vector<double> flat(50, 1234.5), flatDev(50);
+	vector<int> one = { 7 };
+	varBatch(flat, one, true, 1, flatDev);
+	for (size_t ii = 6; ii < 50; ii++)
+		BT_CHECK_NEAR(flatDev[ii], 0, 0);
+}
+
+// A flat window at the end of a long drifting series has no deviation.  Sums over the whole series
+// would leave meanSq - mean^2 to cancel catastrophically.
+static void testLongDrift()
+{
+	const size_t rows = 2000000;
+	vector<double> drift(rows);
+	unsigned seed = 7;
+	double px = 1000;
+
+	for (size_t ii = 0; ii < rows - 10; ii++)
+	{
+		seed = seed * 1103515245u + 12345u;
+		px += ((seed >> 16) % 2001) / 1000.0 - 1.0 + 0.002;
+		drift[ii] = px;
+	}
+	for (size_t ii = rows - 10; ii < rows; ii++)
+		drift[ii] = px;
+
+	vector<int> periods = { 10 };
+	vector<double> devs(rows), vars(rows);
+
+	varBatch(drift, periods, true, 1, devs);
+	varBatch(drift, periods, false, 1, vars);
+	BT_CHECK_NEAR(devs[rows - 1], 0, 0);
+	BT_CHECK_NEAR(vars[rows - 1], 0, 1e-5);
+}
+
+// ATR | NATR follow TA-Lib's operations so they match exactly
+static void testAtr()
+{
+	hlcSeries ser;
+	vector<int> periods = { 2, 14, 20, 99 };
+	vector<double> atr(ROWS * periods.size()), natr(ROWS * periods.size());
+
+	atrBatch(ser.high, ser.low, ser.close, periods, false, atr);
+	atrBatch(ser.high, ser.low, ser.close, periods, true, natr, 2);
+
+	for (size_t kk = 0; kk < periods.size(); kk++)
+	{
+		checkColumn(atr, kk, naiveAtr(ser, periods[kk], false), periods[kk], 0);
+		checkColumn(natr, kk, naiveAtr(ser, periods[kk], true), periods[kk], 0);
+	}
+
+	// Fewer observations than the lookback give an all NaN column
+	vector<double> shortOut(10);
+	vector<int> longPeriod = { 30 };
+	atrBatch(span<const double>(ser.high.data(), 10), span<const double>(ser.low.data(), 10),
+		span<const double>(ser.close.data(), 10), longPeriod, false, shortOut);
+	for (size_t ii = 0; ii < 10; ii++)
+		BT_CHECK(std::isnan(shortOut[ii]));
+}
+
+static void testBadInputs()
+{
+	hlcSeries ser;
+	vector<double> out(ROWS * 2);
+	vector<int> bad = { 14, 1 }, good = { 14, 20 }, none;
+
+	BT_CHECK_THROWS(sumBatch(ser.close, bad, true, out), btError);
+	BT_CHECK_THROWS(sumBatch(ser.close, none, true, out), btError);
+	BT_CHECK_THROWS(atrBatch(ser.high, ser.low, ser.close, bad, false, out), btError);
+	BT_CHECK_THROWS(atrBatch(span<const double>(ser.high.data(), 10), ser.low, ser.close, good, false, out), btError);
+	BT_CHECK_THROWS(varBatch(ser.close, good, false, 1, span<double>(out.data(), ROWS)), btError);
+}
+
+int main()
+{
+	testSumSma();
+	testVarStdDev();
+	testLongDrift();
+	testAtr();
+	testBadInputs();
+
+	return btTestResult("testTaBatch");
+}
@@ -7,7 +7,7 @@ double sign(double num);
 // Return true if given variable has a fractional component.
 bool fraction(double num);
 
-#endif MYMATH_H 
+#endif // MYMATH_H
 
 //
 //  -------------------------------------------------------------------------
@@ -8,10 +8,18 @@
 //
 // Matlab function:
 // [cash,openEQ,netLiq,returns] = calcProfitLoss(data,sig,bigPoint,cost)
+// [cash,openEQ,netLiq,returns,trades] = calcProfitLoss(data,sig,bigPoint,cost)
+// [stats,trades] = calcProfitLoss(data,sig,bigPoint,cost,'Mode','stats')
+// [...] = calcProfitLoss(...,'Fill','close','SlippageTicks',1,'MinTick',0.25)
+// [...] = calcProfitLoss(...,'Arithmetic','ticks','MinTick',0.25)
 // 
 // Inputs:
-//		data		A 2-D array of prices in the form of Open | Close
+//		data		A 2-D array of prices in the form of Open | Close or Open | High | Low | Close
 //		sig		An array the same length as data, which gives the quantity bought or sold on a given bar.  Consider Matlab remEchosMEX
+//				A matrix of K signal columns is evaluated column by column against the same data (batched sweep).
+//
+//		'data' may be double or single and 'sig' double, single or int8 (whole quantities only).  Compact inputs halve
+//		the bytes streamed by large sweeps.  They are widened as they are read so the ledger and outputs stay double.
 //		bigPoint	Double representing the full tick dollar value of the contract being P&L'd
 //		cost		Double representing the per contract commission
 //
@@ -21,6 +29,32 @@
 //		netLiq		A 2D array of aggregated cash transactions plus the current openEQ if any up to a given observation
 //		returns		A 2D array of bar to bar returns
 //
+//		Each output has one column per column of 'sig'.
+//
+//	'Mode','stats' returns only a 1 x K struct array of summary statistics (one element per column of 'sig')
+//	and never allocates the four full length outputs:
+//		bars meanReturn varReturn stdReturn sharpe maxDrawdown trades winners winRate grossProfit grossLoss netProfit netLiq
+//	'sharpe' equals sharpe(returns,0).  A trade is a closing fill against an open line item.
+//
+//	The optional 'trades' output is a 1 x K struct array (one element per column of 'sig') with one
+//	row per trade in each field:
+//		entryIndex exitIndex quantity entryPrice exitPrice pnl mae mfe
+//	'entryIndex' and 'exitIndex' are the (1 based) signals that opened and closed the line item.  Both
+//	fill on the following observation.  'quantity' is the signed quantity closed and 'pnl' is net of cost.
+//	'mae' and 'mfe' are the worst and best open P&L of the trade from its entry fill up to its exit
+//	fill (before cost).  They require O | H | L | C data and are empty otherwise.
+//
+//	Fill options (name-value pairs, may be combined with 'Mode'):
+//		'Fill'		'open' (default) | 'close' | 'vwap'.  Price of the observation after the signal.
+//				'vwap' is the typical price (H+L+C)/3 and requires O | H | L | C data.
+//		'SlippageTicks'	Adverse ticks added to every purchase and subtracted from every sale (default 0)
+//		'MinTick'	Tick size used with 'SlippageTicks' (default 0)
+//		'RangeSpread'	Adverse fraction of the fill observation's High - Low (default 0).  Requires O | H | L | C data.
+//
+//	'Arithmetic','ticks' runs the ledger in whole ticks of 'MinTick' (full mode without 'trades' only).
+//	Every fill and Close must be on a tick.  P&L is summed as integer ticks and contracts and only scaled
+//	by bigPoint and cost on output, so netLiq has no accumulated rounding.  The default is 'double'.
+//
 //	NOTE: This function accepts both advanced (fractional) and standard SIGNAL inputs
 //
 //		By leveraging fractions as additional logic, we are able to construct more meaningful signals beyond the scope of a simple Buy or Sell of quantity X.
@@ -59,65 +93,222 @@
 //			SIGNAL		=	55		SIGNAL		=	5.5
 //			final NET	=	5		final NET	=	5
 //
+//	The ledger logic lives in the MEX-free backtest core (Cpp/backtestCore/btProfitLoss.cpp).
+//	This gateway only validates the MatLab inputs and wraps the mxArray buffers.
+//	Multiple signal columns are processed in parallel across the available cores.
+//
+//		mex calcProfitLoss.cpp @mexOpts.txt
+//
 
 #include "mex.h"
-#include <deque>
-#include <cmath>
-#include "myMath.h"
+#include <cstring>
+#include <cctype>
+#include <vector>
+#include <cstdint>
+#include "btProfitLoss.h"
+#include "btError.h"
+
+using namespace openAlgo;
+
+// Macros
+#define isReal2DfullDouble(P) (!mxIsComplex(P) && mxGetNumberOfDimensions(P) == 2 && !mxIsSparse(P) && mxIsDouble(P))
+#define isRealScalar(P) (isReal2DfullDouble(P) && mxGetNumberOfElements(P) == 1)
+#define isReal2Dfull(P) (!mxIsComplex(P) && mxGetNumberOfDimensions(P) == 2 && !mxIsSparse(P))
 
-// Declare external reference to undocumented C function
-#ifdef __cplusplus
-extern "C"
+// Columns of 'data' (O | C or O | H | L | C) viewed in place as 'T'
+// The Close is the last column of either form
+template <typename T>
+static basicOhlcSeries<T> dataSeries(const mxArray *data)
 {
-#endif
+	const T *dataPtr = static_cast<const T *>(mxGetData(data));
+	const size_t rows = mxGetM(data);
+	const size_t cols = mxGetN(data);
+
+	basicOhlcSeries<T> bars;
+	bars.open = span<const T>(dataPtr, rows);
+	bars.close = span<const T>(dataPtr + rows * (cols - 1), rows);
+	if (cols == 4)
+	{
+		bars.high = span<const T>(dataPtr + rows, rows);
+		bars.low = span<const T>(dataPtr + rows * 2, rows);
+	}
+	return bars;
+}
 
-	mxArray *mxCreateSharedDataCopy(const mxArray *pr);
-	// and any other prototypes for undocumented API functions you are using
+// Call fn(bars, sig) with 'sig' viewed in its storage class
+template <typename T, typename Fn>
+static void withSignal(const basicOhlcSeries<T> &bars, const mxArray *sig, Fn &&fn)
+{
+	const size_t count = mxGetNumberOfElements(sig);
 
-#ifdef __cplusplus
+	if (mxIsSingle(sig))
+		fn(bars, span<const float>(static_cast<const float *>(mxGetData(sig)), count));
+	else if (mxIsInt8(sig))
+		fn(bars, span<const int8_t>(static_cast<const int8_t *>(mxGetData(sig)), count));
+	else
+		fn(bars, span<const double>(mxGetPr(sig), count));
 }
-#endif
 
-using namespace std;
+// Call fn(bars, sig) with 'data' and 'sig' viewed in their storage classes
+template <typename Fn>
+static void withStorage(const mxArray *data, const mxArray *sig, Fn &&fn)
+{
+	if (mxIsSingle(data))
+		withSignal(dataSeries<float>(data), sig, fn);
+	else
+		withSignal(dataSeries<double>(data), sig, fn);
+}
 
-// Create a struct for convenience
-typedef struct tradeEntry
+// 1 x K struct array of trade lists
+static mxArray *createTrades(const std::vector<tradeList> &trades)
 {
-	int index;
-	int quantity;
-	double price;
-} tradeEntry;
+	const char *fields[] = { "entryIndex", "exitIndex", "quantity", "entryPrice", "exitPrice", "pnl", "mae", "mfe" };
+	mxArray *tradesOut = mxCreateStructMatrix(1, trades.size(), 8, fields);
 
-// Prototypes
-tradeEntry createLineEntry(int ID, int qty, double price);
-int sumQty(const deque<tradeEntry>& x);
-bool fraction(double num);
-bool knownAdvSig(double advSig);
+	for (size_t col = 0; col < trades.size(); col++)
+	{
+		const tradeList &tl = trades[col];
+		const size_t rows = tl.size();
+
+		mxArray *entryIndex = mxCreateDoubleMatrix(rows, 1, mxREAL);
+		mxArray *exitIndex = mxCreateDoubleMatrix(rows, 1, mxREAL);
+		mxArray *quantity = mxCreateDoubleMatrix(rows, 1, mxREAL);
+		mxArray *entryPrice = mxCreateDoubleMatrix(rows, 1, mxREAL);
+		mxArray *exitPrice = mxCreateDoubleMatrix(rows, 1, mxREAL);
+		mxArray *pnl = mxCreateDoubleMatrix(rows, 1, mxREAL);
+		mxArray *mae = mxCreateDoubleMatrix(tl.mae.size(), 1, mxREAL);
+		mxArray *mfe = mxCreateDoubleMatrix(tl.mfe.size(), 1, mxREAL);
+
+		for (size_t row = 0; row < rows; row++)
+		{
+			// MatLab indices are 1 based
+			mxGetPr(entryIndex)[row] = tl.entryIndex[row] + 1;
+			mxGetPr(exitIndex)[row] = tl.exitIndex[row] + 1;
+			mxGetPr(quantity)[row] = tl.quantity[row];
+			mxGetPr(entryPrice)[row] = tl.entryPrice[row];
+			mxGetPr(exitPrice)[row] = tl.exitPrice[row];
+			mxGetPr(pnl)[row] = tl.pnl[row];
+		}
 
-// Macros
-#define isReal2DfullDouble(P) (!mxIsComplex(P) && mxGetNumberOfDimensions(P) == 2 && !mxIsSparse(P) && mxIsDouble(P))
-#define isRealScalar(P) (isReal2DfullDouble(P) && mxGetNumberOfElements(P) == 1)
+		// Excursions are only tracked with O | H | L | C data
+		for (size_t row = 0; row < tl.mae.size() && row < tl.mfe.size(); row++)
+		{
+			mxGetPr(mae)[row] = tl.mae[row];
+			mxGetPr(mfe)[row] = tl.mfe[row];
+		}
+
+		mxSetField(tradesOut, col, "entryIndex", entryIndex);
+		mxSetField(tradesOut, col, "exitIndex", exitIndex);
+		mxSetField(tradesOut, col, "quantity", quantity);
+		mxSetField(tradesOut, col, "entryPrice", entryPrice);
+		mxSetField(tradesOut, col, "exitPrice", exitPrice);
+		mxSetField(tradesOut, col, "pnl", pnl);
+		mxSetField(tradesOut, col, "mae", mae);
+		mxSetField(tradesOut, col, "mfe", mfe);
+	}
+
+	return tradesOut;
+}
+
+// Copy a char option into 'buf' in lower case.  Returns false if it is not a string or does not fit.
+static bool getOption(const mxArray *opt, char *buf, mwSize bufLen)
+{
+	if (!mxIsChar(opt) || mxGetString(opt, buf, bufLen) != 0)
+		return false;
+
+	for (char *cc = buf; *cc != '\0'; cc++)
+		*cc = char(tolower((unsigned char)*cc));
+
+	return true;
+}
 
 void mexFunction(int nlhs, mxArray *plhs[], /* Output variables */
 				 int nrhs, const mxArray *prhs[]) /* Input variables */
 {
-	// There are a number of provided functions for interfacing back to Matlab
-	// mexFuncion		The gateway to C.  Required in every C & C++ solution to allow Matlab to call it
-	// mexEvalString	Execute Matlab command
-	// mexCallMatlab	Call Matlab function (.m or .dll) or script
-	// mexPrintf		Print to the Matlab command window
-	// mexErrMsgTxt		Issue error message and exit returning control to Matlab
-	// mexWarnMsgTxt	Issue warning message
-	// mexPrintf("Hello, world!"); /* Do something interesting */
-
 	// Check number of inputs
-	if (nrhs != 4)
+	if (nrhs < 4 || nrhs % 2 != 0)
 		mexErrMsgIdAndTxt( "MATLAB:calcProfitLoss:NumInputs",
-		"Number of input arguments is not correct. Aborting (116).");
+		"Number of input arguments is not correct. Aborting.");
+
+	// Optional name-value pairs
+	bool statsMode = false;
+	bool tickMode = false;
+	fillModel fill;
+	for (int opt = 4; opt < nrhs; opt += 2)
+	{
+		char optName[16], optValue[16];
+
+		if (!getOption(prhs[opt], optName, sizeof(optName)))
+			mexErrMsgIdAndTxt( "MATLAB:calcProfitLoss:BadOption",
+			"Supported options are 'Mode', 'Fill', 'Arithmetic', 'SlippageTicks', 'MinTick' and 'RangeSpread'. Aborting.");
+
+		if (strcmp(optName, "mode") == 0)
+		{
+			if (!getOption(prhs[opt + 1], optValue, sizeof(optValue)))
+				optValue[0] = '\0';
+
+			if (strcmp(optValue, "stats") == 0)
+				statsMode = true;
+			else if (strcmp(optValue, "full") == 0)
+				statsMode = false;
+			else
+				mexErrMsgIdAndTxt( "MATLAB:calcProfitLoss:BadOption",
+				"Option 'Mode' must be either 'full' or 'stats'. Aborting.");
+		}
+		else if (strcmp(optName, "arithmetic") == 0)
+		{
+			if (!getOption(prhs[opt + 1], optValue, sizeof(optValue)))
+				optValue[0] = '\0';
+
+			if (strcmp(optValue, "ticks") == 0)
+				tickMode = true;
+			else if (strcmp(optValue, "double") == 0)
+				tickMode = false;
+			else
+				mexErrMsgIdAndTxt( "MATLAB:calcProfitLoss:BadOption",
+				"Option 'Arithmetic' must be either 'double' or 'ticks'. Aborting.");
+		}
+		else if (strcmp(optName, "fill") == 0)
+		{
+			if (!getOption(prhs[opt + 1], optValue, sizeof(optValue)))
+				optValue[0] = '\0';
+
+			if (strcmp(optValue, "open") == 0)
+				fill.base = fillOpen;
+			else if (strcmp(optValue, "close") == 0)
+				fill.base = fillClose;
+			else if (strcmp(optValue, "vwap") == 0)
+				fill.base = fillVWAP;
+			else
+				mexErrMsgIdAndTxt( "MATLAB:calcProfitLoss:BadOption",
+				"Option 'Fill' must be 'open', 'close' or 'vwap'. Aborting.");
+		}
+		else if (strcmp(optName, "slippageticks") == 0 || strcmp(optName, "mintick") == 0 || strcmp(optName, "rangespread") == 0)
+		{
+			if (!isRealScalar(prhs[opt + 1]))
+				mexErrMsgIdAndTxt( "MATLAB:calcProfitLoss:BadOption",
+				"Options 'SlippageTicks', 'MinTick' and 'RangeSpread' must be single scalar doubles. Aborting.");
+
+			double value = mxGetScalar(prhs[opt + 1]);
+			if (optName[0] == 's')
+				fill.slippageTicks = value;
+			else if (optName[0] == 'm')
+				fill.minTick = value;
+			else
+				fill.rangeSpread = value;
+		}
+		else
+			mexErrMsgIdAndTxt( "MATLAB:calcProfitLoss:BadOption",
+			"Supported options are 'Mode', 'Fill', 'Arithmetic', 'SlippageTicks', 'MinTick' and 'RangeSpread'. Aborting.");
+	}
 
-	if (nlhs != 4)
+	if ((!statsMode && nlhs != 4 && nlhs != 5) || (statsMode && nlhs > 2))
 		mexErrMsgIdAndTxt( "MATLAB:calcProfitLoss:NumOutputs",
-		"Number of output assignments is not correct. Aborting (120).");
+		"Number of output assignments is not correct. Aborting.");
+
+	if (tickMode && (statsMode || nlhs == 5))
+		mexErrMsgIdAndTxt( "MATLAB:calcProfitLoss:BadOption",
+		"'Arithmetic','ticks' returns the four full outputs only. Aborting.");
 
 	// Define constants (#define assigns a variable as either a constant or a macro)
 	// Inputs
@@ -130,356 +321,167 @@ void mexFunction(int nlhs, mxArray *plhs[], /* Output variables */
 #define openEQ_OUT	plhs[1]
 #define netLiq_OUT	plhs[2]
 #define returns_OUT	plhs[3]
-
-	// Init Global variables
-	mwSize rowsData, colsData, rowsSig, colsSig;
-	double *cashIdx, *openEQIdx, *netLiqIdx, *returnsIdx, *dataInPtr, *sigInPtr; // *bigPointPtr, *costPtr;
+#define trades_OUT	plhs[4]
 
 	// Check type of supplied inputs
-	if (!isReal2DfullDouble(data_IN)) 
+	if (!isReal2Dfull(data_IN) || !(mxIsDouble(data_IN) || mxIsSingle(data_IN)))
+		mexErrMsgIdAndTxt( "MATLAB:calcProfitLoss:BadInputType",
+		"Input 'data' must be a 2 dimensional full double or single array. Aborting.");
+
+	if (!isReal2Dfull(sig_IN) || !(mxIsDouble(sig_IN) || mxIsSingle(sig_IN) || mxIsInt8(sig_IN)))
 		mexErrMsgIdAndTxt( "MATLAB:calcProfitLoss:BadInputType",
-		"Input 'data' must be a 2 dimensional full double array. Aborting (141).");
+		"Input 'sig' must be a 2 dimensional full double, single or int8 array. Aborting.");
 
-	if (!isReal2DfullDouble(sig_IN)) 
+	if (tickMode && !(mxIsDouble(data_IN) && mxIsDouble(sig_IN)))
 		mexErrMsgIdAndTxt( "MATLAB:calcProfitLoss:BadInputType",
-		"Input 'sig' must be a 2 dimensional full double array. Aborting (145).");
+		"'Arithmetic','ticks' requires double 'data' and 'sig'. Aborting.");
 
 	if (!isRealScalar(bigPoint_IN)) 
 		mexErrMsgIdAndTxt( "MATLAB:calcProfitLoss:BadInputType",
-		"Input 'bigPoint' must be a single scalar double. Aborting (149).");
+		"Input 'bigPoint' must be a single scalar double. Aborting.");
 
 	if (!isRealScalar(cost_IN)) 
 		mexErrMsgIdAndTxt( "MATLAB:calcProfitLoss:BadInputType",
-		"Input 'cost' must be a single scalar double. Aborting (153).");
+		"Input 'cost' must be a single scalar double. Aborting.");
 
 	// Assign variables
-	rowsData = mxGetM(data_IN);
-	colsData = mxGetN(data_IN);
-	rowsSig = mxGetM(sig_IN);
-	colsSig = mxGetN(sig_IN);		
+	mwSize rowsData = mxGetM(data_IN);
+	mwSize colsData = mxGetN(data_IN);
+	mwSize rowsSig = mxGetM(sig_IN);
+	mwSize colsSig = mxGetN(sig_IN);
 
 	if (rowsData != rowsSig)
 		mexErrMsgIdAndTxt( "MATLAB:calcProfitLoss:ArrayMismatch",
-		"The number of rows in the data array and the signal array are different. Aborting (163).");
+		"The number of rows in the data array and the signal array are different. Aborting.");
 
-	if (colsSig > 1)
+	if (colsSig < 1)
 		mexErrMsgIdAndTxt( "MATLAB:calcProfitLoss:ArrayMismatch",
-		"Input 'sig' must be a single column array. Aborting (167).");
+		"Input 'sig' must have at least one column. Aborting.");
 
 	if (colsData != 2 && colsData != 4)
 		mexErrMsgIdAndTxt( "MATLAB:calcProfitLoss:ArrayMismatch",
-		"Input 'data' must be in the form of 'O | C'. Aborting (171).");
+		"Input 'data' must be in the form of 'O | C' or 'O | H | L | C'. Aborting.");
 
-	if (!isRealScalar(bigPoint_IN)) 
-		mexErrMsgIdAndTxt( "MATLAB:calcProfitLoss:ScalarMismatch",
-		"Input 'bigPoint' must be a double scalar value. Aborting (175).");
+	if (fill.needsRange() && colsData != 4)
+		mexErrMsgIdAndTxt( "MATLAB:calcProfitLoss:ArrayMismatch",
+		"The 'vwap' fill and 'RangeSpread' require data in the form of 'O | H | L | C'. Aborting.");
 
-	if (!isRealScalar(cost_IN))  
-		mexErrMsgIdAndTxt( "MATLAB:calcProfitLoss:ScalarMismatch",
-		"Input 'cost' must be a double scalar value. Aborting (179).");
+	const double bigPoint = mxGetScalar(bigPoint_IN);
+	const double cost = mxGetScalar(cost_IN);
 
-	// Primarily for readability
-	int shifter = 1;
-	if (colsData == 4)
-	{
-		shifter = 3;
-	}
+	// mexErrMsgIdAndTxt does not return so errors are raised after the exception is released
+	char errId[128] = "";
+	char errMsg[256] = "";
 
-	const int SHIFT_OPEN = 0;								// For readability
-	const int SHIFT_CLOSE = rowsData * shifter;
+	// The trade list is only collected when it is asked for.  Both lists are sized inside the try
+	// blocks so a failed allocation is raised like any other error.
+	const bool wantTrades = statsMode ? (nlhs == 2) : (nlhs == 5);
+	std::vector<tradeList> trades;
 
-	/* Create matrices for the return arguments */ 
-	// http://www.mathworks.com/help/matlab/matlab_external/c-c-source-mex-files.html
-	cash_OUT = mxCreateDoubleMatrix(rowsData, 1, mxREAL);
-	openEQ_OUT = mxCreateDoubleMatrix(rowsData, 1, mxREAL); 
-	netLiq_OUT = mxCreateDoubleMatrix(rowsData, 1, mxREAL); 
-	returns_OUT = mxCreateDoubleMatrix(rowsData, 1, mxREAL); 
-
-	/* Assign pointers to the arrays */ 
-	dataInPtr = mxGetPr(prhs[0]);
-	sigInPtr = mxGetPr(prhs[1]);
-
-	// assign values to the two variables passed as arrays
-	const double BIG_POINT = mxGetScalar(bigPoint_IN);
-	const double COST = mxGetScalar(cost_IN);
-
-	// assign the index variables for manipulating the arrays 
-	cashIdx = mxGetPr(cash_OUT);
-	openEQIdx = mxGetPr(openEQ_OUT);
-	netLiqIdx = mxGetPr(netLiq_OUT);
-	returnsIdx = mxGetPr(returns_OUT);
-
-	// START //
-	// Initialize variables
-	int	sigIdx;					// Iterator that will store the index of the referenced signal
-	int barIdx;					// Iterator that will store the index of the referenced bar
-	bool anyTrades = false;				// Variable that indicates if we have any trades
-
-	// Check that we have at least one signal (at least one trade)
-	for (sigIdx=0; sigIdx < rowsSig; sigIdx++)	// Remember C++ starts counting at '0'
+	if (statsMode)
 	{
-		if (abs(sigInPtr[sigIdx]) >=1)		// See if we have a signal that generates a position
+		std::vector<plStats> stats;
+
+		try
 		{
-			anyTrades=true;			// Trade found
-			break;				// Exit the for loop
+			trades.resize(wantTrades ? colsSig : 0);
+			stats.resize(colsSig);
+			withStorage(data_IN, sig_IN, [&](const auto &bars, auto sig)
+			{
+				calcProfitLossStatsBatch(bars, sig, colsSig, bigPoint, cost, fill, stats, 0, wantTrades ? trades.data() : NULL);
+			});
+		}
+		catch (const btError &err)
+		{
+			strncpy(errId, err.id(), sizeof(errId) - 1);
+			strncpy(errMsg, err.what(), sizeof(errMsg) - 1);
+		}
+		catch (const std::exception &err)
+		{
+			strncpy(errId, "MATLAB:calcProfitLoss:Internal", sizeof(errId) - 1);
+			strncpy(errMsg, err.what(), sizeof(errMsg) - 1);
 		}
-	}	
-
-	// We have trades
-	// RETURN zeros if the signal is the last bar
-	if (anyTrades && sigIdx < rowsSig)
-	{
-		// Initialize a ledger for open positions
-		deque<tradeEntry> openLedger;
 
-		// Put first trade on ledger
-		// price is 'sigIdx+1' because execution price lags signal by one observation
-		// We only need the integer portion of the first trade
-		openLedger.push_back(createLineEntry(sigIdx, int(sigInPtr[sigIdx]), dataInPtr[sigIdx+1]));
+		if (errId[0] != '\0')
+			mexErrMsgIdAndTxt(errId, "%s", errMsg);
 
-		// Initialize position trackers
-		int openPosition = int(sigInPtr[sigIdx]);
+		const char *fields[] = { "bars", "meanReturn", "varReturn", "stdReturn", "sharpe", "maxDrawdown",
+			"trades", "winners", "winRate", "grossProfit", "grossLoss", "netProfit", "netLiq" };
+		plhs[0] = mxCreateStructMatrix(1, colsSig, 13, fields);
 
-		// ITERATE
-		// Start iterating at next observation
-		// Finish at observation before last in signal array
-		for (int ii = sigIdx+1; ii < rowsSig-1; ii++)
+		for (mwSize col = 0; col < colsSig; col++)
 		{
-			if (sigInPtr[ii] != 0)
-			{
-				// Is this an advanced signal?
-				if (fraction(sigInPtr[ii]))
-					// Advanced signal
-				{
-					// Check for known advanced signal type
-					if (knownAdvSig(sigInPtr[ii]))
-					// Known
-					{
-						// Check for additive or reductive
-						if ((openPosition <= 0 && sigInPtr[ii] <= -1) || (openPosition >= 0 && sigInPtr[ii] >= 1))
-						// Additive
-						{
-							// We ignore reverse advance instructions when they are additive
-						}
-						// Reductive
-						else
-						{
-							// Confirm instruction is fractional reverse
-							if (abs(sigInPtr[ii] - int(sigInPtr[ii])) == 0.5)			// Reverse instruction
-							{
-								// Liquidate any open position
-								while (!openLedger.empty())
-								{
-									// Aggregate cash for corresponding observations (signal + 1)
-									cashIdx[ii+1] = cashIdx[ii+1] + ((dataInPtr[ii+1] - openLedger.front().price) * openLedger.front().quantity * BIG_POINT) - 
-										(abs(openLedger.front().quantity)* COST);
-									openLedger.pop_front();
-								}
-
-								openPosition = 0;
-							}
-							else
-							{
-								//	This is here for ease of adding additional instructions later.
-								// Unknown advanced signal.  Throw an error.
-								mexErrMsgIdAndTxt( "calcProfitLoss:AdvancedSignal:fractionUnknown",
-									"A signal contained an advanced fractional instruction %f that we could not interpret. Aborting (286).",sigInPtr[ii]);
-							}
-						}
-					}
-					else
-						// Unknown instruction
-					{
-						// Unknown advanced signal.  Throw an error.
-						mexErrMsgIdAndTxt( "calcProfitLoss:AdvancedSignal:fractionUnknown",
-							"A signal contained an advanced fractional instruction %f that we could not interpret. Aborting (295).",sigInPtr[ii]);
-					}
-				}
-
-				// Any integer and if so Additive or reductive ?
-				if ((openPosition <= 0 && sigInPtr[ii] <= -1) || (openPosition >= 0 && sigInPtr[ii] >= 1))
-					// Additive
-				{
-					// Trade is additive. Add or create existing position --> openLedger
-					openLedger.push_back(createLineEntry(ii, int(sigInPtr[ii]), dataInPtr[ii+1]));
-					openPosition = openPosition + int(sigInPtr[ii]);
-				}
-				// Reductive
-				else
-				{
-					// Signal is effectively a reverse or liquidate
-					if (int(abs(sigInPtr[ii])) >= abs(openPosition))
-					{
-						// New trade is larger than or equal to existing position. Calculate cash on all ledger lines
-						while (!openLedger.empty())
-						{
-							// Aggregate cash for corresponding observations (signal + 1)
-							cashIdx[ii+1] = cashIdx[ii+1] + ((dataInPtr[ii+1] - openLedger.front().price) * openLedger.front().quantity * BIG_POINT) - 
-								(abs(openLedger.front().quantity)* COST);
-							openLedger.pop_front();
-						}
-
-						// update open position tracker
-						openPosition = int(sigInPtr[ii]) + openPosition;
-
-						// if there is a 'remainder', this is the new net open position
-						// put it on the openLedger
-						if (openPosition != 0)
-						{
-							openLedger.push_back(createLineEntry(ii,openPosition,dataInPtr[ii+1]));
-						}
-					}
-					// partial liquidation
-					else
-					{
-						// New trade is smaller than the current open position.
-						// How many do we need to reduce by?
-						int needQty = sigInPtr[ii];
-
-						// Prepare to iterate until we are satisfied
-						while (needQty !=0)
-						{
-							// Is the current line item quantity larger than what we need?
-							if (abs(openLedger.front().quantity) > needQty)
-							{
-								// If so we will P&L the quantity we need and reduce the open position size
-								cashIdx[ii+1] = cashIdx[ii+1] + ((dataInPtr[ii+1] - openLedger.front().price) * -needQty * BIG_POINT) - 
-									(abs(needQty) * COST);
-								// Reduce the position size.  We are aggregating so we add (e.g. 5 Purchases + 4 Sales = 1 Long)
-								openLedger.front().quantity = openLedger.front().quantity + needQty;
-								// We are satisfied and don't need any more contracts
-								needQty = 0;
-							}
-							// Current line item quantity is equal to or smaller than what we need.  Process P&L and remove.
-							else
-							{
-								// P&L entire quantity
-								cashIdx[ii+1] = cashIdx[ii+1] + ((dataInPtr[ii+1] - openLedger.front().price) * -openLedger.front().quantity * BIG_POINT) - 
-									(abs(openLedger.front().quantity) * COST);
-								// Reduce needed quantity by what we've been provided
-								needQty = needQty + openLedger.front().quantity;
-								// Remove the line item (FIFO)
-								openLedger.pop_front();
-							}
-						}
-						// update open position tracker
-						openPosition = openPosition + sigInPtr[ii];
-					}
-				}
-
-			}
-
-			// Calculate current openEQ if there are any positions
-			// !!!!!!!!!!!!!!!!!!!!!!
-			// !! IMPORTANT
-			// !!!!!!!!!!!!!!!!!!!!!!
-			// Because we are using virtual bars for calculations, we have introduced a known issue
-			// that a profit may occur within an observation High or Low.  To offset this we will
-			// clean certain openEQ calculations below. This will cause some invalid depictions
-			// of open equity between observations but would be effectively be a margining issue
-			if (openPosition != 0)
-			{
-				//// We will aggregate all line items
-				for (int jj = 0; jj < openLedger.size(); jj++)
-				{
-					openEQIdx[ii+1] = openEQIdx[ii+1] + ((dataInPtr[ii+1+SHIFT_CLOSE] - openLedger[jj].price) * openLedger[jj].quantity * BIG_POINT);
-				}
-			}
-		} // end for
+			const plStats &st = stats[col];
+			mxSetField(plhs[0], col, "bars", mxCreateDoubleScalar(double(st.bars)));
+			mxSetField(plhs[0], col, "meanReturn", mxCreateDoubleScalar(st.meanReturn));
+			mxSetField(plhs[0], col, "varReturn", mxCreateDoubleScalar(st.varReturn));
+			mxSetField(plhs[0], col, "stdReturn", mxCreateDoubleScalar(st.stdReturn));
+			mxSetField(plhs[0], col, "sharpe", mxCreateDoubleScalar(st.sharpe));
+			mxSetField(plhs[0], col, "maxDrawdown", mxCreateDoubleScalar(st.maxDrawdown));
+			mxSetField(plhs[0], col, "trades", mxCreateDoubleScalar(double(st.trades)));
+			mxSetField(plhs[0], col, "winners", mxCreateDoubleScalar(double(st.winners)));
+			mxSetField(plhs[0], col, "winRate", mxCreateDoubleScalar(st.winRate));
+			mxSetField(plhs[0], col, "grossProfit", mxCreateDoubleScalar(st.grossProfit));
+			mxSetField(plhs[0], col, "grossLoss", mxCreateDoubleScalar(st.grossLoss));
+			mxSetField(plhs[0], col, "netProfit", mxCreateDoubleScalar(st.netProfit));
+			mxSetField(plhs[0], col, "netLiq", mxCreateDoubleScalar(st.netLiq));
+		}
 
-		// destroy the deque
-		openLedger.~deque();
+		if (wantTrades)
+			plhs[1] = createTrades(trades);
 
-		// These are for convenience and could be removed for optimization
+		return;
+	}
 
-		// Calculate a cumulative sum of closed trades and open equity per observation
+	/* Create matrices for the return arguments */ 
+	// http://www.mathworks.com/help/matlab/matlab_external/c-c-source-mex-files.html
+	cash_OUT = mxCreateDoubleMatrix(rowsData, colsSig, mxREAL);
+	openEQ_OUT = mxCreateDoubleMatrix(rowsData, colsSig, mxREAL); 
+	netLiq_OUT = mxCreateDoubleMatrix(rowsData, colsSig, mxREAL); 
+	returns_OUT = mxCreateDoubleMatrix(rowsData, colsSig, mxREAL); 
+
+	// The core writes directly into the MatLab output buffers
+	plOutputs out;
+	out.cash = span<double>(mxGetPr(cash_OUT), rowsData * colsSig);
+	out.openEQ = span<double>(mxGetPr(openEQ_OUT), rowsData * colsSig);
+	out.netLiq = span<double>(mxGetPr(netLiq_OUT), rowsData * colsSig);
+	out.returns = span<double>(mxGetPr(returns_OUT), rowsData * colsSig);
+
+	try
+	{
+		trades.resize(wantTrades ? colsSig : 0);
+		out.trades = wantTrades ? trades.data() : NULL;
 
-		// This loop is a 'dirty' cleaning of trades that were closed on the next observation.
-		// Because we are creating a vBar for profit objectives, if the openEquity is greater than the next
-		// observation's cash, we'll reduce openEquity to equal cash.  This should normalize some spikes.
-		for (int ll = 1; ll < rowsData - 1; ll++)
+		if (tickMode)
+			calcProfitLossTicksBatch(dataSeries<double>(data_IN), span<const double>(mxGetPr(sig_IN), rowsSig * colsSig),
+				colsSig, fill.minTick, bigPoint, cost, fill, out);
+		else
 		{
-			if (openEQIdx[ll] != cashIdx[ll+1] && openEQIdx[ll+1] == 0 && cashIdx[ll+1] > 0)
+			// A single column runs on the calling thread
+			withStorage(data_IN, sig_IN, [&](const auto &bars, auto sig)
 			{
-				openEQIdx[ll] = cashIdx[ll+1];
-			}
+				calcProfitLossBatch(bars, sig, colsSig, bigPoint, cost, fill, out);
+			});
 		}
-
-		double runSum = 0;
-		returnsIdx[0] = 0;
-		for (int kk=0; kk < rowsData; kk++)
-		{
-			runSum = runSum + cashIdx[kk];
-			netLiqIdx[kk] = runSum + openEQIdx[kk];
-
-			// Calculate a return from day to day based on the change in value observation to observation
-			if (kk>0)
-			{
-				returnsIdx[kk] = netLiqIdx[kk] - netLiqIdx[kk-1];
-			}
-
-		} //for
-
 	}
-	// No trades or signal on the last observation. Return zeros.
-	else
+	catch (const btError &err)
 	{
-		for (int mm=0; mm < rowsData; mm++)
-		{
-			cashIdx[mm] = 0;
-			openEQIdx[mm]=0;
-			netLiqIdx[mm]=0;
-			returnsIdx[mm]=0;
-		}
+		strncpy(errId, err.id(), sizeof(errId) - 1);
+		strncpy(errMsg, err.what(), sizeof(errMsg) - 1);
 	}
-
-	return;
-}
-
-/////////////
-//
-// FUNCTIONS & METHODS
-//
-/////////////
-
-// Constructor for ledger line item creation
-tradeEntry createLineEntry(int ID, int qty, double price)
-{
-	tradeEntry lineEntry;
-	lineEntry.index = ID;
-	lineEntry.quantity = qty;
-	lineEntry.price = price;
-
-	return lineEntry;
-}
-
-// Method to sum the quantity values in any struct of type tradeEntry
-int sumQty(const deque<tradeEntry>& x)
-{
-	int sumOfQty = 0;  // the sum is accumulated here
-	for (deque<tradeEntry>::const_iterator it=x.begin();it!=x.end();it++)
+	catch (const std::exception &err)
 	{
-		//sumOfQty += x[i].price;
-		sumOfQty += it->quantity;
+		strncpy(errId, "MATLAB:calcProfitLoss:Internal", sizeof(errId) - 1);
+		strncpy(errMsg, err.what(), sizeof(errMsg) - 1);
 	}
 
-	return sumOfQty;
-}
-
-bool knownAdvSig(double advSig)
-{
-	// We can check for known advanced signals to help in debugging
-	// by registering them here.  This can be a searchable array when
-	// more than one advanced signal exists.
-	// For now we only need to check for |0.5|
+	if (errId[0] != '\0')
+		mexErrMsgIdAndTxt(errId, "%s", errMsg);
 
-	double frac = abs(advSig - int(advSig));
+	if (wantTrades)
+		trades_OUT = createTrades(trades);
 
-	if (frac == 0.5)		// Close any opposing open position
-	{
-		return true;
-	}
-	return false;
+	return;
 }
 
 //
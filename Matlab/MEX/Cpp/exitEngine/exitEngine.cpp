@@ -0,0 +1,295 @@
+// exitEngine.cpp
+//
+// nlhs Number of output variables nargout 
+// plhs Array of mxArray pointers to the output variables varargout
+// nrhs Number of input variables nargin
+// prhs Array of mxArray pointers to the input variables varargin
+//
+// Matlab MEX function:
+// [barsOut,sigOut] = exitEngine(barsIn,sigIn,minTick,Name,Value,...)
+//
+// Inputs:
+//		barsIn		A matrix array of prices in the form of Open | High | Low | Close
+//		sigIn		An 1-D array the same length as barsIn, which gives the quantity bought or sold on a given bar
+//		minTick		Double representing the per contract minimum tick increment
+//
+// Options (each one given enables its exit):
+//		'Target'	Ticks beyond the average price of the open position to take a profit
+//		'Stop'		Ticks against the average price of the open position to stop out
+//		'VolStop'	{vol, mult}	Stop at 'mult' x 'vol' of the entry observation against the average price.
+//				'vol' is an array the same length as sigIn (e.g. ATR).
+//		'Trailing'	Ticks behind the best price since the position was opened
+//		'BreakEven'	Ticks in profit after which the stop moves to the average price
+//		'MaxBars'	Observations in the trade (including the entry observation) before exiting on the Close
+//		'SubBars'	{subBars, barTimes, subTimes}	A finer Open | High | Low | Close series used only for the
+//				observations in which both a stop and the target were reached.  'barTimes' (one per row of
+//				barsIn) and 'subTimes' (one per row of subBars) are ascending end of bar time stamps.
+//
+// Outputs:
+//		barsOut		A 2-D array of prices with the addition of any virtual bars where an exit is taken in the form of Open | High | Low | Close
+//		sigOut		An array the same length as barsOut which includes any exit signals
+//
+//	Same output contract as numTicksProfit so the result can be passed directly to calcProfitLoss.
+//	The exit logic lives in the MEX-free backtest core (Cpp/backtestCore/btExits.cpp).
+//
+//		mex exitEngine.cpp @mexOpts.txt
+//
+
+#include "mex.h"
+#include <cstring>
+#include <cctype>
+#include <vector>
+#include "btExits.h"
+#include "btError.h"
+
+using namespace openAlgo;
+
+// Macros
+#define isReal2DfullDouble(P) (!mxIsComplex(P) && mxGetNumberOfDimensions(P) == 2 && !mxIsSparse(P) && mxIsDouble(P))
+#define isRealScalar(P) (isReal2DfullDouble(P) && mxGetNumberOfElements(P) == 1)
+
+// Copy a char option into 'buf' in lower case.  Returns false if it is not a string or does not fit.
+static bool getOption(const mxArray *opt, char *buf, mwSize bufLen)
+{
+	if (!mxIsChar(opt) || mxGetString(opt, buf, bufLen) != 0)
+		return false;
+
+	for (char *cc = buf; *cc != '\0'; cc++)
+		*cc = char(tolower((unsigned char)*cc));
+
+	return true;
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], /* Output variables */
+				 int nrhs, const mxArray *prhs[]) /* Input variables */
+{
+	// Check number of inputs
+	if (nrhs < 3 || nrhs % 2 != 1)
+		mexErrMsgIdAndTxt( "MATLAB:exitEngine:NumInputs",
+		"Number of input arguments is not correct. Aborting.");
+	// Check number of output assignments
+	if (nlhs != 2)
+		mexErrMsgIdAndTxt( "MATLAB:exitEngine:NumOutputs",
+		"Number of output assignments is not correct. Aborting.");
+
+	// Define constants (#define assigns a variable as either a constant or a macro)
+	// Inputs
+#define bars_IN		prhs[0]
+#define sig_IN		prhs[1]
+#define minTick_IN	prhs[2]
+	// Outputs
+#define bars_OUT	plhs[0]
+#define sig_OUT		plhs[1]
+
+	// Check type of supplied inputs
+	if (!isReal2DfullDouble(bars_IN) || mxGetN(bars_IN) != 4)
+		mexErrMsgIdAndTxt( "MATLAB:exitEngine:BadInputType",
+		"Input 'barsIn' must be a 2 dimensional full double array of type Open | High | Low | Close. Aborting.");
+
+	if (!isReal2DfullDouble(sig_IN) || mxGetN(sig_IN) > 1)
+		mexErrMsgIdAndTxt( "MATLAB:exitEngine:BadInputType",
+		"Input 'sigIn' must be a single column full double array. Aborting.");
+
+	if (!isRealScalar(minTick_IN))
+		mexErrMsgIdAndTxt( "MATLAB:exitEngine:BadInputType",
+		"Input 'minTick' must be a single scalar double. Aborting.");
+
+	// Assign variables
+	mwSize rows = mxGetM(bars_IN);
+
+	if (mxGetM(sig_IN) != rows)
+		mexErrMsgIdAndTxt( "MATLAB:exitEngine:ArrayMismatch",
+		"The number of rows in the price array and the signal array are different. Aborting.");
+
+	exitParams params;
+	params.minTick = mxGetScalar(minTick_IN);
+	std::vector<size_t> subIndex;
+
+	// Name-value pairs.  Each option enables its exit.
+	for (int opt = 3; opt < nrhs; opt += 2)
+	{
+		char optName[16];
+		const mxArray *value = prhs[opt + 1];
+
+		if (!getOption(prhs[opt], optName, sizeof(optName)))
+			mexErrMsgIdAndTxt( "MATLAB:exitEngine:BadOption",
+			"Supported options are 'Target', 'Stop', 'VolStop', 'Trailing', 'BreakEven', 'MaxBars' and 'SubBars'. Aborting.");
+
+		if (strcmp(optName, "volstop") == 0)
+		{
+			if (!mxIsCell(value) || mxGetNumberOfElements(value) != 2 ||
+				!isReal2DfullDouble(mxGetCell(value, 0)) || mxGetNumberOfElements(mxGetCell(value, 0)) != rows ||
+				!isRealScalar(mxGetCell(value, 1)))
+				mexErrMsgIdAndTxt( "MATLAB:exitEngine:BadOption",
+				"Option 'VolStop' must be {vol, mult} with 'vol' the same length as 'sigIn'. Aborting.");
+
+			params.kinds |= exitVolStop;
+			params.vol = span<const double>(mxGetPr(mxGetCell(value, 0)), rows);
+			params.volMult = mxGetScalar(mxGetCell(value, 1));
+			continue;
+		}
+
+		if (strcmp(optName, "subbars") == 0)
+		{
+			if (!mxIsCell(value) || mxGetNumberOfElements(value) != 3 ||
+				!isReal2DfullDouble(mxGetCell(value, 0)) || mxGetN(mxGetCell(value, 0)) != 4 ||
+				!isReal2DfullDouble(mxGetCell(value, 1)) || mxGetNumberOfElements(mxGetCell(value, 1)) != rows ||
+				!isReal2DfullDouble(mxGetCell(value, 2)) ||
+				mxGetNumberOfElements(mxGetCell(value, 2)) != mxGetM(mxGetCell(value, 0)))
+				mexErrMsgIdAndTxt( "MATLAB:exitEngine:BadOption",
+				"Option 'SubBars' must be {subBars, barTimes, subTimes} with one time stamp per row. Aborting.");
+
+			mwSize subRows = mxGetM(mxGetCell(value, 0));
+			const double *subPtr = mxGetPr(mxGetCell(value, 0));
+			params.subBars.open = span<const double>(subPtr, subRows);
+			params.subBars.high = span<const double>(subPtr + subRows, subRows);
+			params.subBars.low = span<const double>(subPtr + 2 * subRows, subRows);
+			params.subBars.close = span<const double>(subPtr + 3 * subRows, subRows);
+
+			subIndex = subBarIndex(span<const double>(mxGetPr(mxGetCell(value, 1)), rows),
+				span<const double>(mxGetPr(mxGetCell(value, 2)), subRows));
+			params.subIndex = subIndex;
+			continue;
+		}
+
+		if (!isRealScalar(value))
+			mexErrMsgIdAndTxt( "MATLAB:exitEngine:BadOption",
+			"Option '%s' must be a single scalar double. Aborting.", optName);
+
+		if (strcmp(optName, "target") == 0)
+		{
+			params.kinds |= exitTarget;
+			params.targetTicks = mxGetScalar(value);
+		}
+		else if (strcmp(optName, "stop") == 0)
+		{
+			params.kinds |= exitStop;
+			params.stopTicks = mxGetScalar(value);
+		}
+		else if (strcmp(optName, "trailing") == 0)
+		{
+			params.kinds |= exitTrailing;
+			params.trailTicks = mxGetScalar(value);
+		}
+		else if (strcmp(optName, "breakeven") == 0)
+		{
+			params.kinds |= exitBreakEven;
+			params.breakEvenTicks = mxGetScalar(value);
+		}
+		else if (strcmp(optName, "maxbars") == 0)
+		{
+			params.kinds |= exitMaxBars;
+			params.maxBars = int(mxGetScalar(value));
+		}
+		else
+			mexErrMsgIdAndTxt( "MATLAB:exitEngine:BadOption",
+			"Supported options are 'Target', 'Stop', 'VolStop', 'Trailing', 'BreakEven', 'MaxBars' and 'SubBars'. Aborting.");
+	}
+
+	// The mxArray is passed as a continuous 1 dimensional array concatenating all columns
+	const double *barsInPtr = mxGetPr(bars_IN);
+	ohlcSeries bars;
+	bars.open = span<const double>(barsInPtr, rows);
+	bars.high = span<const double>(barsInPtr + rows, rows);
+	bars.low = span<const double>(barsInPtr + 2 * rows, rows);
+	bars.close = span<const double>(barsInPtr + 3 * rows, rows);
+
+	// mexErrMsgIdAndTxt does not return so errors are raised after the exception is released
+	char errId[128] = "";
+	char errMsg[256] = "";
+
+	try
+	{
+		span<const double> sig(mxGetPr(sig_IN), rows);
+		std::vector<ntpProfit> exits = exitScan(bars, sig, params);
+
+		if (!exits.empty())
+		{
+			// The merge writes straight into the mxArray buffers
+			mwSize rowsOut = rows + exits.size();
+			bars_OUT = mxCreateDoubleMatrix(rowsOut, 4, mxREAL);
+			sig_OUT = mxCreateDoubleMatrix(rowsOut, 1, mxREAL);
+
+			numTicksProfitMerge(bars, sig, exits, span<double>(mxGetPr(bars_OUT), 4 * rowsOut),
+				span<double>(mxGetPr(sig_OUT), rowsOut));
+		}
+		else
+		{
+			// Return what we were given
+			bars_OUT = mxDuplicateArray(bars_IN);
+			sig_OUT = mxDuplicateArray(sig_IN);
+		}
+	}
+	catch (const btError &err)
+	{
+		strncpy(errId, err.id(), sizeof(errId) - 1);
+		strncpy(errMsg, err.what(), sizeof(errMsg) - 1);
+	}
+	catch (const std::exception &err)
+	{
+		strncpy(errId, "MATLAB:exitEngine:Internal", sizeof(errId) - 1);
+		strncpy(errMsg, err.what(), sizeof(errMsg) - 1);
+	}
+
+	if (errId[0] != '\0')
+		mexErrMsgIdAndTxt(errId, "%s", errMsg);
+
+	return;
+}
+
+//
+//  -------------------------------------------------------------------------
+//                                  _    _ 
+//         ___  _ __   ___ _ __    / \  | | __ _  ___   ___  _ __ __ _ 
+//        / _ \| '_ \ / _ \ '_ \  / _ \ | |/ _` |/ _ \ / _ \| '__/ _` |
+//       | (_) | |_) |  __/ | | |/ ___ \| | (_| | (_) | (_) | | | (_| |
+//        \___/| .__/ \___|_| |_/_/   \_\_|\__, |\___(_)___/|_|  \__, |
+//             |_|                         |___/                 |___/
+//  -------------------------------------------------------------------------
+//        This code is distributed in the hope that it will be useful,
+//
+//                         WITHOUT ANY WARRANTY AND
+//
+//                  WITHOUT CLAIM AS TO MERCHANTABILITY
+//
+//                  OR FITNESS FOR A PARTICULAR PURPOSE
+//
+//                           EXPRESSED OR IMPLIED.
+//
+//   Use of this code, pseudocode, algorithmic or trading logic contained
+//   herein, whether sound or faulty for any purpose is the sole
+//   responsibility of the USER. Any such use of these algorithms, coding
+//   logic or concepts in whole or in part carry no covenant of correctness
+//   or recommended usage from the AUTHOR or any of the possible
+//   contributors listed or unlisted, known or unknown.
+//
+//	 Redistribution and use in source and binary forms, with or without
+//	 modification, are permitted provided that the following conditions are met: 
+//
+//	 1. Redistributions of source code must retain the below copyright notice, 
+//	 this list of conditions and the following disclaimer. 
+//	 2. Redistributions in binary form must reproduce the below copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution. 
+//
+//   The public sharing of this code does not relinquish, reduce, restrict or
+//   encumber any rights the AUTHOR has in respect to claims of intellectual
+//   property.
+//
+//   IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY
+//   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+//   OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+//   STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//   ANY WAY OUT OF THE USE OF THIS SOFTWARE, CODE, OR CODE FRAGMENT(S), EVEN
+//   IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//   -------------------------------------------------------------------------
+//
+//                             ALL RIGHTS RESERVED
+//
+//   -------------------------------------------------------------------------
+//
+//   Author:	Mark Tompkins
+//
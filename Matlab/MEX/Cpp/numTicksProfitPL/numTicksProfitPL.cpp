@@ -0,0 +1,278 @@
+// numTicksProfitPL.cpp
+// nlhs Number of output variables nargout 
+// plhs Array of mxArray pointers to the output variables varargout
+// nrhs Number of input variables nargin
+// prhs Array of mxArray pointers to the input variables varargin
+//
+// Matlab MEX function:
+// stats = numTicksProfitPL(barsIn,sigIn,minTick,numTicks,openAvg,bigPoint,cost)
+// [stats,cash,openEQ,netLiq,returns] = numTicksProfitPL(...)
+// [stats,cash,openEQ,netLiq,returns,barsOut,sigOut] = numTicksProfitPL(...)
+// stats = numTicksProfitPL(barsIn,sigIn,minTick,[numTicks1 numTicks2 ...],openAvg,bigPoint,cost)
+//
+// numTicksProfit followed by calcProfitLoss of its output in a single pass.  Equivalent to
+//
+//		[barsOut,sigOut] = numTicksProfit(barsIn,sigIn,minTick,numTicks,openAvg);
+//		[~,~,~,R] = calcProfitLoss(barsOut,sigOut,bigPoint,cost);
+//
+// without building 'barsOut' and 'sigOut' unless they are requested.
+//
+// Inputs:
+//		barsIn		A matrix array of prices in the form of Open | High | Low | Close
+//		sigIn		An 1-D array the same length as barsIn, which gives the quantity bought or sold on a given bar
+//		minTick		Double representing the per contract minimum tick increment
+//		numTicks	Double representing the number of ticks for the open position price to take a profit.
+//				A vector evaluates every target in a single scan and returns a 1 x N 'stats' (statistics only).
+//		openAvg		0	Each trade individually
+//				1	Average the open position
+//		bigPoint	Double representing the full tick dollar value of the contract being P&L'd
+//		cost		Double representing the per contract commission
+// Outputs:
+//		stats		Struct of summary statistics of the P&L including virtual bars (see calcProfitLoss 'Mode','stats').
+//				stats.sharpe equals sharpe(R,0) of the two step form above.
+//		cash		Cash debits and credits per input observation (virtual bars added to the observation they were taken in)
+//		openEQ		End of observation open equity
+//		netLiq		End of observation net liquidation value
+//		returns		Observation to observation change in netLiq
+//		barsOut		As numTicksProfit
+//		sigOut		As numTicksProfit
+//
+//	The logic lives in the MEX-free backtest core (Cpp/backtestCore/btNumTicksProfit.cpp).
+//
+//		mex numTicksProfitPL.cpp @mexOpts.txt
+
+#include "mex.h"
+#include <cstring>
+#include <vector>
+#include "btNumTicksProfit.h"
+#include "btError.h"
+
+using namespace openAlgo;
+
+// Macros
+#define isReal2DfullDouble(P) (!mxIsComplex(P) && mxGetNumberOfDimensions(P) == 2 && !mxIsSparse(P) && mxIsDouble(P))
+#define isRealScalar(P) (isReal2DfullDouble(P) && mxGetNumberOfElements(P) == 1)
+
+static void setStats(mxArray *statsOut, mwIndex idx, const plStats &st)
+{
+	mxSetField(statsOut, idx, "bars", mxCreateDoubleScalar(double(st.bars)));
+	mxSetField(statsOut, idx, "meanReturn", mxCreateDoubleScalar(st.meanReturn));
+	mxSetField(statsOut, idx, "varReturn", mxCreateDoubleScalar(st.varReturn));
+	mxSetField(statsOut, idx, "stdReturn", mxCreateDoubleScalar(st.stdReturn));
+	mxSetField(statsOut, idx, "sharpe", mxCreateDoubleScalar(st.sharpe));
+	mxSetField(statsOut, idx, "maxDrawdown", mxCreateDoubleScalar(st.maxDrawdown));
+	mxSetField(statsOut, idx, "trades", mxCreateDoubleScalar(double(st.trades)));
+	mxSetField(statsOut, idx, "winners", mxCreateDoubleScalar(double(st.winners)));
+	mxSetField(statsOut, idx, "winRate", mxCreateDoubleScalar(st.winRate));
+	mxSetField(statsOut, idx, "grossProfit", mxCreateDoubleScalar(st.grossProfit));
+	mxSetField(statsOut, idx, "grossLoss", mxCreateDoubleScalar(st.grossLoss));
+	mxSetField(statsOut, idx, "netProfit", mxCreateDoubleScalar(st.netProfit));
+	mxSetField(statsOut, idx, "netLiq", mxCreateDoubleScalar(st.netLiq));
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], /* Output variables */
+				 int nrhs, const mxArray *prhs[]) /* Input variables */
+{
+	// Check number of inputs
+	if (nrhs != 7)
+		mexErrMsgIdAndTxt( "MATLAB:numTicksProfitPL:NumInputs",
+		"Number of input arguments is not correct. Aborting.");
+	// Check number of output assignments
+	if (nlhs > 1 && nlhs != 5 && nlhs != 7)
+		mexErrMsgIdAndTxt( "MATLAB:numTicksProfitPL:NumOutputs",
+		"Number of output assignments is not correct. Aborting.");
+
+	// Define constants (#define assigns a variable as either a constant or a macro)
+	// Inputs
+#define bars_IN		prhs[0]
+#define sig_IN		prhs[1]
+#define minTick_IN	prhs[2]
+#define numTicks_IN	prhs[3]
+#define openAvg_IN	prhs[4]
+#define bigPoint_IN	prhs[5]
+#define cost_IN		prhs[6]
+	// Outputs
+#define stats_OUT	plhs[0]
+#define cash_OUT	plhs[1]
+#define openEQ_OUT	plhs[2]
+#define netLiq_OUT	plhs[3]
+#define returns_OUT	plhs[4]
+#define bars_OUT	plhs[5]
+#define sig_OUT		plhs[6]
+
+	// Check type of supplied inputs
+	if (!isReal2DfullDouble(bars_IN) || mxGetN(bars_IN) != 4)
+		mexErrMsgIdAndTxt( "MATLAB:numTicksProfitPL:BadInputType",
+		"Input 'barsIn' must be a 2 dimensional full double array of type Open | High | Low | Close. Aborting.");
+
+	if (!isReal2DfullDouble(sig_IN) || mxGetN(sig_IN) > 1)
+		mexErrMsgIdAndTxt( "MATLAB:numTicksProfitPL:BadInputType",
+		"Input 'sigIn' must be a single column full double array. Aborting.");
+
+	for (int arg = 2; arg < 7; arg++)
+	{
+		if (arg != 3 && !isRealScalar(prhs[arg]))
+			mexErrMsgIdAndTxt( "MATLAB:numTicksProfitPL:BadInputType",
+			"Inputs 'minTick', 'openAvg', 'bigPoint' and 'cost' must be single scalar doubles. Aborting.");
+	}
+
+	if (!isReal2DfullDouble(numTicks_IN) || mxGetNumberOfElements(numTicks_IN) == 0 ||
+		(mxGetM(numTicks_IN) > 1 && mxGetN(numTicks_IN) > 1))
+		mexErrMsgIdAndTxt( "MATLAB:numTicksProfitPL:BadInputType",
+		"Input 'numTicks' must be a scalar or vector double. Aborting.");
+
+	mwSize numTargets = mxGetNumberOfElements(numTicks_IN);
+	if (numTargets > 1 && nlhs > 1)
+		mexErrMsgIdAndTxt( "MATLAB:numTicksProfitPL:NumOutputs",
+		"Only 'stats' can be returned for a vector of 'numTicks'. Aborting.");
+
+	// Assign variables
+	mwSize rows = mxGetM(bars_IN);
+
+	if (mxGetM(sig_IN) != rows)
+		mexErrMsgIdAndTxt( "MATLAB:numTicksProfitPL:ArrayMismatch",
+		"The number of rows in the price array and the signal array are different. Aborting.");
+
+	double openAvg = mxGetScalar(openAvg_IN);
+	if ((openAvg != 0) && (openAvg != 1))
+		mexErrMsgIdAndTxt( "MATLAB:numTicksProfitPL:ProfitTargetCalc",
+		"Input 'openAvg' must be either 0 - atomic price | 1 - average price. Aborting.");
+
+	// The mxArray is passed as a continuous 1 dimensional array concatenating all columns
+	const double *barsInPtr = mxGetPr(bars_IN);
+	ohlcSeries bars;
+	bars.open = span<const double>(barsInPtr, rows);
+	bars.high = span<const double>(barsInPtr + rows, rows);
+	bars.low = span<const double>(barsInPtr + 2 * rows, rows);
+	bars.close = span<const double>(barsInPtr + 3 * rows, rows);
+
+	// Only what was asked for is produced
+	ntpPlOutputs out;
+	ntpResult virtualBars;
+	if (nlhs >= 5)
+	{
+		cash_OUT = mxCreateDoubleMatrix(rows, 1, mxREAL);
+		openEQ_OUT = mxCreateDoubleMatrix(rows, 1, mxREAL);
+		netLiq_OUT = mxCreateDoubleMatrix(rows, 1, mxREAL);
+		returns_OUT = mxCreateDoubleMatrix(rows, 1, mxREAL);
+
+		out.bars.cash = span<double>(mxGetPr(cash_OUT), rows);
+		out.bars.openEQ = span<double>(mxGetPr(openEQ_OUT), rows);
+		out.bars.netLiq = span<double>(mxGetPr(netLiq_OUT), rows);
+		out.bars.returns = span<double>(mxGetPr(returns_OUT), rows);
+	}
+	if (nlhs == 7)
+		out.virtualBars = &virtualBars;
+
+	// mexErrMsgIdAndTxt does not return so errors are raised after the exception is released
+	char errId[128] = "";
+	char errMsg[256] = "";
+	std::vector<plStats> st;
+
+	try
+	{
+		span<const double> sig(mxGetPr(sig_IN), rows);
+		if (numTargets > 1)
+			st = numTicksProfitPLTargets(bars, sig, mxGetScalar(minTick_IN), span<const double>(mxGetPr(numTicks_IN), numTargets),
+				int(openAvg), mxGetScalar(bigPoint_IN), mxGetScalar(cost_IN));
+		else
+			st.push_back(numTicksProfitPL(bars, sig, mxGetScalar(minTick_IN), mxGetScalar(numTicks_IN),
+				int(openAvg), mxGetScalar(bigPoint_IN), mxGetScalar(cost_IN), out));
+	}
+	catch (const btError &err)
+	{
+		strncpy(errId, err.id(), sizeof(errId) - 1);
+		strncpy(errMsg, err.what(), sizeof(errMsg) - 1);
+	}
+	catch (const std::exception &err)
+	{
+		strncpy(errId, "MATLAB:numTicksProfitPL:Internal", sizeof(errId) - 1);
+		strncpy(errMsg, err.what(), sizeof(errMsg) - 1);
+	}
+
+	if (errId[0] != '\0')
+		mexErrMsgIdAndTxt(errId, "%s", errMsg);
+
+	const char *fields[] = { "bars", "meanReturn", "varReturn", "stdReturn", "sharpe", "maxDrawdown",
+		"trades", "winners", "winRate", "grossProfit", "grossLoss", "netProfit", "netLiq" };
+	stats_OUT = mxCreateStructMatrix(1, numTargets, 13, fields);
+	for (mwIndex tt = 0; tt < st.size(); tt++)
+		setStats(stats_OUT, tt, st[tt]);
+
+	if (nlhs == 7)
+	{
+		if (virtualBars.modified)
+		{
+			bars_OUT = mxCreateDoubleMatrix(virtualBars.rows, 4, mxREAL);
+			sig_OUT = mxCreateDoubleMatrix(virtualBars.rows, 1, mxREAL);
+
+			memcpy(mxGetPr(bars_OUT), virtualBars.bars.data(), virtualBars.bars.size() * sizeof(double));
+			memcpy(mxGetPr(sig_OUT), virtualBars.sig.data(), virtualBars.sig.size() * sizeof(double));
+		}
+		else
+		{
+			// Return what we were given
+			bars_OUT = mxDuplicateArray(bars_IN);
+			sig_OUT = mxDuplicateArray(sig_IN);
+		}
+	}
+
+	return;
+}
+
+//
+//  -------------------------------------------------------------------------
+//                                  _    _ 
+//         ___  _ __   ___ _ __    / \  | | __ _  ___   ___  _ __ __ _ 
+//        / _ \| '_ \ / _ \ '_ \  / _ \ | |/ _` |/ _ \ / _ \| '__/ _` |
+//       | (_) | |_) |  __/ | | |/ ___ \| | (_| | (_) | (_) | | | (_| |
+//        \___/| .__/ \___|_| |_/_/   \_\_|\__, |\___(_)___/|_|  \__, |
+//             |_|                         |___/                 |___/
+//  -------------------------------------------------------------------------
+//        This code is distributed in the hope that it will be useful,
+//
+//                         WITHOUT ANY WARRANTY AND
+//
+//                  WITHOUT CLAIM AS TO MERCHANTABILITY
+//
+//                  OR FITNESS FOR A PARTICULAR PURPOSE
+//
+//                           EXPRESSED OR IMPLIED.
+//
+//   Use of this code, pseudocode, algorithmic or trading logic contained
+//   herein, whether sound or faulty for any purpose is the sole
+//   responsibility of the USER. Any such use of these algorithms, coding
+//   logic or concepts in whole or in part carry no covenant of correctness
+//   or recommended usage from the AUTHOR or any of the possible
+//   contributors listed or unlisted, known or unknown.
+//
+//	 Redistribution and use in source and binary forms, with or without
+//	 modification, are permitted provided that the following conditions are met: 
+//
+//	 1. Redistributions of source code must retain the below copyright notice, 
+//	 this list of conditions and the following disclaimer. 
+//	 2. Redistributions in binary form must reproduce the below copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution. 
+//
+//   The public sharing of this code does not relinquish, reduce, restrict or
+//   encumber any rights the AUTHOR has in respect to claims of intellectual
+//   property.
+//
+//   IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY
+//   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+//   OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+//   STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//   ANY WAY OUT OF THE USE OF THIS SOFTWARE, CODE, OR CODE FRAGMENT(S), EVEN
+//   IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//   -------------------------------------------------------------------------
+//
+//                             ALL RIGHTS RESERVED
+//
+//   -------------------------------------------------------------------------
+//
+//   Author:	Mark Tompkins
+//
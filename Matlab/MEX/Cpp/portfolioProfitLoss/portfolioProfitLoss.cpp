@@ -0,0 +1,245 @@
+// portfolioProfitLoss.cpp
+//
+// nlhs Number of output variables nargout 
+// plhs Array of mxArray pointers to the output variables varargout
+// nrhs Number of input variables nargin
+// prhs Array of mxArray pointers to the input variables varargin
+//
+// Matlab function:
+// [netLiq,totalNetLiq,totalReturns,sharpe] = portfolioProfitLoss(data,sig,bigPoint,cost,minTick,numTicks,openAvg)
+// 
+// Inputs:
+//		data		1 x M cell array of timestamp aligned price arrays, one per instrument, in the form of
+//				Open | Close  or  Open | High | Low | Close  (required when numTicks > 0)
+//		sig		1 x M cell array of signal arrays the same length as data
+//		bigPoint	Scalar or M element vector of full tick dollar values
+//		cost		Scalar or M element vector of per contract commissions
+//		minTick		Scalar or M element vector of minimum tick increments
+//		numTicks	Scalar or M element vector of profit targets in ticks (0 = no profit taking)
+//		openAvg		numTicksProfit 'openAvg'	0	Each trade individually
+//								1	Average the open position
+//
+// Outputs:
+//		netLiq		N x M array of per instrument netLiq.  Virtual profit bars are folded back onto their observation.
+//		totalNetLiq	N x 1 aggregate netLiq
+//		totalReturns	N x 1 aggregate bar to bar returns
+//		sharpe		sharpe(totalReturns,0)
+//
+//	Each instrument follows calcProfitLoss semantics (see calcProfitLoss.cpp).  Instruments are evaluated
+//	in parallel by the MEX-free backtest core (Cpp/backtestCore/btPortfolio.cpp) and summed in a reduction.
+//
+//		mex portfolioProfitLoss.cpp @mexOpts.txt
+//
+
+#include "mex.h"
+#include <cstring>
+#include <vector>
+#include "btPortfolio.h"
+#include "btError.h"
+
+using namespace openAlgo;
+
+// Macros
+#define isReal2DfullDouble(P) (!mxIsComplex(P) && mxGetNumberOfDimensions(P) == 2 && !mxIsSparse(P) && mxIsDouble(P))
+#define isRealScalar(P) (isReal2DfullDouble(P) && mxGetNumberOfElements(P) == 1)
+
+// Value for instrument 'mm' from a scalar or per instrument vector
+static double perInstrument(const mxArray *arr, mwSize mm)
+{
+	return (mxGetNumberOfElements(arr) == 1) ? mxGetScalar(arr) : mxGetPr(arr)[mm];
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], /* Output variables */
+				 int nrhs, const mxArray *prhs[]) /* Input variables */
+{
+	// Check number of inputs
+	if (nrhs != 7)
+		mexErrMsgIdAndTxt( "MATLAB:portfolioProfitLoss:NumInputs",
+		"Number of input arguments is not correct. Aborting.");
+
+	if (nlhs < 1 || nlhs > 4)
+		mexErrMsgIdAndTxt( "MATLAB:portfolioProfitLoss:NumOutputs",
+		"Number of output assignments is not correct. Aborting.");
+
+	// Define constants (#define assigns a variable as either a constant or a macro)
+	// Inputs
+#define data_IN		prhs[0]
+#define sig_IN		prhs[1]
+#define bigPoint_IN	prhs[2]
+#define cost_IN		prhs[3]
+#define minTick_IN	prhs[4]
+#define numTicks_IN	prhs[5]
+#define openAvg_IN	prhs[6]
+
+	if (!mxIsCell(data_IN) || !mxIsCell(sig_IN))
+		mexErrMsgIdAndTxt( "MATLAB:portfolioProfitLoss:BadInputType",
+		"Inputs 'data' and 'sig' must be cell arrays with one element per instrument. Aborting.");
+
+	mwSize numInst = mxGetNumberOfElements(data_IN);
+	if (numInst == 0 || mxGetNumberOfElements(sig_IN) != numInst)
+		mexErrMsgIdAndTxt( "MATLAB:portfolioProfitLoss:ArrayMismatch",
+		"Inputs 'data' and 'sig' must hold the same (non-zero) number of instruments. Aborting.");
+
+	const mxArray *scalars[4] = { bigPoint_IN, cost_IN, minTick_IN, numTicks_IN };
+	const char *scalarNames[4] = { "bigPoint", "cost", "minTick", "numTicks" };
+	for (int ss = 0; ss < 4; ss++)
+	{
+		if (!isReal2DfullDouble(scalars[ss]) ||
+			(mxGetNumberOfElements(scalars[ss]) != 1 && mxGetNumberOfElements(scalars[ss]) != numInst))
+			mexErrMsgIdAndTxt( "MATLAB:portfolioProfitLoss:BadInputType",
+			"Input '%s' must be a scalar or have one element per instrument. Aborting.", scalarNames[ss]);
+	}
+
+	if (!isRealScalar(openAvg_IN))
+		mexErrMsgIdAndTxt( "MATLAB:portfolioProfitLoss:BadInputType",
+		"Input 'openAvg' must be a single scalar double. Aborting.");
+
+	// Wrap each instrument's buffers
+	std::vector<instrumentSpec> book(numInst);
+	mwSize rows = 0;
+
+	for (mwSize mm = 0; mm < numInst; mm++)
+	{
+		const mxArray *data = mxGetCell(data_IN, mm);
+		const mxArray *sig = mxGetCell(sig_IN, mm);
+
+		if (data == NULL || sig == NULL || !isReal2DfullDouble(data) || !isReal2DfullDouble(sig))
+			mexErrMsgIdAndTxt( "MATLAB:portfolioProfitLoss:BadInputType",
+			"Instrument %d: 'data' and 'sig' must be 2 dimensional full double arrays. Aborting.", int(mm + 1));
+
+		mwSize rowsData = mxGetM(data);
+		mwSize colsData = mxGetN(data);
+
+		if (mm == 0)
+			rows = rowsData;
+
+		if (rowsData != rows || mxGetM(sig) != rows || mxGetN(sig) != 1)
+			mexErrMsgIdAndTxt( "MATLAB:portfolioProfitLoss:ArrayMismatch",
+			"Instrument %d: every instrument must have the same number of timestamp aligned observations and a single signal column. Aborting.", int(mm + 1));
+
+		if (colsData != 2 && colsData != 4)
+			mexErrMsgIdAndTxt( "MATLAB:portfolioProfitLoss:ArrayMismatch",
+			"Instrument %d: 'data' must be in the form of 'O | C' or 'O | H | L | C'. Aborting.", int(mm + 1));
+
+		instrumentSpec &inst = book[mm];
+		const double *dataInPtr = mxGetPr(data);
+		inst.bars.open = span<const double>(dataInPtr, rows);
+		inst.bars.close = span<const double>(dataInPtr + rows * (colsData - 1), rows);
+		if (colsData == 4)
+		{
+			inst.bars.high = span<const double>(dataInPtr + rows, rows);
+			inst.bars.low = span<const double>(dataInPtr + 2 * rows, rows);
+		}
+		inst.sig = span<const double>(mxGetPr(sig), rows);
+		inst.bigPoint = perInstrument(bigPoint_IN, mm);
+		inst.cost = perInstrument(cost_IN, mm);
+		inst.minTick = perInstrument(minTick_IN, mm);
+		inst.numTicks = perInstrument(numTicks_IN, mm);
+		inst.openAvg = int(mxGetScalar(openAvg_IN));
+
+		if (inst.numTicks > 0 && colsData != 4)
+			mexErrMsgIdAndTxt( "MATLAB:portfolioProfitLoss:ArrayMismatch",
+			"Instrument %d: profit taking requires 'data' in the form of 'O | H | L | C'. Aborting.", int(mm + 1));
+	}
+
+	// mexErrMsgIdAndTxt does not return so errors are raised after the exception is released
+	char errId[128] = "";
+	char errMsg[256] = "";
+	portfolioResult result;
+
+	try
+	{
+		result = runPortfolio(book);
+	}
+	catch (const btError &err)
+	{
+		strncpy(errId, err.id(), sizeof(errId) - 1);
+		strncpy(errMsg, err.what(), sizeof(errMsg) - 1);
+	}
+	catch (const std::exception &err)
+	{
+		strncpy(errId, "MATLAB:portfolioProfitLoss:Internal", sizeof(errId) - 1);
+		strncpy(errMsg, err.what(), sizeof(errMsg) - 1);
+	}
+
+	if (errId[0] != '\0')
+		mexErrMsgIdAndTxt(errId, "%s", errMsg);
+
+	/* Create matrices for the return arguments */ 
+	plhs[0] = mxCreateDoubleMatrix(rows, numInst, mxREAL);
+	memcpy(mxGetPr(plhs[0]), result.netLiq.data(), result.netLiq.size() * sizeof(double));
+
+	if (nlhs > 1)
+	{
+		plhs[1] = mxCreateDoubleMatrix(rows, 1, mxREAL);
+		memcpy(mxGetPr(plhs[1]), result.totalNetLiq.data(), rows * sizeof(double));
+	}
+
+	if (nlhs > 2)
+	{
+		plhs[2] = mxCreateDoubleMatrix(rows, 1, mxREAL);
+		memcpy(mxGetPr(plhs[2]), result.totalReturns.data(), rows * sizeof(double));
+	}
+
+	if (nlhs > 3)
+		plhs[3] = mxCreateDoubleScalar(result.sharpe);
+
+	return;
+}
+
+//
+//  -------------------------------------------------------------------------
+//                                  _    _ 
+//         ___  _ __   ___ _ __    / \  | | __ _  ___   ___  _ __ __ _ 
+//        / _ \| '_ \ / _ \ '_ \  / _ \ | |/ _` |/ _ \ / _ \| '__/ _` |
+//       | (_) | |_) |  __/ | | |/ ___ \| | (_| | (_) | (_) | | | (_| |
+//        \___/| .__/ \___|_| |_/_/   \_\_|\__, |\___(_)___/|_|  \__, |
+//             |_|                         |___/                 |___/
+//  -------------------------------------------------------------------------
+//        This code is distributed in the hope that it will be useful,
+//
+//                         WITHOUT ANY WARRANTY AND
+//
+//                  WITHOUT CLAIM AS TO MERCHANTABILITY
+//
+//                  OR FITNESS FOR A PARTICULAR PURPOSE
+//
+//                           EXPRESSED OR IMPLIED.
+//
+//   Use of this code, pseudocode, algorithmic or trading logic contained
+//   herein, whether sound or faulty for any purpose is the sole
+//   responsibility of the USER. Any such use of these algorithms, coding
+//   logic or concepts in whole or in part carry no covenant of correctness
+//   or recommended usage from the AUTHOR or any of the possible
+//   contributors listed or unlisted, known or unknown.
+//
+//	 Redistribution and use in source and binary forms, with or without
+//	 modification, are permitted provided that the following conditions are met: 
+//
+//	 1. Redistributions of source code must retain the below copyright notice, 
+//	 this list of conditions and the following disclaimer. 
+//	 2. Redistributions in binary form must reproduce the below copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution. 
+//
+//   The public sharing of this code does not relinquish, reduce, restrict or
+//   encumber any rights the AUTHOR has in respect to claims of intellectual
+//   property.
+//
+//   IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY
+//   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+//   OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+//   STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//   ANY WAY OUT OF THE USE OF THIS SOFTWARE, CODE, OR CODE FRAGMENT(S), EVEN
+//   IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//   -------------------------------------------------------------------------
+//
+//                             ALL RIGHTS RESERVED
+//
+//   -------------------------------------------------------------------------
+//
+//   Author:	Mark Tompkins
+//
@@ -29,33 +29,25 @@
 // Outputs:
 //		rsi	The calculated relative strength index (RSI)
 //
+//	The calculation lives in the MEX-free backtest core (Cpp/backtestCore/btRelStrIdx.cpp).
+//
+//		mex relStrIdx.cpp @mexOpts.txt
+//
 
 #include "mex.h"
-#include <cmath>
-#include <limits>
+#include <cstring>
+#include "btRelStrIdx.h"
+#include "btError.h"
 
-using namespace std;
+using namespace openAlgo;
 
 // Macros
 #define isReal2DfullDouble(P) (!mxIsComplex(P) && mxGetNumberOfDimensions(P) == 2 && !mxIsSparse(P) && mxIsDouble(P))
 #define isRealScalar(P) (isReal2DfullDouble(P) && mxGetNumberOfElements(P) == 1)
 
-// Global variables
-int obsvIn;
-double *barsInPtr;	// Pointer for the price matrix
-
 void mexFunction(int nlhs, mxArray *plhs[], /* Output variables */
 int nrhs, const mxArray *prhs[]) /* Input variables */
 {
-	// There are a number of provided functions for interfacing back to Matlab
-	// mexFuncion		The gateway to C.  Required in every C & C++ solution to allow Matlab to call it
-	// mexEvalString	Execute Matlab command
-	// mexCallMatlab	Call Matlab function (.m or .dll) or script
-	// mexPrintf		Print to the Matlab command window
-	// mexErrMsgTxt		Issue error message and exit returning control to Matlab
-	// mexWarnMsgTxt	Issue warning message
-	// mexPrintf("Hello, world!"); /* Do something interesting */
-
 	// Check number of inputs
 	if (nrhs != 2)
 		mexErrMsgIdAndTxt( "MATLAB:relStrIdx:NumInputs",
@@ -73,18 +65,6 @@ int nrhs, const mxArray *prhs[]) /* Input variables */
 	// Outputs
 	#define rsi_OUT		plhs[0]
 
-	// Create a NaN value
-	// mxArray *nanvalue;
-	// nanvalue = mxCreateDoubleScalar(mxGetNaN());
-	double m_Nan = std::numeric_limits<double>::quiet_NaN(); 
-
-	// Init variables
-	mwSize rowsData, colsData;
-
-	// Assign variables
-	rowsData = mxGetM(bars_IN);
-	colsData = mxGetN(bars_IN);
-
 	// Check type of supplied inputs
 	if (!isReal2DfullDouble(bars_IN)) 
 		mexErrMsgIdAndTxt( "MATLAB:relStrIdx:BadInputType",
@@ -94,118 +74,41 @@ int nrhs, const mxArray *prhs[]) /* Input variables */
 		mexErrMsgIdAndTxt( "MATLAB:relStrIdx:BadInputType",
 		"Input 'N' must be a single integer input. Aborting.");
 
+	// Assign variables
+	mwSize rowsData = mxGetM(bars_IN);
+	mwSize colsData = mxGetN(bars_IN);
+
 	if (colsData > 1)
 		mexErrMsgIdAndTxt( "MATLAB:relStrIdx:BadInputType",
 		"We should only be given a 1-D price vector. Aborting.");
 
-	/* Assign pointers to the input array */ 
-	barsInPtr =	mxGetPr(bars_IN);
-
-	/* Assign scalar values */
-	obsvIn =	int(mxGetScalar(obsv_IN));
-
-	if (obsvIn < 1)
-		mexErrMsgIdAndTxt( "MATLAB:relStrIdx:BadInputType",
-		"The observation lookback must be a positive integer >= 1. Aborting.");
-
-	if (obsvIn > rowsData)
-		mexErrMsgIdAndTxt( "MATLAB:relStrIdx:BadInputType",
-		"The lookback cannot be greater than the number of observations. Aborting.");
-
 	/* Create matrices for the return arguments */ 
 	// http://www.mathworks.com/help/matlab/matlab_external/c-c-source-mex-files.html
 	rsi_OUT = mxCreateDoubleMatrix(rowsData, 1, mxREAL);
 
-	// assign the variables for manipulating the arrays (by pointer reference)
-	double *RSI = mxGetPr(rsi_OUT);
-
-	// Create temporary arrays for calculations
-	double *advances = new double[rowsData];
-	double *declines = new double[rowsData];
-	double *avgGain = new double[rowsData];
-	double *avgLoss = new double[rowsData];
-
-	/////////////
-	// START
-	/////////////
-
-	// Calculate advances & declines
-	advances[0] = 0;
-	declines[0] = 0;
+	// mexErrMsgIdAndTxt does not return so errors are raised after the exception is released
+	char errId[128] = "";
+	char errMsg[256] = "";
 
-	// starting at one because we are doing a difference of the observation prior
-	for (int ii=1;ii != rowsData; ii++)	
+	try
 	{
-		if (barsInPtr[ii] - barsInPtr[ii-1] > 0)
-		{
-			advances[ii] = abs(barsInPtr[ii] - barsInPtr[ii-1]);
-			declines[ii] = 0;
-		}
-		else
-		{
-			advances[ii] = 0;
-			declines[ii] = abs(barsInPtr[ii] - barsInPtr[ii-1]);
-		}
+		// All state is local to the core call (no file-scope globals) so the kernel is reentrant
+		relStrIdx(span<const double>(mxGetPr(bars_IN), rowsData), int(mxGetScalar(obsv_IN)),
+			span<double>(mxGetPr(rsi_OUT), rowsData));
 	}
-
-	// Calculate avgGains & avgLosses
-	// Note: these are not averages in the formal sense
-	for (int ii = (obsvIn); ii != rowsData; ii++)
+	catch (const btError &err)
 	{
-		if (ii == (obsvIn))
-		{
-			double sumAdv = 0;
-			double sumDec = 0;
-
-			for (int jj = 0; jj != obsvIn; jj++)
-			{
-				sumAdv = sumAdv + advances[ii-jj];
-				sumDec = sumDec + declines[ii-jj];
-			}
-
-			avgGain[ii] = sumAdv / obsvIn;
-			avgLoss[ii] = sumDec / obsvIn;
-		}
-		else
-		{
-			avgGain[ii] = ((avgGain[ii-1] * (obsvIn - 1)) + advances[ii]) / obsvIn;
-			avgLoss[ii] = ((avgLoss[ii-1] * (obsvIn - 1)) + declines[ii]) / obsvIn;
-		}
+		strncpy(errId, err.id(), sizeof(errId) - 1);
+		strncpy(errMsg, err.what(), sizeof(errMsg) - 1);
 	}
-
-	// Assign RSI values to output array
-	for (int ii = 0; ii != rowsData; ii++)
+	catch (const std::exception &err)
 	{
-		if (ii < (obsvIn))
-		{
-			RSI[ii] = m_Nan;
-		}
-		else
-		{
-			if (avgLoss[ii] == 0)
-			{
-				RSI[ii] = 100;
-			}
-			else
-			{
-				RSI[ii] = 100 - (100 / (1 + avgGain[ii] / avgLoss[ii]));
-			}
-		}
+		strncpy(errId, "MATLAB:relStrIdx:Internal", sizeof(errId) - 1);
+		strncpy(errMsg, err.what(), sizeof(errMsg) - 1);
 	}
 
-	delete []advances;
-	delete []declines;
-	delete []avgGain;
-	delete []avgLoss;
-
-	advances = NULL;
-	declines = NULL;
-	avgGain = NULL;
-	avgLoss = NULL;
-
-	/////////////
-	// FINISHED
-	/////////////
+	if (errId[0] != '\0')
+		mexErrMsgIdAndTxt(errId, "%s", errMsg);
 
 	return;
 }
@@ -5,19 +5,34 @@
 //
 //	[varout] = taInvoke(taFunction, varin)
 //
+//	h = taInvoke('prepare', taFunction, options)	Resolve taFunction and check its options once
+//	[varout] = taInvoke(h, data)			Call the prepared function on 'data' with the kept options
+//	taInvoke('release', h)				Free a prepared call ('release' alone frees them all)
+//
+//	A function whose only option is its period also takes N x M data (one instrument per column, H | L | C
+//	as separate N x M matrices) and a vector of K periods.  The output is N x M, N x K or, for both,
+//	N x K x M.  e.g. taInvoke('ta_atr', H, L, C, [7 14 28]) is N x 3.  Columns are computed in parallel.
+//
 // Inputs:
 //	taFunction	The name of the TA-Lib function to call
 //	varin		The input variable(s) as necessary for the called taFunction
+//	options		The optional inputs of taFunction that follow its data
+//	data		The required (data) inputs of taFunction
 //
 // Outputs:
 //	varout		The output(s) as produced from the call to the taFunction
+//	h		An integer handle to the prepared call
 
 #include "mex.h"
 #include "ta_libc.h"
-#include <map>
+#include <vector>
+#include <cstring>
 #include <algorithm>	// So we can transform the function name string input ...
 #include <string>	// from char to string ensuring lowercase
 #include "myMath.h"
+#include "btTaBatch.h"
+#include "btParallel.h"
+#include "btError.h"
 
 using namespace std;
 
@@ -43,9 +58,182 @@ static enum StringValue {
 	ta_tsf, ta_typprice, ta_ultosc, ta_var, ta_wclprice, ta_willr, ta_wma
 };
 
+// Function names and their enum values
+static const struct
+{
+	const char *name;
+	StringValue value;
+} s_taFunctions[] =
+{
+	{ "ta_accbands",			ta_accbands },
+	{ "ta_acos",				ta_acos },
+	{ "ta_ad",					ta_ad },
+	{ "ta_add",					ta_add },
+	{ "ta_adosc",				ta_adosc },
+	{ "ta_adx",					ta_adx },
+	{ "ta_adxr",				ta_adxr },
+	{ "ta_apo",					ta_apo },
+	{ "ta_aroon",				ta_aroon },
+	{ "ta_aroonosc",			ta_aroonosc },
+	{ "ta_asin",				ta_asin },
+	{ "ta_atan",				ta_atan },
+	{ "ta_atr",					ta_atr },
+	{ "ta_avgdev",				ta_avgdev },
+	{ "ta_avgprice",			ta_avgprice },
+	{ "ta_bbands",				ta_bbands },
+	{ "ta_beta",				ta_beta },
+	{ "ta_bop",					ta_bop },
+	{ "ta_cci",					ta_cci },
+	{ "ta_cdl2crows",			ta_cdl2crows },
+	{ "ta_cdl3blackcrows",		ta_cdl3blackcrows },
+	{ "ta_cdl3inside",			ta_cdl3inside },
+	{ "ta_cdl3linestrike",		ta_cdl3linestrike },
+	{ "ta_cdl3outside",			ta_cdl3outside },
+	{ "ta_cdl3starsinsouth",	ta_cdl3starsinsouth },
+	{ "ta_cdl3whitesoldiers",	ta_cdl3whitesoldiers },
+	{ "ta_cdlabandonedbaby",	ta_cdlabandonedbaby },
+	{ "ta_cdladvanceblock",		ta_cdladvanceblock },
+	{ "ta_cdlbelthold",			ta_cdlbelthold },
+	{ "ta_cdlbreakaway",		ta_cdlbreakaway },
+	{ "ta_cdlclosingmarubozu",	ta_cdlclosingmarubozu },
+	{ "ta_cdlconcealbabyswall",	ta_cdlconcealbabyswall },
+	{ "ta_cdlcounterattack",	ta_cdlcounterattack },
+	{ "ta_cdldarkcloudcover",	ta_cdldarkcloudcover },
+	{ "ta_cdldoji",				ta_cdldoji },
+	{ "ta_cdldojistar",			ta_cdldojistar },
+	{ "ta_cdldragonflydoji",	ta_cdldragonflydoji },
+	{ "ta_cdlengulfing",		ta_cdlengulfing },
+	{ "ta_cdleveningdojistar",	ta_cdleveningdojistar },
+	{ "ta_cdleveningstar",		ta_cdleveningstar },
+	{ "ta_cdlgapsidesidewhite",	ta_cdlgapsidesidewhite },
+	{ "ta_cdlgravestonedoji",	ta_cdlgravestonedoji },
+	{ "ta_cdlhammer",			ta_cdlhammer },
+	{ "ta_cdlhangingman",		ta_cdlhangingman },
+	{ "ta_cdlharami",			ta_cdlharami },
+	{ "ta_cdlharamicross",		ta_cdlharamicross },
+	{ "ta_cdlhighwave",			ta_cdlhighwave },
+	{ "ta_cdlhikkake",			ta_cdlhikkake },
+	{ "ta_cdlhikkakemod",		ta_cdlhikkakemod },
+	{ "ta_cdlhomingpigeon",		ta_cdlhomingpigeon },
+	{ "ta_cdlidentical3crows",	ta_cdlidentical3crows },
+	{ "ta_cdlinneck",			ta_cdlinneck },
+	{ "ta_cdlinvertedhammer",	ta_cdlinvertedhammer },
+	{ "ta_cdlkicking",			ta_cdlkicking },
+	{ "ta_cdlkickingbylength",	ta_cdlkickingbylength },
+	{ "ta_cdlladderbottom",		ta_cdlladderbottom },
+	{ "ta_cdllongleggeddoji",	ta_cdllongleggeddoji },
+	{ "ta_cdllongline",			ta_cdllongline },
+	{ "ta_cdlmarubozu",			ta_cdlmarubozu },
+	{ "ta_cdlmatchinglow",		ta_cdlmatchinglow },
+	{ "ta_cdlmathold",			ta_cdlmathold },
+	{ "ta_cdlmorningdojistar",	ta_cdlmorningdojistar },
+	{ "ta_cdlmorningstar",		ta_cdlmorningstar },
+	{ "ta_cdlonneck",			ta_cdlonneck },
+	{ "ta_cdlpiercing",			ta_cdlpiercing },
+	{ "ta_cdlrickshawman",		ta_cdlrickshawman },
+	{ "ta_cdlrisefall3methods",	ta_cdlrisefall3methods },
+	{ "ta_cdlseparatinglines",	ta_cdlseparatinglines },
+	{ "ta_cdlshootingstar",		ta_cdlshootingstar },
+	{ "ta_cdlshortline",		ta_cdlshortline },
+	{ "ta_cdlspinningtop",		ta_cdlspinningtop },
+	{ "ta_cdlstalledpattern",	ta_cdlstalledpattern },
+	{ "ta_cdlsticksandwich",	ta_cdlsticksandwich },
+	{ "ta_cdltakuri",			ta_cdltakuri },
+	{ "ta_cdltasukigap",		ta_cdltasukigap },
+	{ "ta_cdlthrusting",		ta_cdlthrusting },
+	{ "ta_cdltristar",			ta_cdltristar },
+	{ "ta_cdlunique3river",		ta_cdlunique3river },
+	{ "ta_cdlupsidegap2crows",	ta_cdlupsidegap2crows },
+	{ "ta_cdlxsidegap3methods",	ta_cdlxsidegap3methods },
+	{ "ta_ceil",				ta_ceil },
+	{ "ta_cmo",					ta_cmo },
+	{ "ta_correl",				ta_correl },
+	{ "ta_cos",					ta_cos },
+	{ "ta_cosh",				ta_cosh },
+	{ "ta_dema",				ta_dema },
+	{ "ta_div",					ta_div },
+	{ "ta_dx",					ta_dx },
+	{ "ta_ema",					ta_ema },
+	{ "ta_exp",					ta_exp },
+	{ "ta_floor",				ta_floor },
+	{ "ta_ht_dcperiod",			ta_ht_dcperiod },
+	{ "ta_ht_dcphase",			ta_ht_dcphase },
+	{ "ta_ht_phasor",			ta_ht_phasor },
+	{ "ta_ht_sine",				ta_ht_sine },
+	{ "ta_ht_trendline",		ta_ht_trendline },
+	{ "ta_ht_trendmode",		ta_ht_trendmode },
+	{ "ta_kama",				ta_kama },
+	{ "ta_linearreg",			ta_linearreg },
+	{ "ta_linearreg_angle",		ta_linearreg_angle },
+	{ "ta_linearreg_intercept",	ta_linearreg_intercept },
+	{ "ta_linearreg_slope",		ta_linearreg_slope },
+	{ "ta_ln",					ta_ln },
+	{ "ta_log10",				ta_log10 },
+	{ "ta_ma",					ta_ma },
+	{ "ta_macd",				ta_macd },
+	{ "ta_macdext",				ta_macdext },
+	{ "ta_macdfix",				ta_macdfix },
+	{ "ta_mama",				ta_mama },
+	{ "ta_mavp",				ta_mavp },
+	{ "ta_max",					ta_max },
+	{ "ta_maxindex",			ta_maxindex },
+	{ "ta_medprice",			ta_medprice },
+	{ "ta_mfi",					ta_mfi },
+	{ "ta_midpoint",			ta_midpoint },
+	{ "ta_midprice",			ta_midprice },
+	{ "ta_min",					ta_min },
+	{ "ta_minindex",			ta_minindex },
+	{ "ta_minmax",				ta_minmax },
+	{ "ta_minmaxindex",			ta_minmaxindex },
+	{ "ta_minus_di",			ta_minus_di },
+	{ "ta_minus_dm",			ta_minus_dm },
+	{ "ta_mom",					ta_mom },
+	{ "ta_mult",				ta_mult },
+	{ "ta_natr",				ta_natr },
+	{ "ta_obv",					ta_obv },
+	{ "ta_plus_di",				ta_plus_di },
+	{ "ta_plus_dm",				ta_plus_dm },
+	{ "ta_ppo",					ta_ppo },
+	{ "ta_roc",					ta_roc },
+	{ "ta_rocp",				ta_rocp },
+	{ "ta_rocr",				ta_rocr },
+	{ "ta_rocr100",				ta_rocr100 },
+	{ "ta_rsi",					ta_rsi },
+	{ "ta_sar",					ta_sar },
+	{ "ta_sarext",				ta_sarext },
+	{ "ta_sin",					ta_sin },
+	{ "ta_sinh",				ta_sinh },
+	{ "ta_sma",					ta_sma },
+	{ "ta_sqrt",				ta_sqrt },
+	{ "ta_stddev",				ta_stddev },
+	{ "ta_stoch",				ta_stoch },
+	{ "ta_stochf",				ta_stochf },
+	{ "ta_stochrsi",			ta_stochrsi },
+	{ "ta_sub",					ta_sub },
+	{ "ta_sum",					ta_sum },
+	{ "ta_t3",					ta_t3 },
+	{ "ta_tan",					ta_tan },
+	{ "ta_tanh",				ta_tanh },
+	{ "ta_tema",				ta_tema },
+	{ "ta_trange",				ta_trange },
+	{ "ta_trima",				ta_trima },
+	{ "ta_trix",				ta_trix },
+	{ "ta_tsf",					ta_tsf },
+	{ "ta_typprice",			ta_typprice },
+	{ "ta_ultosc",				ta_ultosc },
+	{ "ta_var",					ta_var },
+	{ "ta_wclprice",			ta_wclprice },
+	{ "ta_willr",				ta_willr },
+	{ "ta_wma",					ta_wma }
+};
+
+// Perfect hash of s_taFunctions (see InitSwitchMapping)
+#define TA_BUCKETS	64
+#define TA_SLOTS	256
+static unsigned s_taSeeds[TA_BUCKETS];
+static unsigned char s_taSlots[TA_SLOTS];	// s_taFunctions index + 1 (0 = empty slot)
+
 // Prototypes
-// Map to associate the strings with the enum values
-static map<string, StringValue> s_mapStringValues;
 void taInvokeInfoOnly();
 void taInvokeFuncInfo(string taFuncNameIn);
 void chkSingleVec(int colsD, int lineNum);
@@ -57,17 +245,46 @@ void printToMatLab(char *para1, char *para2, char *form);
 void printToMatLab(char *para1, char *para2, char *para3, char *form);
 void printToMatLab(char *para1, char *para2, char *para3, char *para4, char *form);
 void typeMAcheck(string taFuncNameIn, string taFuncDesc, string taFuncOptName, int typeMA);
+double *taOutput(mxArray *&out, int rows, int lookback);
+int *taOutputInt(mxArray *&out, int rows, int lookback);
 
 static void InitSwitchMapping();
+static StringValue taLookup(const string &taFuncNameIn);
+static void taDispatch(StringValue taFunc, const string &taFuncNameIn, int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]);
+static void taPrepare(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]);
+static void taRelease(int nrhs, const mxArray *prhs[]);
+static void taInvokePlan(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]);
+static bool taBatch(StringValue taFunc, const string &taFuncNameIn, int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]);
+static void taBatchRun(size_t ff, const string &taFuncNameIn, mxArray *plhs[], const mxArray *dataIn[], const vector<int> &periods,
+	double numDev);
 
 // Macros
 #define isReal2DfullDouble(P) (!mxIsComplex(P) && mxGetNumberOfDimensions(P) == 2 && !mxIsSparse(P) && mxIsDouble(P))
 #define isRealScalar(P) (isReal2DfullDouble(P) && mxGetNumberOfElements(P) == 1)
+#define isRealVector(P) (isReal2DfullDouble(P) && mxGetNumberOfElements(P) >= 1 && (mxGetM(P) == 1 || mxGetN(P) == 1))
 #define codeLine	__LINE__	// help error trapping in MatLab
 
 // Global variables
 double m_Nan = std::numeric_limits<double>::quiet_NaN(); 
 
+// Prepared calls (taInvoke('prepare', ...)).  Handle 'h' is s_taPlans[h - 1] (NULL once released).
+// The options are checked against the function and converted once, by prepare.  A function whose only
+// option is its period keeps the periods (and numDev) and is run by taBatchRun with no further parsing.
+// Any other function keeps its converted options as persistent scalars appended to the data of every call.
+typedef struct
+{
+	StringValue func;
+	string name;
+	int batch;				// Index into s_taPeriodFunctions or -1
+	vector<int> periods;			// batch: the periods
+	double numDev;				// batch: STDDEV | VAR deviations
+	vector<mxArray *> opts;			// otherwise: the options
+} taPlan;
+
+static vector<taPlan *> s_taPlans;
+
+#define TA_MAX_ARGS	32		// Data and options of a prepared call
+
 void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 	int nrhs, const mxArray *prhs[])	/* Input variables */
 {
@@ -78,6 +295,13 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 		return;				// End mex call
 	}
 
+	// A prepared call skips the name parsing and lookup
+	if (mxIsNumeric(prhs[0]))
+	{
+		taInvokePlan(nlhs, plhs, nrhs, prhs);
+		return;
+	}
+
 	// Define constants (#define assigns a variable as either a constant or a macro)
 	// Inputs
 	#define taFuncName_IN		prhs[0]
@@ -93,16 +317,25 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 		"Could not parse the given function. Aborting (%d).", codeLine);
 
 	string taFuncNameIn((funcAsChars));
-	string taFuncDesc;				// Descriptive name of function for user feedback
-	string taFuncOptName = "typeMA";		// Descriptive name for the optional input being validated (default to 'typeMA')
 
 	transform(taFuncNameIn.begin(), taFuncNameIn.end(), taFuncNameIn.begin(), ::tolower);
 
 	// Quick cleanup
 	mxFree(funcAsChars);
 
-	// Init the switch function string mapping to the enum
-	InitSwitchMapping();
+	if (taFuncNameIn == "prepare")
+	{
+		taPrepare(nlhs, plhs, nrhs, prhs);
+		return;
+	}
+	if (taFuncNameIn == "release")
+	{
+		taRelease(nrhs, prhs);
+		return;
+	}
+
+	// Resolve the function once for the switch and the per-function sub-switches
+	StringValue taFunc = taLookup(taFuncNameIn);
 
 	// If we have no parameters the user is requesting information about a given function.
 	// Provide and exit.
@@ -112,7 +345,20 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 		return;
 	}
 
-	switch (s_mapStringValues[taFuncNameIn])
+	// Many instruments and | or a vector of periods return one column each
+	if (taBatch(taFunc, taFuncNameIn, nlhs, plhs, nrhs, prhs))
+		return;
+
+	taDispatch(taFunc, taFuncNameIn, nlhs, plhs, nrhs, prhs);
+}
+
+// Call 'taFunc' with prhs[1..] as its inputs (prhs[0] is not read)
+static void taDispatch(StringValue taFunc, const string &taFuncNameIn, int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+	string taFuncDesc;				// Descriptive name of function for user feedback
+	string taFuncOptName = "typeMA";		// Descriptive name for the optional input being validated (default to 'typeMA')
+
+	switch (taFunc)
 	{
 		// Acceleration Bands
 		case ta_accbands:
@@ -191,49 +437,19 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				lookback = 14;
 			}
 
-			// Preallocate heap
-			accUpper = (double*)mxCalloc(rows, sizeof(double));
-			accMid	= (double*)mxCalloc(rows, sizeof(double));
-			accLower = (double*)mxCalloc(rows, sizeof(double));
-
+			int taLookback = TA_ACCBANDS_Lookback(lookback);
+			accUpper = taOutput(accUpper_OUT, rows, taLookback);
+			accMid = taOutput(accMid_OUT, rows, taLookback);
+			accLower = taOutput(accLower_OUT, rows, taLookback);
 			retCode = TA_ACCBANDS(startIdx, endIdx, highPtr, lowPtr, closePtr, lookback, &accIdx, &outElements, accUpper, accMid, accLower);
 
 			// Error handling
 			if (retCode) 
 			{
-				mxFree(accUpper);
-				mxFree(accMid);
-				mxFree(accLower);
 				mexPrintf("%s%i","Return code=",retCode);
 				mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 			}
 
-			// Populate Output
-			accUpper_OUT = mxCreateDoubleMatrix(accIdx + outElements,1, mxREAL);
-			accMid_OUT = mxCreateDoubleMatrix(accIdx + outElements,1, mxREAL);
-			accLower_OUT = mxCreateDoubleMatrix(accIdx + outElements,1, mxREAL);
-			memcpy(((double *) mxGetData(accUpper_OUT)) + accIdx, accUpper, outElements * mxGetElementSize(accUpper_OUT));
-			memcpy(((double *) mxGetData(accMid_OUT)) + accIdx, accMid, outElements * mxGetElementSize(accMid_OUT));
-			memcpy(((double *) mxGetData(accLower_OUT)) + accIdx, accLower, outElements * mxGetElementSize(accLower_OUT));
-
-			// Cleanup
-			mxFree(accUpper); 
-			mxFree(accMid); 
-			mxFree(accLower); 
-
-			// NaN data before lookback
-			// assign the variables for manipulating the arrays (by pointer reference)
-			double *uBandPtr = mxGetPr(accUpper_OUT);
-			double *mBandPtr = mxGetPr(accMid_OUT);
-			double *lBandPtr = mxGetPr(accLower_OUT);
-
-			for (int iter = 0; iter < lookback; iter++)
-			{
-				uBandPtr[iter] = m_Nan;
-				mBandPtr[iter] = m_Nan;
-				lBandPtr[iter] = m_Nan;
-			}
-
 			break;
 		}
 			
@@ -307,28 +523,31 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 			int vecIdx, outElements;
 			double *outReal;
 
-			// Preallocate heap
-			outReal = (double*)mxCalloc(rows, sizeof(double));
-
 			// Invoke with error catch
-			switch (s_mapStringValues[taFuncNameIn])
+			switch (taFunc)
 			{
 				case ta_acos:
+					outReal = taOutput(vec_OUT, rows, TA_ACOS_Lookback());
 					retCode = TA_ACOS(startIdx, endIdx, vecPtr, &vecIdx, &outElements, outReal);
 					break;
 				case ta_sin:
+					outReal = taOutput(vec_OUT, rows, TA_SIN_Lookback());
 					retCode = TA_SIN(startIdx, endIdx, vecPtr, &vecIdx, &outElements, outReal);
 					break;
 				case ta_sinh:
+					outReal = taOutput(vec_OUT, rows, TA_SINH_Lookback());
 					retCode = TA_SINH(startIdx, endIdx, vecPtr, &vecIdx, &outElements, outReal);
 					break;
 				case ta_sqrt:
+					outReal = taOutput(vec_OUT, rows, TA_SQRT_Lookback());
 					retCode = TA_SQRT(startIdx, endIdx, vecPtr, &vecIdx, &outElements, outReal);
 					break;
 				case ta_tan:
+					outReal = taOutput(vec_OUT, rows, TA_TAN_Lookback());
 					retCode = TA_TAN(startIdx, endIdx, vecPtr, &vecIdx, &outElements, outReal);
 					break;
 				case ta_tanh:
+					outReal = taOutput(vec_OUT, rows, TA_TANH_Lookback());
 					retCode = TA_TANH(startIdx, endIdx, vecPtr, &vecIdx, &outElements, outReal);
 					break;
 			}
@@ -336,19 +555,11 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 			// Error handling
 			if (retCode) 
 			{
-				mxFree(outReal);
 				mexPrintf("%s%i","Return code=",retCode);
 				mexErrMsgIdAndTxt( "MATLAB:taInvoke:invokeErr",
 					"Invocation to '%s' failed.. Aborting (%d).", taFuncNameIn, codeLine);
 			}
 
-			// Populate Output
-			vec_OUT = mxCreateDoubleMatrix(vecIdx + outElements,1, mxREAL);
-			memcpy(((double *) mxGetData(vec_OUT)) + vecIdx, outReal, outElements * mxGetElementSize(vec_OUT));
-
-			// Cleanup
-			mxFree(outReal); 
-
 			break;
 		}
 			
@@ -418,26 +629,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 			int adIdx, outElements;
 			double *outReal;
 
-			// Preallocate heap
-			outReal = (double*)mxCalloc(rows, sizeof(double));	// added cast
-
 			// Invoke with error catch
+			outReal = taOutput(ad_OUT, rows, TA_AD_Lookback());
 			retCode = TA_AD(startIdx, endIdx, highPtr, lowPtr, closePtr, volPtr, &adIdx, &outElements, outReal);
 		
 			// Error handling
 			if (retCode) 
 			{
-				mxFree(outReal);
 				mexPrintf("%s%i","Return code=",retCode);
 				mexErrMsgTxt("Invocation to 'ta_ad' failed. Aborting.");
 			}
 
-			// Populate Output
-			ad_OUT = mxCreateDoubleMatrix(adIdx + outElements,1, mxREAL);
-			memcpy(((double*) mxGetData(ad_OUT)) + adIdx, outReal, outElements * mxGetElementSize(ad_OUT));
-		
-			// Cleanup
-			mxFree(outReal);  
 			break;
 		}
 
@@ -497,15 +699,14 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 			int outIdx, outElements;
 			double *outReal;
 
-			// Preallocate heap
-			outReal = (double*)mxCalloc(rows, sizeof(double));
-
-			switch (s_mapStringValues[taFuncNameIn])
+			switch (taFunc)
 			{
 				case ta_add:
+					outReal = taOutput(vector_OUT, rows, TA_ADD_Lookback());
 					retCode = TA_ADD(startIdx, endIdx, firstVecPtr, secondVecPtr, &outIdx, &outElements, outReal);
 					break;
 				case ta_sub:
+					outReal = taOutput(vector_OUT, rows, TA_SUB_Lookback());
 					retCode = TA_SUB(startIdx, endIdx, firstVecPtr, secondVecPtr, &outIdx, &outElements, outReal);
 					break;
 			}
@@ -513,18 +714,10 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 			// Error handling
 			if (retCode) 
 			{
-				mxFree(outReal);
 				mexPrintf("%s%i","Return code=",retCode);
 				mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 			}
 
-			// Populate Output
-			vector_OUT = mxCreateDoubleMatrix(outIdx + outElements,1, mxREAL);
-			memcpy(((double *) mxGetData(vector_OUT)) + outIdx, outReal, outElements * mxGetElementSize(vector_OUT));
-
-			// Cleanup
-			mxFree(outReal); 
-
 			break;
 		}
 
@@ -626,26 +819,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					slowMA = 10;
 				}
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(adosc_OUT, rows, TA_ADOSC_Lookback(fastMA, slowMA));
 				retCode = TA_ADOSC(startIdx, endIdx, highPtr, lowPtr, closePtr, volPtr, fastMA, slowMA, &adoscIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgTxt("Invocation to 'ta_adosc' failed. Aborting (577).");
 				}
 
-				// Populate Output
-				adosc_OUT = mxCreateDoubleMatrix(adoscIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(adosc_OUT)) + adoscIdx, outReal, outElements * mxGetElementSize(adosc_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
 				break;
 			}
 
@@ -723,45 +907,26 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 14;
 				}
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				if (taFuncNameIn.compare("ta_adx") == 0)
 				{
 					// Invoke with error catch
+					outReal = taOutput(adx_OUT, rows, TA_ADX_Lookback(lookback));
 					retCode = TA_ADX(startIdx, endIdx, highPtr, lowPtr, closePtr, lookback, &adxIdx, &outElements, outReal);
 				}
 				else
 				{
 					// Invoke with error catch
+					outReal = taOutput(adx_OUT, rows, TA_ADXR_Lookback(lookback));
 					retCode = TA_ADXR(startIdx, endIdx, highPtr, lowPtr, closePtr, lookback, &adxIdx, &outElements, outReal);
 				}
 				
-
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				adx_OUT = mxCreateDoubleMatrix(adxIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(adx_OUT)) + adxIdx, outReal, outElements * mxGetElementSize(adx_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(adx_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					outPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 		
@@ -855,7 +1020,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 						mexErrMsgIdAndTxt( "MATLAB:taInvoke:inputErr",
 						"The slowMA (%d) must not be less than the fastMA (%d). Aborting (%d).", slowMA, fastMA, codeLine);
 
-
 					/* Get the scalar inputs */
 					// Assign
 					fastMA = (int)mxGetScalar(fastMA_IN);
@@ -893,15 +1057,14 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// Validate
 				typeMAcheck(taFuncNameIn, taFuncDesc, taFuncOptName, typeMA);
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));			// added cast
-
-				switch (s_mapStringValues[taFuncNameIn])
+				switch (taFunc)
 				{
 					case ta_apo:       
+						outReal = taOutput(po_OUT, rows, TA_APO_Lookback(fastMA, slowMA, (TA_MAType)typeMA));
 						retCode = TA_APO(startIdx, endIdx, pricePtr, fastMA, slowMA, (TA_MAType)typeMA, &poIdx, &outElements, outReal);
 						break;
 					case ta_ppo:
+						outReal = taOutput(po_OUT, rows, TA_PPO_Lookback(fastMA, slowMA, (TA_MAType)typeMA));
 						retCode = TA_PPO(startIdx, endIdx, pricePtr, fastMA, slowMA, (TA_MAType)typeMA, &poIdx, &outElements, outReal);
 						break;
 				}
@@ -910,17 +1073,10 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgTxt("Invocation to 'ta_apo' failed. Aborting (843).");
 				}
 
-				// Populate Output
-				po_OUT = mxCreateDoubleMatrix(poIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(po_OUT)) + poIdx, outReal, outElements * mxGetElementSize(po_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
 				break;
 			}
 
@@ -997,44 +1153,19 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 14;
 				}
 
-				// Preallocate heap
-				aroonUp = (double*)mxCalloc(rows, sizeof(double));
-				aroonDn = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				int taLookback = TA_AROON_Lookback(lookback);
+				aroonDn = taOutput(aroonDn_OUT, rows, taLookback);
+				aroonUp = taOutput(aroonUp_OUT, rows, taLookback);
 				retCode = TA_AROON(startIdx, endIdx, highPtr, lowPtr, lookback, &aroonIdx, &outElements, aroonDn, aroonUp);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(aroonUp);
-					mxFree(aroonDn);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				aroonDn_OUT = mxCreateDoubleMatrix(aroonIdx + outElements,1, mxREAL);
-				aroonUp_OUT = mxCreateDoubleMatrix(aroonIdx + outElements,1, mxREAL);
-				
-				memcpy(((double *) mxGetData(aroonDn_OUT)) + aroonIdx, aroonDn, outElements * mxGetElementSize(aroonDn_OUT));
-				memcpy(((double *) mxGetData(aroonUp_OUT)) + aroonIdx, aroonUp, outElements * mxGetElementSize(aroonUp_OUT));
-
-				// Cleanup
-				mxFree(aroonDn); 
-				mxFree(aroonUp);
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *upPtr = mxGetPr(aroonUp_OUT);
-				double *dnPtr = mxGetPr(aroonDn_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					upPtr[iter] = m_Nan;
-					dnPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 			
@@ -1109,36 +1240,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 14;
 				}
 
-				// Preallocate heap
-				aroonOsc = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				aroonOsc = taOutput(aroonOsc_OUT, rows, TA_AROONOSC_Lookback(lookback));
 				retCode = TA_AROONOSC(startIdx, endIdx, highPtr, lowPtr, lookback, &aroonoscIdx, &outElements, aroonOsc);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(aroonOsc);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				aroonOsc_OUT = mxCreateDoubleMatrix(aroonoscIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(aroonOsc_OUT)) + aroonoscIdx, aroonOsc, outElements * mxGetElementSize(aroonOsc_OUT));
-
-				// Cleanup
-				mxFree(aroonOsc); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(aroonOsc_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					outPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -1197,27 +1309,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int asinIdx, outElements;
 				double *outReal;
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(asin_OUT, rows, TA_ASIN_Lookback());
 				retCode = TA_ASIN(startIdx, endIdx, sinPtr, &asinIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgTxt("Invocation to 'ta_acos' failed. Aborting (1140).");
 				}
 
-				// Populate Output
-				asin_OUT = mxCreateDoubleMatrix(asinIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(asin_OUT)) + asinIdx, outReal, outElements * mxGetElementSize(asin_OUT));
-
-				// Cleanup
-				mxFree(outReal);
-
 				break;
 			}
 			
@@ -1275,27 +1377,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int atanIdx, outElements;
 				double *outReal;
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(atan_OUT, rows, TA_ATAN_Lookback());
 				retCode = TA_ATAN(startIdx, endIdx, tanPtr, &atanIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgTxt("Invocation to 'ta_atan' failed. Aborting (1219).");
 				}
 
-				// Populate Output
-				atan_OUT = mxCreateDoubleMatrix(atanIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(atan_OUT)) + atanIdx, outReal, outElements * mxGetElementSize(atan_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
 				break;
 			}
 
@@ -1373,35 +1465,16 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 14;
 				}
 
-				// Preallocate heap
-				outReal	= (double*)mxCalloc(rows, sizeof(double));
-
+				outReal = taOutput(atr_OUT, rows, TA_ATR_Lookback(lookback));
 				retCode = TA_ATR(startIdx, endIdx, highPtr, lowPtr, closePtr, lookback, &atrIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				atr_OUT = mxCreateDoubleMatrix(atrIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(atr_OUT)) + atrIdx, outReal, outElements * mxGetElementSize(atr_OUT));
-
-				// Cleanup
-				mxFree(outReal);
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(atr_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					outPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -1475,7 +1548,7 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				//		always positive values.
 
 				// Strings for validation feedback
-				switch (s_mapStringValues[taFuncNameIn])
+				switch (taFunc)
 				{
 				case ta_avgdev:
 					taFuncDesc = "Average Deviation";
@@ -1568,7 +1641,7 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = (int)mxGetScalar(lookback_IN);
 
 					// Validation
-					switch (s_mapStringValues[taFuncNameIn])
+					switch (taFunc)
 					{
 						// Throws an error if ....
 						// < 2
@@ -1599,7 +1672,7 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				else
 				// Default lookback period
 				{
-					switch (s_mapStringValues[taFuncNameIn])
+					switch (taFunc)
 					{
 						case ta_roc:
 						case ta_rocp:
@@ -1624,50 +1697,60 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					}	
 				}
 
-				// Preallocate heap
-				outReal	= (double*)mxCalloc(rows, sizeof(double));
-
-				switch (s_mapStringValues[taFuncNameIn])
+				switch (taFunc)
 				{
 					case ta_avgdev:
+						outReal = taOutput(vec_OUT, rows, TA_AVGDEV_Lookback(lookback));
 						retCode = TA_AVGDEV(startIdx, endIdx, dataPtr, lookback, &vecIdx, &outElements, outReal);
 						break;
 					case ta_roc:
+						outReal = taOutput(vec_OUT, rows, TA_ROC_Lookback(lookback));
 						retCode = TA_ROC(startIdx, endIdx, dataPtr, lookback, &vecIdx, &outElements, outReal);
 						break;
 					case ta_rocp:
+						outReal = taOutput(vec_OUT, rows, TA_ROCP_Lookback(lookback));
 						retCode = TA_ROCP(startIdx, endIdx, dataPtr, lookback, &vecIdx, &outElements, outReal);
 						break;
 					case ta_rocr:
+						outReal = taOutput(vec_OUT, rows, TA_ROCR_Lookback(lookback));
 						retCode = TA_ROCR(startIdx, endIdx, dataPtr, lookback, &vecIdx, &outElements, outReal);
 						break;
 					case ta_rocr100:
+						outReal = taOutput(vec_OUT, rows, TA_ROCR100_Lookback(lookback));
 						retCode = TA_ROCR100(startIdx, endIdx, dataPtr, lookback, &vecIdx, &outElements, outReal);
 						break;
 					case ta_rsi:
+						outReal = taOutput(vec_OUT, rows, TA_RSI_Lookback(lookback));
 						retCode = TA_RSI(startIdx, endIdx, dataPtr, lookback, &vecIdx, &outElements, outReal);
 						break;
 					case ta_sma:
+						outReal = taOutput(vec_OUT, rows, TA_SMA_Lookback(lookback));
 						retCode = TA_SMA(startIdx, endIdx, dataPtr, lookback, &vecIdx, &outElements, outReal);
 						break;
 					case ta_sum:
+						outReal = taOutput(vec_OUT, rows, TA_SUM_Lookback(lookback));
 						retCode = TA_SUM(startIdx, endIdx, dataPtr, lookback, &vecIdx, &outElements, outReal);
 						break;
 					case ta_tema:
+						outReal = taOutput(vec_OUT, rows, TA_TEMA_Lookback(lookback));
 						retCode = TA_TEMA(startIdx, endIdx, dataPtr, lookback, &vecIdx, &outElements, outReal);
 						// Update lookback value for NaN routine
 						lookback = (lookback - 1) * 3;
 						break;
 					case ta_trima:
+						outReal = taOutput(vec_OUT, rows, TA_TRIMA_Lookback(lookback));
 						retCode = TA_TRIMA(startIdx, endIdx, dataPtr, lookback, &vecIdx, &outElements, outReal);
 						break;
 					case ta_trix:
+						outReal = taOutput(vec_OUT, rows, TA_TRIX_Lookback(lookback));
 						retCode = TA_TRIX(startIdx, endIdx, dataPtr, lookback, &vecIdx, &outElements, outReal);
 						break;
 					case ta_tsf:
+						outReal = taOutput(vec_OUT, rows, TA_TSF_Lookback(lookback));
 						retCode = TA_TSF(startIdx, endIdx, dataPtr, lookback, &vecIdx, &outElements, outReal);
 						break;
 					case ta_wma:
+						outReal = taOutput(vec_OUT, rows, TA_WMA_Lookback(lookback));
 						retCode = TA_WMA(startIdx, endIdx, dataPtr, lookback, &vecIdx, &outElements, outReal);
 						break;
 				}
@@ -1675,27 +1758,10 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				vec_OUT = mxCreateDoubleMatrix(vecIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(vec_OUT)) + vecIdx, outReal, outElements * mxGetElementSize(vec_OUT));
-
-				// Cleanup
-				mxFree(outReal);
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(vec_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					outPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -1758,26 +1824,16 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int avgpriceIdx, outElements;
 				double *outReal;
 
-				// Preallocate heap
-				outReal	= (double*)mxCalloc(rows, sizeof(double));
-
+				outReal = taOutput(avgPrice_OUT, rows, TA_AVGPRICE_Lookback());
 				retCode = TA_AVGPRICE(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &avgpriceIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				avgPrice_OUT = mxCreateDoubleMatrix(avgpriceIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(avgPrice_OUT)) + avgpriceIdx, outReal, outElements * mxGetElementSize(avgPrice_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
 				break;
 			}
 
@@ -1929,49 +1985,19 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// Validate
 				typeMAcheck(taFuncNameIn, taFuncDesc, taFuncOptName, typeMA);
 
-				// Preallocate heap
-				bbUpper	= (double*)mxCalloc(rows, sizeof(double));
-				bbMid	= (double*)mxCalloc(rows, sizeof(double));
-				bbLower	= (double*)mxCalloc(rows, sizeof(double));
-
+				int taLookback = TA_BBANDS_Lookback(lookback, upMult, dnMult, (TA_MAType)typeMA);
+				bbUpper = taOutput(bbUpper_OUT, rows, taLookback);
+				bbMid = taOutput(bbMid_OUT, rows, taLookback);
+				bbLower = taOutput(bbLower_OUT, rows, taLookback);
 				retCode = TA_BBANDS(startIdx, endIdx, dataPtr, lookback, upMult,dnMult, (TA_MAType)typeMA, &bbandsIdx, &outElements, bbUpper, bbMid, bbLower);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(bbUpper);
-					mxFree(bbMid);
-					mxFree(bbLower);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgTxt("Invocation to 'ta_bbands' failed. Aborting (1604).");
 				}
 
-				// Populate Output
-				bbUpper_OUT = mxCreateDoubleMatrix(bbandsIdx + outElements,1, mxREAL);
-				bbMid_OUT = mxCreateDoubleMatrix(bbandsIdx + outElements,1, mxREAL);
-				bbLower_OUT = mxCreateDoubleMatrix(bbandsIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(bbUpper_OUT)) + bbandsIdx, bbUpper, outElements * mxGetElementSize(bbUpper_OUT));
-				memcpy(((double *) mxGetData(bbMid_OUT)) + bbandsIdx, bbMid, outElements * mxGetElementSize(bbMid_OUT));
-				memcpy(((double *) mxGetData(bbLower_OUT)) + bbandsIdx, bbLower, outElements * mxGetElementSize(bbLower_OUT));
-
-				// Cleanup
-				mxFree(bbUpper); 
-				mxFree(bbMid); 
-				mxFree(bbLower); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *uBandPtr = mxGetPr(bbUpper_OUT);
-				double *mBandPtr = mxGetPr(bbMid_OUT);
-				double *lBandPtr = mxGetPr(bbLower_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					uBandPtr[iter] = m_Nan;
-					mBandPtr[iter] = m_Nan;
-					lBandPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -2056,26 +2082,16 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 5;
 				}
 
-				// Preallocate heap
-				outReal	= (double*)mxCalloc(rows, sizeof(double));
-
+				outReal = taOutput(beta_OUT, rows, TA_BETA_Lookback(lookback));
 				retCode = TA_BETA(startIdx, endIdx, indPtr, basePtr, lookback, &betaIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				beta_OUT = mxCreateDoubleMatrix(betaIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(beta_OUT)) + betaIdx, outReal, outElements * mxGetElementSize(beta_OUT));
-
-				// Cleanup
-				mxFree(outReal);
-
 				break;
 			}
 
@@ -2138,26 +2154,16 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int bopIdx, outElements;
 				double *outReal;
 
-				// Preallocate heap
-				outReal	= (double*)mxCalloc(rows, sizeof(double));
-
+				outReal = taOutput(bop_OUT, rows, TA_BOP_Lookback());
 				retCode = TA_BOP(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &bopIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				bop_OUT = mxCreateDoubleMatrix(bopIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(bop_OUT)) + bopIdx, outReal, outElements * mxGetElementSize(bop_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
 				break;
 			}
 
@@ -2235,35 +2241,16 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 14;
 				}
 
-				// Preallocate heap
-				outReal	= (double*)mxCalloc(rows, sizeof(double));
-
+				outReal = taOutput(cci_OUT, rows, TA_CCI_Lookback(lookback));
 				retCode = TA_CCI(startIdx, endIdx, highPtr, lowPtr, closePtr, lookback, &cciIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				cci_OUT = mxCreateDoubleMatrix(cciIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(cci_OUT)) + cciIdx, outReal, outElements * mxGetElementSize(cci_OUT));
-
-				// Cleanup
-				mxFree(outReal);
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(cci_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					outPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -2389,44 +2376,48 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int cdlIdx, outElements;
 				int *outInt;
 
-				// Preallocate heap
-				outInt	= (int*)mxCalloc(rows, sizeof(int));
-
 				// Candlestick Pattern Switch
-				switch (s_mapStringValues[taFuncNameIn])
+				switch (taFunc)
 				{
 					case ta_cdl2crows:
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDL2CROWS_Lookback());
 							retCode = TA_CDL2CROWS(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdl3blackcrows:   
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDL3BLACKCROWS_Lookback());
 							retCode = TA_CDL3BLACKCROWS(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdl3inside:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDL3INSIDE_Lookback());
 							retCode = TA_CDL3INSIDE(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdl3linestrike: 
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDL3LINESTRIKE_Lookback());
 							retCode = TA_CDL3LINESTRIKE(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdl3outside:
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDL3OUTSIDE_Lookback());
 							retCode = TA_CDL3OUTSIDE(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdl3starsinsouth:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDL3STARSINSOUTH_Lookback());
 							retCode = TA_CDL3STARSINSOUTH(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdl3whitesoldiers:   
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDL3WHITESOLDIERS_Lookback());
 							retCode = TA_CDL3WHITESOLDIERS(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}			
@@ -2464,41 +2455,48 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 								pctPen = .3;
 							}
 
-							switch (s_mapStringValues[taFuncNameIn])
+							switch (taFunc)
 							{
 								case ta_cdlabandonedbaby:
 									{
+										outInt = taOutputInt(cdl_OUT, rows, TA_CDLABANDONEDBABY_Lookback(pctPen));
 										retCode = TA_CDLABANDONEDBABY(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, pctPen, &cdlIdx, &outElements, outInt);
 										break;
 									}
 
 								case ta_cdldarkcloudcover:
 									{
+										outInt = taOutputInt(cdl_OUT, rows, TA_CDLDARKCLOUDCOVER_Lookback(pctPen));
 										retCode = TA_CDLDARKCLOUDCOVER(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, pctPen, &cdlIdx, &outElements, outInt);
 										break;
 									}
 								case ta_cdleveningdojistar:  
 									{
+										outInt = taOutputInt(cdl_OUT, rows, TA_CDLEVENINGDOJISTAR_Lookback(pctPen));
 										retCode = TA_CDLEVENINGDOJISTAR(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, pctPen, &cdlIdx, &outElements, outInt);
 										break;
 									}
 								case ta_cdleveningstar:  
 									{
+										outInt = taOutputInt(cdl_OUT, rows, TA_CDLEVENINGSTAR_Lookback(pctPen));
 										retCode = TA_CDLEVENINGSTAR(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, pctPen, &cdlIdx, &outElements, outInt);
 										break;
 									}
 								case ta_cdlmathold:  
 									{
+										outInt = taOutputInt(cdl_OUT, rows, TA_CDLMATHOLD_Lookback(pctPen));
 										retCode = TA_CDLMATHOLD(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr,  pctPen, &cdlIdx, &outElements, outInt);
 										break;
 									}
 								case ta_cdlmorningdojistar:  
 									{
+										outInt = taOutputInt(cdl_OUT, rows, TA_CDLMORNINGDOJISTAR_Lookback(pctPen));
 										retCode = TA_CDLMORNINGDOJISTAR(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, pctPen, &cdlIdx, &outElements, outInt);
 										break;
 									}
 								case ta_cdlmorningstar:  
 									{
+										outInt = taOutputInt(cdl_OUT, rows, TA_CDLMORNINGSTAR_Lookback(pctPen));
 										retCode = TA_CDLMORNINGSTAR(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, pctPen, &cdlIdx, &outElements, outInt);
 										break;
 									}
@@ -2508,236 +2506,283 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 						}
 					case ta_cdladvanceblock:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLADVANCEBLOCK_Lookback());
 							retCode = TA_CDLADVANCEBLOCK(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlbelthold:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLBELTHOLD_Lookback());
 							retCode = TA_CDLBELTHOLD(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlbreakaway:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLBREAKAWAY_Lookback());
 							retCode = TA_CDLBREAKAWAY(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlclosingmarubozu:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLCLOSINGMARUBOZU_Lookback());
 							retCode = TA_CDLCLOSINGMARUBOZU(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlconcealbabyswall:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLCONCEALBABYSWALL_Lookback());
 							retCode = TA_CDLCONCEALBABYSWALL(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlcounterattack:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLCOUNTERATTACK_Lookback());
 							retCode = TA_CDLCOUNTERATTACK(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdldoji:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLDOJI_Lookback());
 							retCode = TA_CDLDOJI(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdldojistar:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLDOJISTAR_Lookback());
 							retCode = TA_CDLDOJISTAR(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdldragonflydoji:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLDRAGONFLYDOJI_Lookback());
 							retCode = TA_CDLDRAGONFLYDOJI(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlengulfing:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLENGULFING_Lookback());
 							retCode = TA_CDLENGULFING(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlgapsidesidewhite:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLGAPSIDESIDEWHITE_Lookback());
 							retCode = TA_CDLGAPSIDESIDEWHITE(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlgravestonedoji:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLGRAVESTONEDOJI_Lookback());
 							retCode = TA_CDLGRAVESTONEDOJI(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlhammer:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLHAMMER_Lookback());
 							retCode = TA_CDLHAMMER(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlhangingman:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLHANGINGMAN_Lookback());
 							retCode = TA_CDLHANGINGMAN(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlharami:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLHARAMI_Lookback());
 							retCode = TA_CDLHARAMI(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlharamicross:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLHARAMICROSS_Lookback());
 							retCode = TA_CDLHARAMICROSS(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlhighwave:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLHIGHWAVE_Lookback());
 							retCode = TA_CDLHIGHWAVE(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlhikkake:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLHIKKAKE_Lookback());
 							retCode = TA_CDLHIKKAKE(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlhikkakemod:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLHIKKAKEMOD_Lookback());
 							retCode = TA_CDLHIKKAKEMOD(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlhomingpigeon:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLHIKKAKEMOD_Lookback());
 							retCode = TA_CDLHIKKAKEMOD(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlidentical3crows:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLIDENTICAL3CROWS_Lookback());
 							retCode = TA_CDLIDENTICAL3CROWS(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlinneck:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLINNECK_Lookback());
 							retCode = TA_CDLINNECK(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlinvertedhammer:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLINVERTEDHAMMER_Lookback());
 							retCode = TA_CDLINVERTEDHAMMER(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlkicking:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLKICKING_Lookback());
 							retCode = TA_CDLKICKING(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlkickingbylength:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLKICKINGBYLENGTH_Lookback());
 							retCode = TA_CDLKICKINGBYLENGTH(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlladderbottom:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLLADDERBOTTOM_Lookback());
 							retCode = TA_CDLLADDERBOTTOM(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdllongleggeddoji:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLLONGLEGGEDDOJI_Lookback());
 							retCode = TA_CDLLONGLEGGEDDOJI(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdllongline:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLLONGLINE_Lookback());
 							retCode = TA_CDLLONGLINE(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlmarubozu:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLMARUBOZU_Lookback());
 							retCode = TA_CDLMARUBOZU(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlmatchinglow:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLMATCHINGLOW_Lookback());
 							retCode = TA_CDLMATCHINGLOW(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlonneck:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLONNECK_Lookback());
 							retCode = TA_CDLONNECK(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlpiercing:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLPIERCING_Lookback());
 							retCode = TA_CDLPIERCING(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlrickshawman:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLRICKSHAWMAN_Lookback());
 							retCode = TA_CDLRICKSHAWMAN(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlrisefall3methods:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLRISEFALL3METHODS_Lookback());
 							retCode = TA_CDLRISEFALL3METHODS(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlseparatinglines:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLSEPARATINGLINES_Lookback());
 							retCode = TA_CDLSEPARATINGLINES(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlshootingstar:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLSHOOTINGSTAR_Lookback());
 							retCode = TA_CDLSHOOTINGSTAR(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlshortline:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLSHORTLINE_Lookback());
 							retCode = TA_CDLSHORTLINE(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlspinningtop:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLSPINNINGTOP_Lookback());
 							retCode = TA_CDLSPINNINGTOP(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlstalledpattern:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLSTALLEDPATTERN_Lookback());
 							retCode = TA_CDLSTALLEDPATTERN(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlsticksandwich:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLSTICKSANDWICH_Lookback());
 							retCode = TA_CDLSTICKSANDWICH(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdltakuri:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLTAKURI_Lookback());
 							retCode = TA_CDLTAKURI(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdltasukigap:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLTASUKIGAP_Lookback());
 							retCode = TA_CDLTASUKIGAP(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlthrusting:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLTHRUSTING_Lookback());
 							retCode = TA_CDLTHRUSTING(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdltristar:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLTRISTAR_Lookback());
 							retCode = TA_CDLTRISTAR(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlunique3river:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLUNIQUE3RIVER_Lookback());
 							retCode = TA_CDLUNIQUE3RIVER(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlupsidegap2crows:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLUPSIDEGAP2CROWS_Lookback());
 							retCode = TA_CDLUPSIDEGAP2CROWS(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}
 					case ta_cdlxsidegap3methods:  
 						{
+							outInt = taOutputInt(cdl_OUT, rows, TA_CDLXSIDEGAP3METHODS_Lookback());
 							retCode = TA_CDLXSIDEGAP3METHODS(startIdx, endIdx, openPtr, highPtr, lowPtr, closePtr, &cdlIdx, &outElements, outInt);
 							break;
 						}					
@@ -2746,18 +2791,10 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outInt);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				cdl_OUT = mxCreateNumericMatrix(cdlIdx + outElements,1, mxINT32_CLASS, mxREAL);
-				memcpy((int*)(mxGetData(cdl_OUT)) + cdlIdx, outInt, outElements * mxGetElementSize(cdl_OUT));
-
-				// Cleanup
-				mxFree(outInt); 
-
 				break;
 			}
 
@@ -2814,27 +2851,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int dataIdx, outElements;
 				double *outReal;
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(ceil_OUT, rows, TA_CEIL_Lookback());
 				retCode = TA_CEIL(startIdx, endIdx, dataPtr, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgTxt("Invocation to 'ta_ceil' failed. Aborting (2562).");
 				}
 
-				// Populate Output
-				ceil_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(ceil_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(ceil_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
 				break;
 			}
 			
@@ -2910,36 +2937,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 14;
 				}
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(cmo_OUT, rows, TA_CMO_Lookback(lookback));
 				retCode = TA_CMO(startIdx, endIdx, dataPtr, lookback, &cmoIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				cmo_OUT = mxCreateDoubleMatrix(cmoIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(cmo_OUT)) + cmoIdx, outReal, outElements * mxGetElementSize(cmo_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(cmo_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					outPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 			
@@ -2956,7 +2964,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// OUTPUT
 				//		corr		vector of Correlation Coefficient values
 
-
 				// Check number of inputs
 				if (nrhs < 3 || nrhs > 4)
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:ta_correl:NumInputs",
@@ -3020,36 +3027,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 30;
 				}
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(corr_OUT, rows, TA_CORREL_Lookback(lookback));
 				retCode = TA_CORREL(startIdx, endIdx, obsAPtr, obsBPtr, lookback, &corrIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				corr_OUT = mxCreateDoubleMatrix(corrIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(corr_OUT)) + corrIdx, outReal, outElements * mxGetElementSize(corr_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(corr_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					outPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -3107,27 +3095,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int cosIdx, outElements;
 				double *outReal;
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(cos_OUT, rows, TA_COS_Lookback());
 				retCode = TA_COS(startIdx, endIdx, thetaPtr, &cosIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgTxt("Invocation to 'ta_cos' failed. Aborting (2856).");
 				}
 
-				// Populate Output
-				cos_OUT = mxCreateDoubleMatrix(cosIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(cos_OUT)) + cosIdx, outReal, outElements * mxGetElementSize(cos_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
 				break;
 			}
 
@@ -3185,27 +3163,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int coshIdx, outElements;
 				double *outReal;
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(cosh_OUT, rows, TA_COSH_Lookback());
 				retCode = TA_COSH(startIdx, endIdx, thetaPtr, &coshIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgTxt("Invocation to 'ta_cosh' failed. Aborting (2935).");
 				}
 
-				// Populate Output
-				cosh_OUT = mxCreateDoubleMatrix(coshIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(cos_OUT)) + coshIdx, outReal, outElements * mxGetElementSize(cosh_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
 				break;
 			}
 		
@@ -3221,7 +3189,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// OUTPUT
 				//		DEMA		A single vector of double exponential moving average values
 
-
 				// Check number of inputs
 				if (nrhs < 2 || nrhs > 3)
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:ta_dema:NumInputs",
@@ -3288,36 +3255,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 30;
 				}
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(dema_OUT, rows, TA_DEMA_Lookback(lookback));
 				retCode = TA_DEMA(startIdx, endIdx, dataPtr, lookback, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				dema_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(dema_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(dema_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(dema_OUT);
-
-				for (int iter = (lookback * 2) - 1; iter < lookback; iter++)
-				{
-					outPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 			
@@ -3381,26 +3329,16 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int quotIdx, outElements;
 				double *quotient;
 
-				// Preallocate heap
-				quotient = (double*)mxCalloc(rows, sizeof(double));
-
+				quotient = taOutput(quot_OUT, rows, TA_DIV_Lookback());
 				retCode = TA_DIV(startIdx, endIdx, dividPtr, divisPtr, &quotIdx, &outElements, quotient);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(quotient);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				quot_OUT = mxCreateDoubleMatrix(quotIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(quot_OUT)) + quotIdx, quotient, outElements * mxGetElementSize(quot_OUT));
-
-				// Cleanup
-				mxFree(quotient); 
-
 				break;
 			}
 
@@ -3488,36 +3426,16 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 						"The %s lookback must be an integer equal to or greater than 2. Aborting (%d).", taFuncDesc, codeLine);
 				}
 
-
-				// Preallocate heap
-				outReal	= (double*)mxCalloc(rows, sizeof(double));
-
+				outReal = taOutput(dx_OUT, rows, TA_DX_Lookback(lookback));
 				retCode = TA_DX(startIdx, endIdx, highPtr, lowPtr, closePtr, lookback, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				dx_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(dx_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(dx_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *dxPtr = mxGetPr(dx_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					dxPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 			
@@ -3533,7 +3451,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// OUTPUT
 				//		EMA		vector of exponential moving average values
 
-
 				// Check number of inputs
 				if (nrhs < 2 || nrhs > 3)
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:ta_ema:NumInputs",
@@ -3600,36 +3517,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 30;
 				}
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(ema_OUT, rows, TA_EMA_Lookback(lookback));
 				retCode = TA_EMA(startIdx, endIdx, dataPtr, lookback, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				ema_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(ema_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(ema_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(ema_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					outPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -3646,7 +3544,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				//		EXP		vector of e ^ observation values
 				//				e.g. e ^ 1 = ~2.718
 
-
 				// Check number of inputs
 				if (nrhs != 2)
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:ta_exp:NumInputs",
@@ -3689,27 +3586,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int dataIdx, outElements;
 				double *outReal;
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(e_OUT, rows, TA_EXP_Lookback());
 				retCode = TA_EXP(startIdx, endIdx, dataPtr, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				e_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(e_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(e_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
 				break;
 			}
 
@@ -3766,27 +3653,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int dataIdx, outElements;
 				double *outReal;
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(ceil_OUT, rows, TA_FLOOR_Lookback());
 				retCode = TA_FLOOR(startIdx, endIdx, dataPtr, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgTxt("Invocation to 'ta_floor' failed. Aborting (3458).");
 				}
 
-				// Populate Output
-				ceil_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(ceil_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(ceil_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
 				break;
 			}
 
@@ -3849,36 +3726,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int dataIdx, outElements;
 				double *outReal;
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(period_OUT, rows, TA_HT_DCPERIOD_Lookback());
 				retCode = TA_HT_DCPERIOD(startIdx, endIdx, dataPtr, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgTxt("Invocation to 'ta_ht_dcperiod' failed. Aborting (3536).");
 				}
 
-				// Populate Output
-				period_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(period_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(period_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(period_OUT);
-
-				for (int iter = 0; iter < 32; iter++)
-				{
-					outPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -3941,36 +3799,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int dataIdx, outElements;
 				double *outReal;
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(phase_OUT, rows, TA_HT_DCPHASE_Lookback());
 				retCode = TA_HT_DCPHASE(startIdx, endIdx, dataPtr, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgTxt("Invocation to 'ta_ht_dcperiod' failed. Aborting (3536).");
 				}
 
-				// Populate Output
-				phase_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(phase_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(phase_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(phase_OUT);
-
-				for (int iter = 0; iter < 63; iter++)
-				{
-					outPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 		
@@ -4040,43 +3879,19 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int dataIdx, outElements;
 				double *inPhase, *quad;
 
-				// Preallocate heap
-				inPhase = (double*)mxCalloc(rows, sizeof(double));
-				quad = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				int taLookback = TA_HT_PHASOR_Lookback();
+				inPhase = taOutput(inPhase_OUT, rows, taLookback);
+				quad = taOutput(quad_OUT, rows, taLookback);
 				retCode = TA_HT_PHASOR(startIdx, endIdx, dataPtr, &dataIdx, &outElements, inPhase, quad);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(inPhase);
-					mxFree(quad);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgTxt("Invocation to 'ta_ht_dcperiod' failed. Aborting (3736).");
 				}
 
-				// Populate Output
-				inPhase_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				quad_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(inPhase_OUT)) + dataIdx, inPhase, outElements * mxGetElementSize(inPhase_OUT));
-				memcpy(((double *) mxGetData(quad_OUT)) + dataIdx, quad, outElements * mxGetElementSize(quad_OUT));
-
-				// Cleanup
-				mxFree(inPhase); 
-				mxFree(quad); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *inPhasePtr = mxGetPr(inPhase_OUT);
-				double *quadPtr = mxGetPr(quad_OUT);
-
-				for (int iter = 0; iter < 32; iter++)
-				{
-					inPhasePtr[iter] = m_Nan;
-					quadPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -4164,43 +3979,19 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int dataIdx, outElements;
 				double *sine, *leadSine;
 
-				// Preallocate heap
-				sine = (double*)mxCalloc(rows, sizeof(double));
-				leadSine = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				int taLookback = TA_HT_SINE_Lookback();
+				sine = taOutput(sine_OUT, rows, taLookback);
+				leadSine = taOutput(leadSine_OUT, rows, taLookback);
 				retCode = TA_HT_SINE(startIdx, endIdx, dataPtr, &dataIdx, &outElements, sine, leadSine);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(sine);
-					mxFree(leadSine);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgTxt("Invocation to 'ta_ht_sine' failed. Aborting (3861).");
 				}
 
-				// Populate Output
-				sine_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				leadSine_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(sine_OUT)) + dataIdx, sine, outElements * mxGetElementSize(sine_OUT));
-				memcpy(((double *) mxGetData(leadSine_OUT)) + dataIdx, leadSine, outElements * mxGetElementSize(leadSine_OUT));
-
-				// Cleanup
-				mxFree(sine); 
-				mxFree(leadSine); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *sinePtr = mxGetPr(sine_OUT);
-				double *leadSinePtr = mxGetPr(leadSine_OUT);
-
-				for (int iter = 0; iter < 63; iter++)
-				{
-					sinePtr[iter] = m_Nan;
-					leadSinePtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -4263,36 +4054,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int dataIdx, outElements;
 				double *outReal;
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(trend_OUT, rows, TA_HT_TRENDLINE_Lookback());
 				retCode = TA_HT_TRENDLINE(startIdx, endIdx, dataPtr, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgTxt("Invocation to 'ta_ht_trendline' failed. Aborting (3959).");
 				}
 
-				// Populate Output
-				trend_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(trend_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(trend_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(trend_OUT);
-
-				for (int iter = 0; iter < 63; iter++)
-				{
-					outPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -4355,36 +4127,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int dataIdx, outElements;
 				int *outInt;
 
-				// Preallocate heap
-				outInt = (int*)mxCalloc(rows, sizeof(int));
-
 				// Invoke with error catch
+				outInt = taOutputInt(mode_OUT, rows, TA_HT_TRENDMODE_Lookback());
 				retCode = TA_HT_TRENDMODE(startIdx, endIdx, dataPtr, &dataIdx, &outElements, outInt);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outInt);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgTxt("Invocation to 'ta_ht_trendmode' failed. Aborting (4046).");
 				}
 
-				// Populate Output
-				mode_OUT = mxCreateNumericMatrix(dataIdx + outElements,1, mxINT32_CLASS, mxREAL);
-				memcpy(((int *) mxGetData(mode_OUT)) + dataIdx, outInt, outElements * mxGetElementSize(mode_OUT));
-
-				// Cleanup
-				mxFree(outInt); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(trend_OUT);
-
-				for (int iter = 0; iter < 63; iter++)
-				{
-					outPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -4400,7 +4153,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// OUTPUT
 				//		KAMA		vector of kaufman adaptive moving average values
 
-
 				// Check number of inputs
 				if (nrhs < 2 || nrhs > 3)
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:ta_kama:NumInputs",
@@ -4467,36 +4219,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 30;
 				}
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(kama_OUT, rows, TA_KAMA_Lookback(lookback));
 				retCode = TA_KAMA(startIdx, endIdx, dataPtr, lookback, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				kama_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(kama_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(kama_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(kama_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					outPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -4512,7 +4245,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// OUTPUT
 				//		LINREG		vector of linear regression values
 
-
 				// Check number of inputs
 				if (nrhs < 2 || nrhs > 3)
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:ta_linearreg:NumInputs",
@@ -4579,36 +4311,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 14;
 				}
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(linreg_OUT, rows, TA_LINEARREG_Lookback(lookback));
 				retCode = TA_LINEARREG(startIdx, endIdx, dataPtr, lookback, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				linreg_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(linreg_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(linreg_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(linreg_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					outPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -4636,7 +4349,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				//	TA_LINEARREG_INTERCEPT		Returns 'b'
 				//	TA_TSF						Returns b+m*(period)
 
-
 				// Check number of inputs
 				if (nrhs < 2 || nrhs > 3)
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:ta_linearreg_angle:NumInputs",
@@ -4703,36 +4415,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 14;
 				}
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(linrega_OUT, rows, TA_LINEARREG_ANGLE_Lookback(lookback));
 				retCode = TA_LINEARREG_ANGLE(startIdx, endIdx, dataPtr, lookback, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				linrega_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(linrega_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(linrega_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(linrega_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					outPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -4760,7 +4453,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				//	TA_LINEARREG_INTERCEPT		Returns 'b'
 				//	TA_TSF						Returns b+m*(period)
 
-
 				// Check number of inputs
 				if (nrhs < 2 || nrhs > 3)
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:ta_linearreg_intercept:NumInputs",
@@ -4827,36 +4519,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 14;
 				}
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(linregi_OUT, rows, TA_LINEARREG_INTERCEPT_Lookback(lookback));
 				retCode = TA_LINEARREG_INTERCEPT(startIdx, endIdx, dataPtr, lookback, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				linregi_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(linregi_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(linregi_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(linregi_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					outPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -4884,7 +4557,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				//	TA_LINEARREG_INTERCEPT		Returns 'b'
 				//	TA_TSF						Returns b+m*(period)
 
-
 				// Check number of inputs
 				if (nrhs < 2 || nrhs > 3)
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:ta_linearreg_slope:NumInputs",
@@ -4951,38 +4623,19 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 14;
 				}
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(linregs_OUT, rows, TA_LINEARREG_SLOPE_Lookback(lookback));
 				retCode = TA_LINEARREG_SLOPE(startIdx, endIdx, dataPtr, lookback, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				linregs_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(linregs_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(linregs_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(linregs_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					outPtr[iter] = m_Nan;
-				}
-
-				break;
-			}
+				break;
+			}
 
 		// Vector Log Natural
 		case ta_ln:       
@@ -5037,27 +4690,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int lnIdx, outElements;
 				double *outReal;
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(ln_OUT, rows, TA_LN_Lookback());
 				retCode = TA_LN(startIdx, endIdx, dataPtr, &lnIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgTxt("Invocation to 'ta_ln' failed. Aborting (4735).");
 				}
 
-				// Populate Output
-				ln_OUT = mxCreateDoubleMatrix(lnIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(ln_OUT)) + lnIdx, outReal, outElements * mxGetElementSize(ln_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
 				break;
 			}
 
@@ -5114,27 +4757,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int log10Idx, outElements;
 				double *outReal;
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(log10_OUT, rows, TA_LOG10_Lookback());
 				retCode = TA_LOG10(startIdx, endIdx, dataPtr, &log10Idx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgTxt("Invocation to 'ta_log10' failed. Aborting (4813).");
 				}
 
-				// Populate Output
-				log10_OUT = mxCreateDoubleMatrix(log10Idx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(log10_OUT)) + log10Idx, outReal, outElements * mxGetElementSize(log10_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
 				break;
 			}
 
@@ -5248,36 +4881,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// Validate
 				typeMAcheck(taFuncNameIn, taFuncDesc, taFuncOptName, typeMA);
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(ma_OUT, rows, TA_MA_Lookback(lookback, (TA_MAType)typeMA));
 				retCode = TA_MA(startIdx, endIdx, dataPtr, lookback, (TA_MAType)typeMA, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				ma_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(ma_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(ma_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(ma_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					outPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -5419,53 +5033,19 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					}
 				}
 
-				// Preallocate heap
-				macd		= (double*)mxCalloc(rows, sizeof(double));
-				macdSig		= (double*)mxCalloc(rows, sizeof(double));
-				macdHist	= (double*)mxCalloc(rows, sizeof(double));
-
+				int taLookback = TA_MACD_Lookback(fastMA, slowMA, smoothP);
+				macd = taOutput(macd_OUT, rows, taLookback);
+				macdSig = taOutput(macdSig_OUT, rows, taLookback);
+				macdHist = taOutput(macdHist_OUT, rows, taLookback);
 				retCode = TA_MACD(startIdx, endIdx, dataPtr, fastMA, slowMA, smoothP, &dataIdx, &outElements, macd, macdSig, macdHist);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(macd);
-					mxFree(macdSig);
-					mxFree(macdHist);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				macd_OUT		= mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				macdSig_OUT		= mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				macdHist_OUT	= mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(macd_OUT)) + dataIdx, macd, outElements * mxGetElementSize(macd_OUT));
-				memcpy(((double *) mxGetData(macdSig_OUT)) + dataIdx, macdSig, outElements * mxGetElementSize(macdSig_OUT));
-				memcpy(((double *) mxGetData(macdHist_OUT)) + dataIdx, macdHist, outElements * mxGetElementSize(macdHist_OUT));
-
-				// Cleanup
-				mxFree(macd); 
-				mxFree(macdSig); 
-				mxFree(macdHist); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *macdPtr = mxGetPr(macd_OUT);
-				double *macdSigPtr = mxGetPr(macdSig_OUT);
-				double *macdHistPtr = mxGetPr(macdHist_OUT);
-
-				for (int iter = 0; iter < slowMA; iter++)
-				{
-					macdPtr[iter] = m_Nan;
-					macdSigPtr[iter] = m_Nan;
-				}
-
-				for (int iter = 0; iter < smoothP; iter++)
-				{
-					macdHistPtr[iter] = m_Nan;
-				}
-									
 				break;
 			}
 
@@ -5637,53 +5217,19 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					}
 				}
 
-				// Preallocate heap
-				macd		= (double*)mxCalloc(rows, sizeof(double));
-				macdSig		= (double*)mxCalloc(rows, sizeof(double));
-				macdHist	= (double*)mxCalloc(rows, sizeof(double));
-
+				int taLookback = TA_MACDEXT_Lookback(fastMA, (TA_MAType)fastType, slowMA, (TA_MAType)slowType, smoothP, (TA_MAType)smoothType);
+				macd = taOutput(macd_OUT, rows, taLookback);
+				macdSig = taOutput(macdSig_OUT, rows, taLookback);
+				macdHist = taOutput(macdHist_OUT, rows, taLookback);
 				retCode = TA_MACDEXT(startIdx, endIdx, dataPtr, fastMA, (TA_MAType)fastType, slowMA, (TA_MAType)slowType, smoothP, (TA_MAType)smoothType, &dataIdx, &outElements, macd, macdSig, macdHist);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(macd);
-					mxFree(macdSig);
-					mxFree(macdHist);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				macd_OUT		= mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				macdSig_OUT		= mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				macdHist_OUT	= mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(macd_OUT)) + dataIdx, macd, outElements * mxGetElementSize(macd_OUT));
-				memcpy(((double *) mxGetData(macdSig_OUT)) + dataIdx, macdSig, outElements * mxGetElementSize(macdSig_OUT));
-				memcpy(((double *) mxGetData(macdHist_OUT)) + dataIdx, macdHist, outElements * mxGetElementSize(macdHist_OUT));
-
-				// Cleanup
-				mxFree(macd); 
-				mxFree(macdSig); 
-				mxFree(macdHist); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *macdPtr = mxGetPr(macd_OUT);
-				double *macdSigPtr = mxGetPr(macdSig_OUT);
-				double *macdHistPtr = mxGetPr(macdHist_OUT);
-
-				for (int iter = 0; iter < slowMA; iter++)
-				{
-					macdPtr[iter] = m_Nan;
-					macdSigPtr[iter] = m_Nan;
-				}
-
-				for (int iter = 0; iter < smoothP; iter++)
-				{
-					macdHistPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -5778,53 +5324,19 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					smoothP = 9;
 				}
 
-				// Preallocate heap
-				macd		= (double*)mxCalloc(rows, sizeof(double));
-				macdSig		= (double*)mxCalloc(rows, sizeof(double));
-				macdHist	= (double*)mxCalloc(rows, sizeof(double));
-
+				int taLookback = TA_MACDFIX_Lookback(smoothP);
+				macd = taOutput(macd_OUT, rows, taLookback);
+				macdSig = taOutput(macdSig_OUT, rows, taLookback);
+				macdHist = taOutput(macdHist_OUT, rows, taLookback);
 				retCode = TA_MACDFIX(startIdx, endIdx, dataPtr, smoothP, &dataIdx, &outElements, macd, macdSig, macdHist);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(macd);
-					mxFree(macdSig);
-					mxFree(macdHist);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				macd_OUT		= mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				macdSig_OUT		= mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				macdHist_OUT	= mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(macd_OUT)) + dataIdx, macd, outElements * mxGetElementSize(macd_OUT));
-				memcpy(((double *) mxGetData(macdSig_OUT)) + dataIdx, macdSig, outElements * mxGetElementSize(macdSig_OUT));
-				memcpy(((double *) mxGetData(macdHist_OUT)) + dataIdx, macdHist, outElements * mxGetElementSize(macdHist_OUT));
-
-				// Cleanup
-				mxFree(macd); 
-				mxFree(macdSig); 
-				mxFree(macdHist); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *macdPtr = mxGetPr(macd_OUT);
-				double *macdSigPtr = mxGetPr(macdSig_OUT);
-				double *macdHistPtr = mxGetPr(macdHist_OUT);
-
-				for (int iter = 0; iter < 26; iter++)
-				{
-					macdPtr[iter] = m_Nan;
-					macdSigPtr[iter] = m_Nan;
-				}
-
-				for (int iter = 0; iter < smoothP; iter++)
-				{
-					macdHistPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -5852,7 +5364,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				//	When the MAMA crosses above the FAMA a buy signal is given. 
 				//	Alternatively, when the MAMA crosses below the FAMA a sell signal is given.
 
-
 				// Check number of inputs
 				if (nrhs < 2 || nrhs > 4)
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:ta_mama:NumInputs",
@@ -5959,43 +5470,19 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 						"The MESA ADAPTIVE MOVING AVERAGE slowLmt must be less than or equal to the fastLmt. Aborting (%d).", codeLine);
 				}
 
-				// Preallocate heap
-				mama = (double*)mxCalloc(rows, sizeof(double));
-				fama = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				int taLookback = TA_MAMA_Lookback(fastLmt, slowLmt);
+				mama = taOutput(mama_OUT, rows, taLookback);
+				fama = taOutput(fama_OUT, rows, taLookback);
 				retCode = TA_MAMA(startIdx, endIdx, dataPtr, fastLmt, slowLmt, &dataIdx, &outElements, mama, fama);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(mama);
-					mxFree(fama);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				mama_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				fama_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(mama_OUT)) + dataIdx, mama, outElements * mxGetElementSize(mama_OUT));
-				memcpy(((double *) mxGetData(fama_OUT)) + dataIdx, fama, outElements * mxGetElementSize(fama_OUT));
-
-				// Cleanup
-				mxFree(mama); 
-				mxFree(fama); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *mamaPtr = mxGetPr(mama_OUT);
-				double *famaPtr = mxGetPr(fama_OUT);
-
-				for (int iter = 0; iter < 32; iter++)
-				{
-					mamaPtr[iter] = m_Nan;
-					famaPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -6057,7 +5544,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				rows		= (int)mxGetM(data_IN);
 				colsD		= (int)mxGetN(data_IN);
 				
-
 				// Validate
 				if (colsD != 1)
 				{
@@ -6152,39 +5638,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// Validate
 				typeMAcheck(taFuncNameIn, taFuncDesc, taFuncOptName, typeMA);
 
-				// Preallocate heap
-				mavp = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				mavp = taOutput(mavp_OUT, rows, TA_MAVP_Lookback(minPeriod, maxPeriod, (TA_MAType)typeMA));
 				retCode = TA_MAVP(startIdx, endIdx, dataPtr, periodPtr, minPeriod, maxPeriod, (TA_MAType)typeMA, &dataIdx, &outElements, mavp);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(mavp);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				mavp_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(mavp_OUT)) + dataIdx, mavp, outElements * mxGetElementSize(mavp_OUT));
-
-				// Cleanup
-				mxFree(mavp); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *mavpPtr = mxGetPr(mavp_OUT);
-
-				// Get the larger of the minPeriod or the original lookback period
-				int isGtr = max((int)*periodPtr, minPeriod);
-
-				for (int iter = 0; iter < isGtr; iter++)
-				{
-					mavpPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -6200,7 +5664,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// OUTPUT
 				//		MAX			Vector of maximum value within lookback period
 
-
 				// Check number of inputs
 				if (nrhs < 2 || nrhs > 3)
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:ta_max:NumInputs",
@@ -6267,27 +5730,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 30;
 				}
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(max_OUT, rows, TA_MAX_Lookback(lookback));
 				retCode = TA_MAX(startIdx, endIdx, dataPtr, lookback, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				max_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(max_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(max_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
 				break;
 			}
 
@@ -6303,7 +5756,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// OUTPUT
 				//		MAXIDX		Vector of index locations of maximum value within lookback period
 
-
 				// Check number of inputs
 				if (nrhs < 2 || nrhs > 3)
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:ta_maxindex:NumInputs",
@@ -6370,27 +5822,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 30;
 				}
 
-				// Preallocate heap
-				outInt = (int*)mxCalloc(rows, sizeof(int));
-
 				// Invoke with error catch
+				outInt = taOutputInt(maxidx_OUT, rows, TA_MAXINDEX_Lookback(lookback));
 				retCode = TA_MAXINDEX(startIdx, endIdx, dataPtr, lookback, &dataIdx, &outElements, outInt);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outInt);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				maxidx_OUT = mxCreateNumericMatrix(dataIdx + outElements,1, mxINT32_CLASS, mxREAL);
-				memcpy(((int *) mxGetData(maxidx_OUT)) + dataIdx, outInt, outElements * mxGetElementSize(maxidx_OUT));
-
-				// Cleanup
-				mxFree(outInt); 
-
 				break;
 			}
 
@@ -6407,7 +5849,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// OUTPUT
 				//		MED			Vector of median prices derived from provided inputs
 
-
 				// Check number of inputs
 				if (nrhs != 3)
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:ta_medprice:NumInputs",
@@ -6453,27 +5894,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int dataIdx, outElements;
 				double *outReal;
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(med_OUT, rows, TA_MEDPRICE_Lookback());
 				retCode = TA_MEDPRICE(startIdx, endIdx, highPtr, lowPtr, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				med_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(med_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(med_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
 				break;
 			}
 
@@ -6567,36 +5998,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 14;
 				}
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));			// added cast
-
 				// Invoke with error catch
+				outReal = taOutput(mfi_OUT, rows, TA_MFI_Lookback(lookback));
 				retCode = TA_MFI(startIdx, endIdx, highPtr, lowPtr, closePtr, volPtr, lookback, &adIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgTxt("Invocation to 'ta_ad' failed. Aborting.");
 				}
 
-				// Populate Output
-				mfi_OUT = mxCreateDoubleMatrix(adIdx + outElements,1, mxREAL);
-				memcpy(((double*) mxGetData(mfi_OUT)) + adIdx, outReal, outElements * mxGetElementSize(mfi_OUT));
-
-				// Cleanup
-				mxFree(outReal);  
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(ma_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					outPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -6612,7 +6024,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// OUTPUT
 				//		MID		Vector of midpoint values within lookback period
 
-
 				// Check number of inputs
 				if (nrhs < 2 || nrhs > 3)
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:ta_midpoint:NumInputs",
@@ -6679,27 +6090,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 14;
 				}
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(midpt_OUT, rows, TA_MIDPOINT_Lookback(lookback));
 				retCode = TA_MIDPOINT(startIdx, endIdx, dataPtr, lookback, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				midpt_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(midpt_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(midpt_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
 				break;
 			}
 
@@ -6716,7 +6117,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// OUTPUT
 				//		MID		Vector of midprice values within lookback period
 
-
 				// Check number of inputs
 				if (nrhs < 3 || nrhs > 4)
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:ta_midprice:NumInputs",
@@ -6786,27 +6186,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 14;
 				}
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(midpr_OUT, rows, TA_MIDPRICE_Lookback(lookback));
 				retCode = TA_MIDPRICE(startIdx, endIdx, highPtr, lowPtr, lookback, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				midpr_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(midpr_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(midpr_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
 				break;
 			}
 		
@@ -6822,7 +6212,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// OUTPUT
 				//		MIN			Vector of minimum values within lookback period
 
-
 				// Check number of inputs
 				if (nrhs < 2 || nrhs > 3)
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:ta_min:NumInputs",
@@ -6889,27 +6278,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 30;
 				}
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(min_OUT, rows, TA_MIN_Lookback(lookback));
 				retCode = TA_MIN(startIdx, endIdx, dataPtr, lookback, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				min_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(min_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(min_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
 				break;
 			}
 
@@ -6925,7 +6304,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// OUTPUT
 				//		MINIDX		Vector of index locations of minimum value within lookback period
 
-
 				// Check number of inputs
 				if (nrhs < 2 || nrhs > 3)
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:ta_minindex:NumInputs",
@@ -6992,27 +6370,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 30;
 				}
 
-				// Preallocate heap
-				outInt = (int*)mxCalloc(rows, sizeof(int));
-
 				// Invoke with error catch
+				outInt = taOutputInt(minidx_OUT, rows, TA_MININDEX_Lookback(lookback));
 				retCode = TA_MININDEX(startIdx, endIdx, dataPtr, lookback, &dataIdx, &outElements, outInt);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outInt);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				minidx_OUT = mxCreateNumericMatrix(dataIdx + outElements,1, mxINT32_CLASS, mxREAL);
-				memcpy(((int*) mxGetData(minidx_OUT)) + dataIdx, outInt, outElements * mxGetElementSize(minidx_OUT));
-
-				// Cleanup
-				mxFree(outInt); 
-
 				break;
 			}
 
@@ -7029,7 +6397,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				//		MIN			Vector of minimum values within the lookback period
 				//		MAX			Vector of maximum values within the lookback period
 
-
 				// Check number of inputs
 				if (nrhs < 2 || nrhs > 3)
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:ta_max:NumInputs",
@@ -7097,42 +6464,19 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 30;
 				}
 
-				// Preallocate heap
-				outMin = (double*)mxCalloc(rows, sizeof(double));
-				outMax = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				int taLookback = TA_MINMAX_Lookback(lookback);
+				outMin = taOutput(min_OUT, rows, taLookback);
+				outMax = taOutput(max_OUT, rows, taLookback);
 				retCode = TA_MINMAX(startIdx, endIdx, dataPtr, lookback, &dataIdx, &outElements, outMin, outMax);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outMin);
-					mxFree(outMax);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				max_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				min_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(min_OUT)) + dataIdx, outMin, outElements * mxGetElementSize(min_OUT));
-				memcpy(((double *) mxGetData(max_OUT)) + dataIdx, outMax, outElements * mxGetElementSize(max_OUT));
-
-				// Cleanup
-				mxFree(outMin); 
-				mxFree(outMax); 
-
-				// NaN those values less than the lookback period
-				double *minPtr = mxGetPr(min_OUT);
-				double *maxPtr = mxGetPr(max_OUT);
-				for (int iter = 0; iter < lookback - 1; iter++)
-				{
-					minPtr[iter] = m_Nan;
-					maxPtr[iter] = m_Nan;
-				}
-
-
 				break;
 				break;
 			}
@@ -7150,7 +6494,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				//		MINIDX		Vector of minimum values index locations within the lookback period
 				//		MAXIDX		Vector of maximum values index locations within the lookback period
 
-
 				// Check number of inputs
 				if (nrhs < 2 || nrhs > 3)
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:ta_max:NumInputs",
@@ -7218,32 +6561,19 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 30;
 				}
 
-				// Preallocate heap
-				outMinIdx = (int*)mxCalloc(rows, sizeof(int));
-				outMaxIdx = (int*)mxCalloc(rows, sizeof(int));
-
 				// Invoke with error catch
+				int taLookback = TA_MINMAXINDEX_Lookback(lookback);
+				outMinIdx = taOutputInt(minIdx_OUT, rows, taLookback);
+				outMaxIdx = taOutputInt(maxIdx_OUT, rows, taLookback);
 				retCode = TA_MINMAXINDEX(startIdx, endIdx, dataPtr, lookback, &dataIdx, &outElements, outMinIdx, outMaxIdx);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outMinIdx);
-					mxFree(outMaxIdx);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				maxIdx_OUT = mxCreateNumericMatrix(dataIdx + outElements,1, mxINT32_CLASS, mxREAL);
-				minIdx_OUT = mxCreateNumericMatrix(dataIdx + outElements,1, mxINT32_CLASS, mxREAL);
-				memcpy(((int *) mxGetData(minIdx_OUT)) + dataIdx, outMinIdx, outElements * mxGetElementSize(minIdx_OUT));
-				memcpy(((int *) mxGetData(maxIdx_OUT)) + dataIdx, outMaxIdx, outElements * mxGetElementSize(maxIdx_OUT));
-
-				// Cleanup
-				mxFree(outMinIdx); 
-				mxFree(outMaxIdx); 
-
 				break;
 			}
 
@@ -7264,7 +6594,7 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				//		ta_willr		WPR					Vector of Williams' %R values for the lookback period
 
 				// Strings for validation feedback
-				switch (s_mapStringValues[taFuncNameIn])
+				switch (taFunc)
 				{
 				case ta_minus_di:
 					taFuncDesc = "Minus Directional Indicator";
@@ -7329,7 +6659,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					// Assign
 					lookback = (int)mxGetScalar(lookback_IN);
 
-					
 				}
 				else
 				// Default lookback period
@@ -7338,7 +6667,7 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				}
 
 				// Validate
-				switch (s_mapStringValues[taFuncNameIn])
+				switch (taFunc)
 				{
 					case ta_minus_di:
 						if (lookback < 1)
@@ -7356,15 +6685,14 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 						break;
 				}
 				
-				// Preallocate heap
-				outReal	= (double*)mxCalloc(rows, sizeof(double));
-
-				switch (s_mapStringValues[taFuncNameIn])
+				switch (taFunc)
 				{
 				case ta_minus_di:
+					outReal = taOutput(data_OUT, rows, TA_MINUS_DI_Lookback(lookback));
 					retCode = TA_MINUS_DI(startIdx, endIdx, highPtr, lowPtr, closePtr, lookback, &dataIdx, &outElements, outReal);
 					break;
 				case ta_willr:
+					outReal = taOutput(data_OUT, rows, TA_WILLR_Lookback(lookback));
 					retCode = TA_WILLR(startIdx, endIdx, highPtr, lowPtr, closePtr, lookback, &dataIdx, &outElements, outReal);
 					break;
 				}
@@ -7372,27 +6700,10 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				data_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(data_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(data_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *dataPtr = mxGetPr(data_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					dataPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -7474,35 +6785,16 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 14;
 				}
 
-				// Preallocate heap
-				mDM	= (double*)mxCalloc(rows, sizeof(double));
-
+				mDM = taOutput(mDM_OUT, rows, TA_MINUS_DM_Lookback(lookback));
 				retCode = TA_MINUS_DM(startIdx, endIdx, highPtr, lowPtr, lookback, &dataIdx, &outElements, mDM);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(mDM);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				mDM_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(mDM_OUT)) + dataIdx, mDM, outElements * mxGetElementSize(mDM_OUT));
-
-				// Cleanup
-				mxFree(mDM); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *mDMPtr = mxGetPr(mDM_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					mDMPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 		
@@ -7585,35 +6877,16 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 14;
 				}
 
-				// Preallocate heap
-				MOM	= (double*)mxCalloc(rows, sizeof(double));
-
+				MOM = taOutput(MOM_OUT, rows, TA_MOM_Lookback(lookback));
 				retCode = TA_MOM(startIdx, endIdx, dataPtr, lookback, &dataIdx, &outElements, MOM);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(MOM);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				MOM_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(MOM_OUT)) + dataIdx, MOM, outElements * mxGetElementSize(MOM_OUT));
-
-				// Cleanup
-				mxFree(MOM); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *momPtr = mxGetPr(MOM_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					momPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 		
@@ -7677,26 +6950,16 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int dataIdx, outElements;
 				double *product;
 
-				// Preallocate heap
-				product = (double*)mxCalloc(rows, sizeof(double));
-
+				product = taOutput(product_OUT, rows, TA_MULT_Lookback());
 				retCode = TA_MULT(startIdx, endIdx, mCandPtr, mPlierPtr, &dataIdx, &outElements, product);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(product);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				product_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(product_OUT)) + dataIdx, product, outElements * mxGetElementSize(product_OUT));
-
-				// Cleanup
-				mxFree(product); 
-
 				break;
 			}
 
@@ -7782,35 +7045,16 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 14;
 				}
 
-				// Preallocate heap
-				outReal	= (double*)mxCalloc(rows, sizeof(double));
-
+				outReal = taOutput(natr_OUT, rows, TA_NATR_Lookback(lookback));
 				retCode = TA_NATR(startIdx, endIdx, highPtr, lowPtr, closePtr, lookback, &natrIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				natr_OUT = mxCreateDoubleMatrix(natrIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(natr_OUT)) + natrIdx, outReal, outElements * mxGetElementSize(natr_OUT));
-
-				// Cleanup
-				mxFree(outReal);
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(natr_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					outPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -7872,27 +7116,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int dataIdx, outElements;
 				double *outReal;
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));			// added cast
-
 				// Invoke with error catch
+				outReal = taOutput(obv_OUT, rows, TA_OBV_Lookback());
 				retCode = TA_OBV(startIdx, endIdx, dataPtr, volPtr, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				obv_OUT = mxCreateDoubleMatrix(dataIdx + outElements, 1, mxREAL);
-				memcpy(((double*) mxGetData(obv_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(obv_OUT));
-
-				// Cleanup
-				mxFree(outReal);  
-
 				break;
 			}
 		
@@ -7977,35 +7211,16 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 14;
 				}
 
-				// Preallocate heap
-				outReal	= (double*)mxCalloc(rows, sizeof(double));
-
+				outReal = taOutput(plus_OUT, rows, TA_PLUS_DI_Lookback(lookback));
 				retCode = TA_PLUS_DI(startIdx, endIdx, highPtr, lowPtr, closePtr, lookback, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				plus_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(plus_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(plus_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *plusPtr = mxGetPr(plus_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					plusPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -8087,35 +7302,16 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					lookback = 14;
 				}
 
-				// Preallocate heap
-				outReal	= (double*)mxCalloc(rows, sizeof(double));
-
+				outReal = taOutput(plus_OUT, rows, TA_PLUS_DM_Lookback(lookback));
 				retCode = TA_PLUS_DM(startIdx, endIdx, highPtr, lowPtr, lookback, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				plus_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(plus_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(plus_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *plusPtr = mxGetPr(plus_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					plusPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -8255,28 +7451,18 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 						"The optional inputs must be a scalar greater than or equal to 0. Aborting (%d).",codeLine);
 				}
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(vec_OUT, rows, TA_SAR_Lookback(opt1, opt2));
 				retCode = TA_SAR(startIdx, endIdx, highPtr, lowPtr, opt1, opt2, &vecIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:invokeErr",
 						"Invocation to '%s' failed.. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				vec_OUT = mxCreateDoubleMatrix(vecIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(vec_OUT)) + vecIdx, outReal, outElements * mxGetElementSize(vec_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
 				break;
 			}
 		
@@ -8567,27 +7753,17 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 						"Each optional input must be a scalar greater than or equal to 0. Aborting (%d).", codeLine);
 				}
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				outReal = taOutput(vec_OUT, rows, TA_SAREXT_Lookback(opt1, opt2, opt3, opt4, opt5, opt6, opt7, opt8));
 				retCode = TA_SAREXT(startIdx, endIdx, highPtr, lowPtr, opt1, opt2, opt3, opt4, opt5, opt6, opt7, opt8, &vecIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgTxt("Invocation to 'ta_adosc' failed. Aborting (577).");
 				}
 
-				// Populate Output
-				vec_OUT = mxCreateDoubleMatrix(vecIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(vec_OUT)) + vecIdx, outReal, outElements * mxGetElementSize(vec_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
 				break;
 			}
 
@@ -8605,7 +7781,7 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// OUTPUT
 				//		ta_stddev	STDDEV		vector of standard deviation values
 
-				switch (s_mapStringValues[taFuncNameIn])
+				switch (taFunc)
 				{
 					case ta_stddev:
 						taFuncDesc = "Standard Deviation";
@@ -8693,16 +7869,15 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:InputErr",
 					"Lookback period must be a scalar greater than or equal to 2. Aborting (%d).", codeLine);
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
-				switch (s_mapStringValues[taFuncNameIn])
+				switch (taFunc)
 				{
 					case ta_stddev:
+						outReal = taOutput(vec_OUT, rows, TA_STDDEV_Lookback(lookback, numDev));
 						retCode = TA_STDDEV(startIdx, endIdx, dataPtr, lookback, numDev, &dataIdx, &outElements, outReal);
 						break;
 					case ta_var:
+						outReal = taOutput(vec_OUT, rows, TA_VAR_Lookback(lookback, numDev));
 						retCode = TA_VAR(startIdx, endIdx, dataPtr, lookback, numDev, &dataIdx, &outElements, outReal);
 						break;
 				}
@@ -8710,27 +7885,10 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				vec_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(vec_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(vec_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *vecPtr = mxGetPr(vec_OUT);
-
-				for (int iter = 0; iter < lookback; iter++)
-				{
-					vecPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -8947,43 +8105,19 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 						"Period based optional inputs must be a scalar greater than or equal to 1. Aborting (%d).", codeLine);
 				}
 
-				// Preallocate heap
-				outDReal = (double*)mxCalloc(rows, sizeof(double));
-				outKReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				int taLookback = TA_STOCH_Lookback(opt1, opt2, (TA_MAType)opt3, opt4, (TA_MAType)opt5);
+				outKReal = taOutput(slowK_OUT, rows, taLookback);
+				outDReal = taOutput(slowD_OUT, rows, taLookback);
 				retCode = TA_STOCH(startIdx, endIdx, highPtr, lowPtr, closePtr, opt1, opt2, (TA_MAType)opt3, opt4, (TA_MAType)opt5, &vecIdx, &outElements, outKReal, outDReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outKReal);
-					mxFree(outDReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				slowK_OUT = mxCreateDoubleMatrix(vecIdx + outElements,1, mxREAL);
-				slowD_OUT = mxCreateDoubleMatrix(vecIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(slowK_OUT)) + vecIdx, outKReal, outElements * mxGetElementSize(slowK_OUT));
-				memcpy(((double *) mxGetData(slowD_OUT)) + vecIdx, outDReal, outElements * mxGetElementSize(slowD_OUT));
-
-				// Cleanup
-				mxFree(outKReal);
-				mxFree(outDReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *kPtr = mxGetPr(slowK_OUT);
-				double *dPtr = mxGetPr(slowD_OUT);
-
-				for (int iter = 0; iter < opt1 + max(opt2, opt4); iter++)
-				{
-					kPtr[iter] = m_Nan;
-					dPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -9007,7 +8141,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				//							7	-	MESA Adaptive Moving Average		MAMA
 				//							8	-	Triple Exponential Moving Average	T3	
 
-
 				// OUTPUT
 				//		SLOWK
 				//		SLOWD
@@ -9156,43 +8289,19 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 						"Period based optional inputs must be a scalar greater than or equal to 1. Aborting (%d).", codeLine);
 				}
 
-				// Preallocate heap
-				outDReal = (double*)mxCalloc(rows, sizeof(double));
-				outKReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				int taLookback = TA_STOCHF_Lookback(opt1, opt2, (TA_MAType)opt3);
+				outKReal = taOutput(slowK_OUT, rows, taLookback);
+				outDReal = taOutput(slowD_OUT, rows, taLookback);
 				retCode = TA_STOCHF(startIdx, endIdx, highPtr, lowPtr, closePtr, opt1, opt2, (TA_MAType)opt3, &vecIdx, &outElements, outKReal, outDReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outKReal);
-					mxFree(outDReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				slowK_OUT = mxCreateDoubleMatrix(vecIdx + outElements,1, mxREAL);
-				slowD_OUT = mxCreateDoubleMatrix(vecIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(slowK_OUT)) + vecIdx, outKReal, outElements * mxGetElementSize(slowK_OUT));
-				memcpy(((double *) mxGetData(slowD_OUT)) + vecIdx, outDReal, outElements * mxGetElementSize(slowD_OUT));
-
-				// Cleanup
-				mxFree(outKReal);
-				mxFree(outDReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *kPtr = mxGetPr(slowK_OUT);
-				double *dPtr = mxGetPr(slowD_OUT);
-
-				for (int iter = 0; iter < opt1 + opt2; iter++)
-				{
-					kPtr[iter] = m_Nan;
-					dPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -9380,43 +8489,19 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 						"Period based optional inputs must be a scalar greater than or equal to 1. Aborting (%d).", codeLine);
 				}
 
-				// Preallocate heap
-				outDReal = (double*)mxCalloc(rows, sizeof(double));
-				outKReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
+				int taLookback = TA_STOCHRSI_Lookback(opt1, opt2, opt3, (TA_MAType)opt4);
+				outKReal = taOutput(slowK_OUT, rows, taLookback);
+				outDReal = taOutput(slowD_OUT, rows, taLookback);
 				retCode = TA_STOCHRSI(startIdx, endIdx, dataPtr, opt1, opt2, opt3, (TA_MAType)opt4, &vecIdx, &outElements, outKReal, outDReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outKReal);
-					mxFree(outDReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				slowK_OUT = mxCreateDoubleMatrix(vecIdx + outElements,1, mxREAL);
-				slowD_OUT = mxCreateDoubleMatrix(vecIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(slowK_OUT)) + vecIdx, outKReal, outElements * mxGetElementSize(slowK_OUT));
-				memcpy(((double *) mxGetData(slowD_OUT)) + vecIdx, outDReal, outElements * mxGetElementSize(slowD_OUT));
-
-				// Cleanup
-				mxFree(outKReal);
-				mxFree(outDReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *kPtr = mxGetPr(slowK_OUT);
-				double *dPtr = mxGetPr(slowD_OUT);
-
-				for (int iter = 0; iter < max(opt1, opt2 + opt3); iter++)
-				{
-					kPtr[iter] = m_Nan;
-					dPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -9426,7 +8511,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				//	REQUIRED INPUTS
 				//		ta_t3		data		single column vector observational values
 
-
 				// OPTIONAL INPUTS
 				//		ta_t3		Lookback	Default 5
 				//					inVfactor	Default 0.70
@@ -9434,7 +8518,6 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// OUTPUTS
 				//		ta_t3		T3			Vector of Triple Exponential Moving Average values
 
-
 				// Check number of inputs
 				if (nrhs < 2 || nrhs > 4)
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:NumInputs",
@@ -9518,13 +8601,11 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 						"The '%s' inVfactor must be an integer between 0 =< x >= 1. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Preallocate heap
-				outReal = (double*)mxCalloc(rows, sizeof(double));
-
 				// Invoke with error catch
-				switch (s_mapStringValues[taFuncNameIn])
+				switch (taFunc)
 				{
 				case ta_t3:
+					outReal = taOutput(vec_OUT, rows, TA_T3_Lookback(lookback, inVfactor));
 					retCode = TA_T3(startIdx, endIdx, vecPtr, lookback, inVfactor, &vecIdx, &outElements, outReal);
 					break;
 				}
@@ -9532,28 +8613,11 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:invokeErr",
 						"Invocation to '%s' failed.. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				vec_OUT = mxCreateDoubleMatrix(vecIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(vec_OUT)) + vecIdx, outReal, outElements * mxGetElementSize(vec_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(vec_OUT);
-
-				for (int iter = 0; iter < (lookback - 1) * 6; iter++)
-				{
-					outPtr[iter] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -9573,7 +8637,7 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				//		ta_typprice	TYPPRICE	A single vector of Typical Price values
 
 				// Strings for validation feedback
-				switch (s_mapStringValues[taFuncNameIn])
+				switch (taFunc)
 				{
 					case ta_trange:
 						taFuncDesc = "True Range";
@@ -9627,15 +8691,14 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int dataIdx, outElements;
 				double *outReal;
 
-				// Preallocate heap
-				outReal	= (double*)mxCalloc(rows, sizeof(double));
-
-				switch (s_mapStringValues[taFuncNameIn])
+				switch (taFunc)
 				{
 					case ta_trange:
+						outReal = taOutput(vec_OUT, rows, TA_TRANGE_Lookback());
 						retCode = TA_TRANGE(startIdx, endIdx, highPtr, lowPtr, closePtr, &dataIdx, &outElements, outReal);
 						break;
 					case ta_typprice:
+						outReal = taOutput(vec_OUT, rows, TA_TYPPRICE_Lookback());
 						retCode = TA_TYPPRICE(startIdx, endIdx, highPtr, lowPtr, closePtr, &dataIdx, &outElements, outReal);
 						break;
 				}
@@ -9643,25 +8706,10 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				vec_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(vec_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(vec_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
-				if (taFuncNameIn.compare("ta_trange") == 0)
-				{
-					// NaN first entry
-					double *outPtr = mxGetPr(vec_OUT);
-					outPtr[0] = m_Nan;
-				}
-
 				break;
 			}
 
@@ -9680,7 +8728,7 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				//		ta_ultosc	ULTOSC		A single vector of Ultimate Oscillator values
 				// Strings for validation feedback
 				
-				switch (s_mapStringValues[taFuncNameIn])
+				switch (taFunc)
 				{
 				case ta_ultosc:
 					taFuncDesc = "Ultimate Oscillator ";
@@ -9798,51 +8846,27 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:inputErr",
 						"Lookback periods must be of a value greater than or equal to 1. Aborting (%d).", rows, codeLine);
 				}
-				// Preallocate heap
-				outReal	= (double*)mxCalloc(rows, sizeof(double));
 
 				// Invoke with error catch
-				switch (s_mapStringValues[taFuncNameIn])
+				switch (taFunc)
 				{
 				case ta_ultosc:
+					outReal = taOutput(data_OUT, rows, TA_ULTOSC_Lookback(lookback1, lookback2, lookback3));
 					retCode = TA_ULTOSC(startIdx, endIdx, highPtr, lowPtr, closePtr, lookback1, lookback2, lookback3, &dataIdx, &outElements, outReal);
 					break;
 				}
 
-
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt( "MATLAB:taInvoke:invokeErr",
 						"Invocation to '%s' failed.. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				data_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(data_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(data_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
-				// NaN data before lookback
-				// assign the variables for manipulating the arrays (by pointer reference)
-				double *outPtr = mxGetPr(data_OUT);
-
-				int lookback = max(lookback1, max(lookback2, lookback3));
-				
-				if (lookback > 1)
-				{
-					for (int iter = 0; iter < lookback; iter++)
-					{
-						outPtr[iter] = m_Nan;
-					}
-				}
 				break;
 			}
 
-		
 		// Weighted Close Price
 		case ta_wclprice:       
 			{
@@ -9902,26 +8926,16 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 				int dataIdx, outElements;
 				double *outReal;
 
-				// Preallocate heap
-				outReal	= (double*)mxCalloc(rows, sizeof(double));
-
+				outReal = taOutput(data_OUT, rows, TA_WCLPRICE_Lookback());
 				retCode = TA_WCLPRICE(startIdx, endIdx, highPtr, lowPtr, closePtr, &dataIdx, &outElements, outReal);
 
 				// Error handling
 				if (retCode) 
 				{
-					mxFree(outReal);
 					mexPrintf("%s%i","Return code=",retCode);
 					mexErrMsgIdAndTxt("MATLAB:taInvoke","Invocation to '%s' failed. Aborting (%d).", taFuncNameIn, codeLine);
 				}
 
-				// Populate Output
-				data_OUT = mxCreateDoubleMatrix(dataIdx + outElements,1, mxREAL);
-				memcpy(((double *) mxGetData(data_OUT)) + dataIdx, outReal, outElements * mxGetElementSize(data_OUT));
-
-				// Cleanup
-				mxFree(outReal); 
-
 				break;
 			}
 
@@ -9935,6 +8949,558 @@ void mexFunction(int nlhs, mxArray *plhs[],	/* Output variables */
 	return;
 }
 
+// Options
+// The options of every function that takes any, in the order they follow the data, with the range TA-Lib
+// accepts (or the narrower one the call by name checks).  Periods and MA types must be integers.
+// prepare checks every option against them and a batch checks its periods.
+typedef enum { taOptPeriod, taOptMAType, taOptReal } taOptKind;
+
+typedef struct
+{
+	taOptKind kind;
+	double min, max;
+} taOptSpec;
+
+#define TA_MAX_OPTS		8
+#define OPT_PERIOD(MIN)		{ taOptPeriod, MIN, 100000 }
+#define OPT_MATYPE		{ taOptMAType, 0, 8 }
+#define OPT_REAL(MIN, MAX)	{ taOptReal, MIN, MAX }
+
+static const struct
+{
+	StringValue func;
+	int numOpts;
+	taOptSpec opts[TA_MAX_OPTS];
+} s_taOptions[] =
+{
+	{ ta_accbands,			1, { OPT_PERIOD(2) } },
+	{ ta_adosc,			2, { OPT_PERIOD(2), OPT_PERIOD(2) } },
+	{ ta_adx,			1, { OPT_PERIOD(2) } },
+	{ ta_adxr,			1, { OPT_PERIOD(2) } },
+	{ ta_apo,			3, { OPT_PERIOD(2), OPT_PERIOD(2), OPT_MATYPE } },
+	{ ta_aroon,			1, { OPT_PERIOD(2) } },
+	{ ta_aroonosc,			1, { OPT_PERIOD(2) } },
+	{ ta_atr,			1, { OPT_PERIOD(1) } },
+	{ ta_avgdev,			1, { OPT_PERIOD(2) } },
+	{ ta_bbands,			4, { OPT_PERIOD(2), OPT_REAL(TA_REAL_MIN, TA_REAL_MAX), OPT_REAL(TA_REAL_MIN, TA_REAL_MAX), OPT_MATYPE } },
+	{ ta_beta,			1, { OPT_PERIOD(1) } },
+	{ ta_cci,			1, { OPT_PERIOD(2) } },
+	{ ta_cdlabandonedbaby,		1, { OPT_REAL(0, 1) } },
+	{ ta_cdldarkcloudcover,		1, { OPT_REAL(0, 1) } },
+	{ ta_cdleveningdojistar,	1, { OPT_REAL(0, 1) } },
+	{ ta_cdleveningstar,		1, { OPT_REAL(0, 1) } },
+	{ ta_cdlmathold,		1, { OPT_REAL(0, 1) } },
+	{ ta_cdlmorningdojistar,	1, { OPT_REAL(0, 1) } },
+	{ ta_cdlmorningstar,		1, { OPT_REAL(0, 1) } },
+	{ ta_cmo,			1, { OPT_PERIOD(2) } },
+	{ ta_correl,			1, { OPT_PERIOD(1) } },
+	{ ta_dema,			1, { OPT_PERIOD(2) } },
+	{ ta_dx,			1, { OPT_PERIOD(2) } },
+	{ ta_ema,			1, { OPT_PERIOD(2) } },
+	{ ta_kama,			1, { OPT_PERIOD(2) } },
+	{ ta_linearreg,			1, { OPT_PERIOD(2) } },
+	{ ta_linearreg_angle,		1, { OPT_PERIOD(2) } },
+	{ ta_linearreg_intercept,	1, { OPT_PERIOD(2) } },
+	{ ta_linearreg_slope,		1, { OPT_PERIOD(2) } },
+	{ ta_ma,			2, { OPT_PERIOD(1), OPT_MATYPE } },
+	{ ta_macd,			3, { OPT_PERIOD(2), OPT_PERIOD(2), OPT_PERIOD(1) } },
+	{ ta_macdext,			6, { OPT_PERIOD(2), OPT_MATYPE, OPT_PERIOD(2), OPT_MATYPE, OPT_PERIOD(1), OPT_MATYPE } },
+	{ ta_macdfix,			1, { OPT_PERIOD(1) } },
+	{ ta_mama,			2, { OPT_REAL(0.01, 0.99), OPT_REAL(0.01, 0.99) } },
+	{ ta_mavp,			3, { OPT_PERIOD(2), OPT_PERIOD(2), OPT_MATYPE } },
+	{ ta_max,			1, { OPT_PERIOD(2) } },
+	{ ta_maxindex,			1, { OPT_PERIOD(2) } },
+	{ ta_mfi,			1, { OPT_PERIOD(2) } },
+	{ ta_midpoint,			1, { OPT_PERIOD(2) } },
+	{ ta_midprice,			1, { OPT_PERIOD(2) } },
+	{ ta_min,			1, { OPT_PERIOD(2) } },
+	{ ta_minindex,			1, { OPT_PERIOD(2) } },
+	{ ta_minmax,			1, { OPT_PERIOD(2) } },
+	{ ta_minmaxindex,		1, { OPT_PERIOD(2) } },
+	{ ta_minus_di,			1, { OPT_PERIOD(1) } },
+	{ ta_minus_dm,			1, { OPT_PERIOD(1) } },
+	{ ta_mom,			1, { OPT_PERIOD(1) } },
+	{ ta_natr,			1, { OPT_PERIOD(1) } },
+	{ ta_plus_di,			1, { OPT_PERIOD(1) } },
+	{ ta_plus_dm,			1, { OPT_PERIOD(1) } },
+	{ ta_ppo,			3, { OPT_PERIOD(2), OPT_PERIOD(2), OPT_MATYPE } },
+	{ ta_roc,			1, { OPT_PERIOD(1) } },
+	{ ta_rocp,			1, { OPT_PERIOD(1) } },
+	{ ta_rocr,			1, { OPT_PERIOD(1) } },
+	{ ta_rocr100,			1, { OPT_PERIOD(1) } },
+	{ ta_rsi,			1, { OPT_PERIOD(2) } },
+	{ ta_sar,			2, { OPT_REAL(0, TA_REAL_MAX), OPT_REAL(0, TA_REAL_MAX) } },
+	{ ta_sarext,			8, { OPT_REAL(TA_REAL_MIN, TA_REAL_MAX), OPT_REAL(0, TA_REAL_MAX), OPT_REAL(0, TA_REAL_MAX),
+						OPT_REAL(0, TA_REAL_MAX), OPT_REAL(0, TA_REAL_MAX), OPT_REAL(0, TA_REAL_MAX),
+						OPT_REAL(0, TA_REAL_MAX), OPT_REAL(0, TA_REAL_MAX) } },
+	{ ta_sma,			1, { OPT_PERIOD(2) } },
+	{ ta_stddev,			2, { OPT_PERIOD(2), OPT_REAL(TA_REAL_MIN, TA_REAL_MAX) } },
+	{ ta_stoch,			5, { OPT_PERIOD(1), OPT_PERIOD(1), OPT_MATYPE, OPT_PERIOD(1), OPT_MATYPE } },
+	{ ta_stochf,			3, { OPT_PERIOD(1), OPT_PERIOD(1), OPT_MATYPE } },
+	{ ta_stochrsi,			4, { OPT_PERIOD(2), OPT_PERIOD(1), OPT_PERIOD(1), OPT_MATYPE } },
+	{ ta_sum,			1, { OPT_PERIOD(2) } },
+	{ ta_t3,			2, { OPT_PERIOD(2), OPT_REAL(0, 1) } },
+	{ ta_tema,			1, { OPT_PERIOD(2) } },
+	{ ta_trima,			1, { OPT_PERIOD(2) } },
+	{ ta_trix,			1, { OPT_PERIOD(1) } },
+	{ ta_tsf,			1, { OPT_PERIOD(2) } },
+	{ ta_ultosc,			3, { OPT_PERIOD(1), OPT_PERIOD(1), OPT_PERIOD(1) } },
+	{ ta_var,			2, { OPT_PERIOD(1), OPT_REAL(TA_REAL_MIN, TA_REAL_MAX) } },
+	{ ta_willr,			1, { OPT_PERIOD(2) } },
+	{ ta_wma,			1, { OPT_PERIOD(2) } }
+};
+
+// The row of s_taOptions for 'taFunc' or -1 when it takes no options
+static int taOptionsOf(StringValue taFunc)
+{
+	const int numSpecs = (int)(sizeof(s_taOptions) / sizeof(s_taOptions[0]));
+	for (int ss = 0; ss < numSpecs; ss++)
+	{
+		if (s_taOptions[ss].func == taFunc)
+			return ss;
+	}
+	return -1;
+}
+
+static const char *s_taOptKindNames[] = { "period", "MA type", "value" };
+
+// Check element 'kk' of option 'ii' (1 based) of 'taFuncNameIn' against 'spec' and return it
+static double taCheckOption(const string &taFuncNameIn, const taOptSpec &spec, int ii, const mxArray *opt, size_t kk)
+{
+	const double value = mxGetPr(opt)[kk];
+
+	if (spec.kind != taOptReal && fraction(value))
+		mexErrMsgIdAndTxt("MATLAB:taInvoke:BadOption",
+			"Option %d of '%s' is a %s and must be an integer. Aborting (%d).",
+			ii, taFuncNameIn.c_str(), s_taOptKindNames[spec.kind], codeLine);
+	if (!(value >= spec.min && value <= spec.max))
+		mexErrMsgIdAndTxt("MATLAB:taInvoke:BadOption",
+			"Option %d of '%s' (%s) must be from %g to %g. Aborting (%d).",
+			ii, taFuncNameIn.c_str(), s_taOptKindNames[spec.kind], spec.min, spec.max, codeLine);
+
+	return value;
+}
+
+// Period Batches
+// Functions whose only option is the period that follows their data.  Given N x M data (M instruments)
+// and | or a vector of K periods the output holds one column per instrument and period, as if each had
+// been called alone:  N x M (one period), N x K (one instrument) or N x K x M.
+// SMA | SUM | VAR | STDDEV | ATR | NATR run in btTaBatch, ATR | NATR sharing one true range per
+// instrument.  The other functions call TA-Lib once per column.  Every column is written in place by
+// one worker.
+typedef TA_RetCode (*taPeriodFn1)(int, int, const double[], int, int *, int *, double[]);
+typedef TA_RetCode (*taPeriodFn2)(int, int, const double[], const double[], int, int *, int *, double[]);
+typedef TA_RetCode (*taPeriodFn3)(int, int, const double[], const double[], const double[], int, int *, int *, double[]);
+
+static const struct
+{
+	StringValue func;
+	int numData;				// Data inputs before the period
+	taPeriodFn1 fn1;
+	taPeriodFn2 fn2;
+	taPeriodFn3 fn3;
+	int (*lookback)(int);
+	int defPeriod;				// Period when none is given
+} s_taPeriodFunctions[] =
+{
+	{ ta_avgdev,			1, TA_AVGDEV,			NULL,		NULL,		TA_AVGDEV_Lookback,	14 },
+	{ ta_cmo,			1, TA_CMO,			NULL,		NULL,		TA_CMO_Lookback,	14 },
+	{ ta_dema,			1, TA_DEMA,			NULL,		NULL,		TA_DEMA_Lookback,	30 },
+	{ ta_ema,			1, TA_EMA,			NULL,		NULL,		TA_EMA_Lookback,	30 },
+	{ ta_kama,			1, TA_KAMA,			NULL,		NULL,		TA_KAMA_Lookback,	30 },
+	{ ta_linearreg,			1, TA_LINEARREG,		NULL,		NULL,		TA_LINEARREG_Lookback,	14 },
+	{ ta_linearreg_angle,		1, TA_LINEARREG_ANGLE,		NULL,		NULL,		TA_LINEARREG_ANGLE_Lookback,	14 },
+	{ ta_linearreg_intercept,	1, TA_LINEARREG_INTERCEPT,	NULL,		NULL,		TA_LINEARREG_INTERCEPT_Lookback,	14 },
+	{ ta_linearreg_slope,		1, TA_LINEARREG_SLOPE,		NULL,		NULL,		TA_LINEARREG_SLOPE_Lookback,	14 },
+	{ ta_max,			1, TA_MAX,			NULL,		NULL,		TA_MAX_Lookback,	30 },
+	{ ta_midpoint,			1, TA_MIDPOINT,			NULL,		NULL,		TA_MIDPOINT_Lookback,	14 },
+	{ ta_min,			1, TA_MIN,			NULL,		NULL,		TA_MIN_Lookback,	30 },
+	{ ta_mom,			1, TA_MOM,			NULL,		NULL,		TA_MOM_Lookback,	14 },
+	{ ta_roc,			1, TA_ROC,			NULL,		NULL,		TA_ROC_Lookback,	10 },
+	{ ta_rocp,			1, TA_ROCP,			NULL,		NULL,		TA_ROCP_Lookback,	10 },
+	{ ta_rocr,			1, TA_ROCR,			NULL,		NULL,		TA_ROCR_Lookback,	10 },
+	{ ta_rocr100,			1, TA_ROCR100,			NULL,		NULL,		TA_ROCR100_Lookback,	10 },
+	{ ta_rsi,			1, TA_RSI,			NULL,		NULL,		TA_RSI_Lookback,	14 },
+	{ ta_sma,			1, TA_SMA,			NULL,		NULL,		TA_SMA_Lookback,	30 },
+	{ ta_sum,			1, TA_SUM,			NULL,		NULL,		TA_SUM_Lookback,	30 },
+	{ ta_tema,			1, TA_TEMA,			NULL,		NULL,		TA_TEMA_Lookback,	30 },
+	{ ta_trima,			1, TA_TRIMA,			NULL,		NULL,		TA_TRIMA_Lookback,	30 },
+	{ ta_trix,			1, TA_TRIX,			NULL,		NULL,		TA_TRIX_Lookback,	30 },
+	{ ta_tsf,			1, TA_TSF,			NULL,		NULL,		TA_TSF_Lookback,	14 },
+	{ ta_wma,			1, TA_WMA,			NULL,		NULL,		TA_WMA_Lookback,	30 },
+	{ ta_stddev,			1, NULL,			NULL,		NULL,		NULL,	5 },		// btTaBatch only (numDev option)
+	{ ta_var,			1, NULL,			NULL,		NULL,		NULL,	5 },
+	{ ta_aroonosc,			2, NULL,	TA_AROONOSC,		NULL,		TA_AROONOSC_Lookback,	14 },
+	{ ta_beta,			2, NULL,	TA_BETA,		NULL,		TA_BETA_Lookback,	5 },
+	{ ta_correl,			2, NULL,	TA_CORREL,		NULL,		TA_CORREL_Lookback,	30 },
+	{ ta_midprice,			2, NULL,	TA_MIDPRICE,		NULL,		TA_MIDPRICE_Lookback,	14 },
+	{ ta_minus_dm,			2, NULL,	TA_MINUS_DM,		NULL,		TA_MINUS_DM_Lookback,	14 },
+	{ ta_plus_dm,			2, NULL,	TA_PLUS_DM,		NULL,		TA_PLUS_DM_Lookback,	14 },
+	{ ta_adx,			3, NULL,	NULL,		TA_ADX,			TA_ADX_Lookback,	14 },
+	{ ta_adxr,			3, NULL,	NULL,		TA_ADXR,		TA_ADXR_Lookback,	14 },
+	{ ta_atr,			3, NULL,	NULL,		TA_ATR,			TA_ATR_Lookback,	14 },
+	{ ta_cci,			3, NULL,	NULL,		TA_CCI,			TA_CCI_Lookback,	14 },
+	{ ta_dx,			3, NULL,	NULL,		TA_DX,			TA_DX_Lookback,	14 },
+	{ ta_minus_di,			3, NULL,	NULL,		TA_MINUS_DI,		TA_MINUS_DI_Lookback,	14 },
+	{ ta_natr,			3, NULL,	NULL,		TA_NATR,		TA_NATR_Lookback,	14 },
+	{ ta_plus_di,			3, NULL,	NULL,		TA_PLUS_DI,		TA_PLUS_DI_Lookback,	14 },
+	{ ta_willr,			3, NULL,	NULL,		TA_WILLR,		TA_WILLR_Lookback,	14 }
+};
+
+// The row of s_taPeriodFunctions for 'taFunc' or -1
+static int taPeriodFunction(StringValue taFunc)
+{
+	const int numFuncs = (int)(sizeof(s_taPeriodFunctions) / sizeof(s_taPeriodFunctions[0]));
+	for (int ff = 0; ff < numFuncs; ff++)
+	{
+		if (s_taPeriodFunctions[ff].func == taFunc)
+			return ff;
+	}
+	return -1;
+}
+
+// false when prhs is not a batch (a single column and period) and taDispatch should handle it
+static bool taBatch(StringValue taFunc, const string &taFuncNameIn, int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+	const int ff = taPeriodFunction(taFunc);
+	if (ff < 0)
+		return false;
+
+	const int numData = s_taPeriodFunctions[ff].numData;
+	if (nrhs < numData + 1)
+		return false;
+
+	const bool withPeriods = nrhs > numData + 1;
+	if (mxGetN(prhs[1]) < 2 && (!withPeriods || mxGetNumberOfElements(prhs[numData + 1]) < 2))
+		return false;
+
+	const bool withDev = (taFunc == ta_stddev || taFunc == ta_var);
+	if (nrhs > numData + (withDev ? 3 : 2))
+		mexErrMsgIdAndTxt("MATLAB:taInvoke:batch:NumInputs",
+			"Only the data and the periods%s can be given to '%s' for a batch. Aborting (%d).",
+			withDev ? " (and numDev)" : "", taFuncNameIn.c_str(), codeLine);
+	if (nlhs > 1)
+		mexErrMsgIdAndTxt("MATLAB:taInvoke:batch:NumOutputs",
+			"'%s' produces a single output for a batch. Aborting (%d).", taFuncNameIn.c_str(), codeLine);
+
+	// Periods
+	vector<int> periods(1, s_taPeriodFunctions[ff].defPeriod);
+	if (withPeriods)
+	{
+		const mxArray *periodsIn = prhs[numData + 1];
+		if (!isRealVector(periodsIn))
+			mexErrMsgIdAndTxt("MATLAB:taInvoke:batch:BadPeriod",
+				"The periods of '%s' must be a real double scalar or vector. Aborting (%d).", taFuncNameIn.c_str(), codeLine);
+
+		// Checked as prepare checks them.  A fraction or NaN would otherwise reach TA-Lib truncated.
+		const taOptSpec &spec = s_taOptions[taOptionsOf(taFunc)].opts[0];
+		periods.resize(mxGetNumberOfElements(periodsIn));
+		for (size_t kk = 0; kk < periods.size(); kk++)
+			periods[kk] = (int)taCheckOption(taFuncNameIn, spec, 1, periodsIn, kk);
+	}
+
+	double numDev = 1;
+	if (withDev && nrhs == numData + 3)
+	{
+		if (!isRealScalar(prhs[numData + 2]))
+			mexErrMsgIdAndTxt("MATLAB:taInvoke:inputErr",
+				"The numDev of '%s' must be a scalar. Aborting (%d).", taFuncNameIn.c_str(), codeLine);
+		numDev = mxGetScalar(prhs[numData + 2]);
+	}
+
+	taBatchRun(ff, taFuncNameIn, plhs, prhs + 1, periods, numDev);
+	return true;
+}
+
+// Run function 'ff' of s_taPeriodFunctions on the data inputs 'dataIn' for every period
+static void taBatchRun(size_t ff, const string &taFuncNameIn, mxArray *plhs[], const mxArray *dataIn[], const vector<int> &periods,
+	double numDev)
+{
+	const StringValue taFunc = s_taPeriodFunctions[ff].func;
+	const int numData = s_taPeriodFunctions[ff].numData;
+
+	// Data	N x M matrices of equal size
+	const double *data[3];
+	const int rows = (int)mxGetM(dataIn[0]);
+	const size_t series = mxGetN(dataIn[0]);
+	for (int ii = 0; ii < numData; ii++)
+	{
+		if (!isReal2DfullDouble(dataIn[ii]) || (int)mxGetM(dataIn[ii]) != rows || mxGetN(dataIn[ii]) != series)
+			mexErrMsgIdAndTxt("MATLAB:taInvoke:batch:BadInput",
+				"The data inputs of '%s' must be real double matrices of the same size. Aborting (%d).",
+				taFuncNameIn.c_str(), codeLine);
+		data[ii] = mxGetPr(dataIn[ii]);
+	}
+
+	const size_t cols = periods.size();
+	bool coreRange = true;					// btTaBatch takes periods of 2 or more
+	for (size_t kk = 0; kk < cols; kk++)
+		coreRange = coreRange && periods[kk] >= 2 && periods[kk] <= 100000;
+
+	// Instrument 'mm' owns the contiguous N x K block at mm * rows * cols
+	if (series == 1 || cols == 1)
+		plhs[0] = mxCreateDoubleMatrix(rows, series * cols, mxREAL);
+	else
+	{
+		mwSize dims[3] = { (mwSize)rows, (mwSize)cols, (mwSize)series };
+		plhs[0] = mxCreateNumericArray(3, dims, mxDOUBLE_CLASS, mxREAL);
+	}
+	double *outPtr = mxGetPr(plhs[0]);
+
+	// Shared work.  Instruments run in parallel and, for a single instrument, its periods.
+	bool shared = (taFunc == ta_stddev || taFunc == ta_var) ||
+		(coreRange && (taFunc == ta_sma || taFunc == ta_sum || taFunc == ta_atr || taFunc == ta_natr));
+	// One TA-Lib call per column otherwise.  Errors are collected and raised on the MatLab thread.
+	vector<int> retCodes;
+	string errId, errMsg;
+	try
+	{
+		if (shared)
+		{
+			const unsigned threads = series > 1 ? 1 : 0;
+
+			openAlgo::parallelFor(series, 0, [&](size_t mm)
+			{
+				openAlgo::span<const double> price(data[0] + mm * rows, rows);
+				openAlgo::span<double> out(outPtr + mm * rows * cols, rows * cols);
+
+				switch (taFunc)
+				{
+					case ta_sma:
+					case ta_sum:
+						openAlgo::sumBatch(price, periods, taFunc == ta_sma, out, threads);
+						break;
+					case ta_stddev:
+					case ta_var:
+						openAlgo::varBatch(price, periods, taFunc == ta_stddev, numDev, out, threads);
+						break;
+					default:
+						openAlgo::atrBatch(price, openAlgo::span<const double>(data[1] + mm * rows, rows),
+							openAlgo::span<const double>(data[2] + mm * rows, rows), periods, taFunc == ta_natr, out, threads);
+						break;
+				}
+			});
+		}
+		else
+		{
+			retCodes.assign(series * cols, TA_SUCCESS);
+			openAlgo::parallelFor(series * cols, 0, [&](size_t col)
+			{
+				const size_t mm = col / cols, kk = col % cols;
+				const double *in1 = data[0] + mm * rows;
+				const double *in2 = numData > 1 ? data[1] + mm * rows : NULL;
+				const double *in3 = numData > 2 ? data[2] + mm * rows : NULL;
+				double *colOut = outPtr + col * rows;
+				int nanRows = min(max(s_taPeriodFunctions[ff].lookback(periods[kk]), 0), rows);
+				int outBeg, outElements;
+
+				fill_n(colOut, nanRows, m_Nan);
+				if (rows == 0)
+					return;
+
+				switch (numData)
+				{
+					case 1:
+						retCodes[col] = s_taPeriodFunctions[ff].fn1(0, rows - 1, in1, periods[kk], &outBeg, &outElements, colOut + nanRows);
+						break;
+					case 2:
+						retCodes[col] = s_taPeriodFunctions[ff].fn2(0, rows - 1, in1, in2, periods[kk], &outBeg, &outElements, colOut + nanRows);
+						break;
+					default:
+						retCodes[col] = s_taPeriodFunctions[ff].fn3(0, rows - 1, in1, in2, in3, periods[kk], &outBeg, &outElements, colOut + nanRows);
+						break;
+				}
+			});
+		}
+	}
+	catch (const openAlgo::btError &err)
+	{
+		errId = err.id();
+		errMsg = err.what();
+	}
+	catch (const std::exception &err)
+	{
+		errId = "MATLAB:taInvoke:Internal";
+		errMsg = err.what();
+	}
+	if (!errId.empty())
+		mexErrMsgIdAndTxt(errId.c_str(), "%s", errMsg.c_str());
+
+	for (size_t col = 0; col < retCodes.size(); col++)
+	{
+		if (retCodes[col] != TA_SUCCESS)
+			mexErrMsgIdAndTxt("MATLAB:taInvoke", "Invocation to '%s' failed for column %d, period %d (return code %d). Aborting (%d).",
+				taFuncNameIn.c_str(), (int)(col / cols) + 1, periods[col % cols], retCodes[col], codeLine);
+	}
+}
+
+// Prepared Calls
+static void taReleasePlan(taPlan *plan)
+{
+	for (size_t ii = 0; ii < plan->opts.size(); ii++)
+		mxDestroyArray(plan->opts[ii]);
+	delete plan;
+}
+
+static void taReleasePlans()
+{
+	for (size_t ii = 0; ii < s_taPlans.size(); ii++)
+	{
+		if (s_taPlans[ii] != NULL)
+			taReleasePlan(s_taPlans[ii]);
+	}
+	s_taPlans.clear();
+}
+
+// h = taInvoke('prepare', taFunction, options)
+static void taPrepare(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+	if (nrhs < 2 || !mxIsChar(prhs[1]))
+		mexErrMsgIdAndTxt("MATLAB:taInvoke:prepare:NumInputs",
+			"taInvoke('prepare', taFunction, options) requires the name of a TA-Lib function. Aborting (%d).", codeLine);
+	if (nlhs > 1)
+		mexErrMsgIdAndTxt("MATLAB:taInvoke:prepare:NumOutputs",
+			"taInvoke('prepare', ...) produces a single handle. Aborting (%d).", codeLine);
+
+	char *funcAsChars = mxArrayToString(prhs[1]);
+	string taFuncNameIn(funcAsChars);
+	mxFree(funcAsChars);
+	transform(taFuncNameIn.begin(), taFuncNameIn.end(), taFuncNameIn.begin(), ::tolower);
+
+	StringValue taFunc = taLookup(taFuncNameIn);
+	if (taFunc == taNotDefined)
+		mexErrMsgIdAndTxt("MATLAB:taInvoke:UnknownFunction",
+			"Unable to find a matching function to: '%s'. Aborting (%d).", taFuncNameIn.c_str(), codeLine);
+
+	const int ss = taOptionsOf(taFunc);
+	const int numOpts = nrhs - 2;
+	const int maxOpts = ss >= 0 ? s_taOptions[ss].numOpts : 0;
+	if (numOpts > maxOpts)
+		mexErrMsgIdAndTxt("MATLAB:taInvoke:prepare:NumInputs",
+			"'%s' takes %d option(s) but %d were given. Aborting (%d).", taFuncNameIn.c_str(), maxOpts, numOpts, codeLine);
+
+	// Only the period of a batch function may be a vector
+	const int batch = taPeriodFunction(taFunc);
+	for (int ii = 0; ii < numOpts; ii++)
+	{
+		const mxArray *opt = prhs[ii + 2];
+		if (batch >= 0 && ii == 0 ? !isRealVector(opt) : !isRealScalar(opt))
+			mexErrMsgIdAndTxt("MATLAB:taInvoke:prepare:BadOption",
+				"Option %d of '%s' must be a real double %s. Aborting (%d).",
+				ii + 1, taFuncNameIn.c_str(), batch >= 0 && ii == 0 ? "scalar or vector" : "scalar", codeLine);
+	}
+
+	// Every option is checked and converted before anything is allocated for the plan, since
+	// mexErrMsgIdAndTxt does not return.  A vector of periods is converted once it has been checked.
+	double values[TA_MAX_OPTS];
+	for (int ii = 0; ii < numOpts; ii++)
+	{
+		const size_t numValues = (batch >= 0 && ii == 0) ? mxGetNumberOfElements(prhs[ii + 2]) : 1;
+		for (size_t kk = 0; kk < numValues; kk++)
+			values[ii] = taCheckOption(taFuncNameIn, s_taOptions[ss].opts[ii], ii + 1, prhs[ii + 2], kk);
+	}
+
+	taPlan *plan = new taPlan;
+	plan->func = taFunc;
+	plan->name = taFuncNameIn;
+	plan->batch = batch;
+	plan->numDev = 1;
+	if (batch >= 0)
+	{
+		if (numOpts == 0)
+			plan->periods.assign(1, s_taPeriodFunctions[batch].defPeriod);
+		else
+		{
+			plan->periods.resize(mxGetNumberOfElements(prhs[2]));
+			for (size_t kk = 0; kk < plan->periods.size(); kk++)
+				plan->periods[kk] = (int)mxGetPr(prhs[2])[kk];
+		}
+		if (numOpts == 2)
+			plan->numDev = values[1];
+	}
+	else
+	{
+		for (int ii = 0; ii < numOpts; ii++)
+		{
+			mxArray *opt = mxCreateDoubleScalar(values[ii]);
+			mexMakeArrayPersistent(opt);
+			plan->opts.push_back(opt);
+		}
+	}
+
+	if (s_taPlans.empty())
+		mexAtExit(taReleasePlans);
+
+	// Reuse a released handle before growing
+	size_t handle = find(s_taPlans.begin(), s_taPlans.end(), (taPlan *)NULL) - s_taPlans.begin();
+	if (handle == s_taPlans.size())
+		s_taPlans.push_back(plan);
+	else
+		s_taPlans[handle] = plan;
+
+	plhs[0] = mxCreateDoubleScalar((double)(handle + 1));
+}
+
+// The plan of handle 'h'
+static taPlan *taPlanOf(const mxArray *h)
+{
+	double handle = isRealScalar(h) ? mxGetScalar(h) : 0;
+
+	if (handle < 1 || handle > s_taPlans.size() || handle != (size_t)handle || s_taPlans[(size_t)handle - 1] == NULL)
+		mexErrMsgIdAndTxt("MATLAB:taInvoke:BadHandle",
+			"The handle was not returned by taInvoke('prepare', ...) or has been released. Aborting (%d).", codeLine);
+
+	return s_taPlans[(size_t)handle - 1];
+}
+
+// taInvoke('release', h) or taInvoke('release')
+static void taRelease(int nrhs, const mxArray *prhs[])
+{
+	if (nrhs == 1)
+	{
+		taReleasePlans();
+		return;
+	}
+
+	taReleasePlan(taPlanOf(prhs[1]));
+	s_taPlans[(size_t)mxGetScalar(prhs[1]) - 1] = NULL;
+}
+
+// [varout] = taInvoke(h, data)
+static void taInvokePlan(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+	const taPlan *plan = taPlanOf(prhs[0]);
+
+	// The options were checked and converted by prepare
+	if (plan->batch >= 0)
+	{
+		const int numData = s_taPeriodFunctions[plan->batch].numData;
+		if (nrhs != numData + 1)
+			mexErrMsgIdAndTxt("MATLAB:taInvoke:NumInputs",
+				"'%s' takes %d data input(s). Aborting (%d).", plan->name.c_str(), numData, codeLine);
+		if (nlhs > 1)
+			mexErrMsgIdAndTxt("MATLAB:taInvoke:NumOutputs",
+				"'%s' produces a single output. Aborting (%d).", plan->name.c_str(), codeLine);
+
+		taBatchRun(plan->batch, plan->name, plhs, prhs + 1, plan->periods, plan->numDev);
+		return;
+	}
+
+	if (nrhs + plan->opts.size() > TA_MAX_ARGS)
+		mexErrMsgIdAndTxt("MATLAB:taInvoke:NumInputs",
+			"Too many inputs were given to '%s'. Aborting (%d).", plan->name.c_str(), codeLine);
+
+	// The data followed by the kept options, as if passed by name
+	const mxArray *args[TA_MAX_ARGS];
+	int numArgs = 0;
+	for (int ii = 0; ii < nrhs; ii++)
+		args[numArgs++] = prhs[ii];
+	for (size_t ii = 0; ii < plan->opts.size(); ii++)
+		args[numArgs++] = plan->opts[ii];
+
+	taDispatch(plan->func, plan->name, nlhs, plhs, numArgs, args);
+}
+
 /////////////
 //
 // FUNCTIONS & METHODS
@@ -10320,169 +9886,96 @@ void taInvokeInfoOnly()
 	mxFree(typeOut);
 }
 
-void InitSwitchMapping()
+// Function name lookup
+// A perfect hash (hash and displace) is built once when the MEX is loaded.  Names first hash to one of
+// TA_BUCKETS buckets and each bucket holds the seed that sends its names to distinct slots of s_taSlots.
+// A lookup is two hashes and one string compare.
+static unsigned taHash(const char *name, unsigned seed)
+{
+	unsigned hash = 2166136261u ^ seed;		// FNV-1a
+	for (; *name; name++)
+		hash = (hash ^ (unsigned char)*name) * 16777619u;
+	return hash;
+}
+
+static void InitSwitchMapping()
+{
+	const int numFuncs = sizeof(s_taFunctions) / sizeof(s_taFunctions[0]);
+
+	// Place the largest buckets first while the most slots are free
+	vector<vector<int> > buckets(TA_BUCKETS);
+	for (int ii = 0; ii < numFuncs; ii++)
+		buckets[taHash(s_taFunctions[ii].name, 0) % TA_BUCKETS].push_back(ii);
+
+	vector<int> order(TA_BUCKETS);
+	for (int ii = 0; ii < TA_BUCKETS; ii++)
+		order[ii] = ii;
+	stable_sort(order.begin(), order.end(), [&buckets](int a, int b) { return buckets[a].size() > buckets[b].size(); });
+
+	for (int ii = 0; ii < TA_BUCKETS; ii++)
+	{
+		const vector<int> &bucket = buckets[order[ii]];
+		if (bucket.empty())
+			break;
+
+		for (unsigned seed = 1; ; seed++)
+		{
+			vector<int> slots;
+			for (size_t jj = 0; jj < bucket.size(); jj++)
+			{
+				int slot = taHash(s_taFunctions[bucket[jj]].name, seed) % TA_SLOTS;
+				if (s_taSlots[slot] != 0 || find(slots.begin(), slots.end(), slot) != slots.end())
+					break;
+				slots.push_back(slot);
+			}
+
+			if (slots.size() == bucket.size())
+			{
+				for (size_t jj = 0; jj < bucket.size(); jj++)
+					s_taSlots[slots[jj]] = (unsigned char)(bucket[jj] + 1);
+				s_taSeeds[order[ii]] = seed;
+				break;
+			}
+		}
+	}
+}
+
+// Built when the MEX is loaded, not on every call
+static const bool s_taMapped = (InitSwitchMapping(), true);
+
+// taNotDefined when 'taFuncNameIn' (lower case) is not a TA-Lib function
+static StringValue taLookup(const string &taFuncNameIn)
+{
+	const char *name = taFuncNameIn.c_str();
+	unsigned seed = s_taSeeds[taHash(name, 0) % TA_BUCKETS];
+	int entry = s_taSlots[taHash(name, seed) % TA_SLOTS];
+
+	if (entry == 0 || strcmp(s_taFunctions[entry - 1].name, name) != 0)
+		return taNotDefined;
+	return s_taFunctions[entry - 1].value;
+}
+
+// Output Methods
+// TA-Lib starts writing at the first valid observation (its lookback) so each output is allocated
+// once and TA-Lib is pointed past the lookback of the MatLab array itself.  No scratch copy is made.
+// DBL		Observations before the lookback are NaN
+double *taOutput(mxArray *&out, int rows, int lookback)
+{
+	out = mxCreateDoubleMatrix(rows, 1, mxREAL);
+	double *outPtr = mxGetPr(out);
+
+	int nanRows = min(max(lookback, 0), rows);
+	fill_n(outPtr, nanRows, m_Nan);
+
+	return outPtr + nanRows;
+}
+
+// INT		Observations before the lookback are 0
+int *taOutputInt(mxArray *&out, int rows, int lookback)
 {
-	s_mapStringValues["ta_accbands"]			= ta_accbands;
-	s_mapStringValues["ta_acos"]				= ta_acos;
-	s_mapStringValues["ta_ad"]					= ta_ad;
-	s_mapStringValues["ta_add"]					= ta_add;
-	s_mapStringValues["ta_adosc"]				= ta_adosc;
-	s_mapStringValues["ta_adx"]					= ta_adx;
-	s_mapStringValues["ta_adxr"]				= ta_adxr;
-	s_mapStringValues["ta_apo"]					= ta_apo;
-	s_mapStringValues["ta_aroon"]				= ta_aroon;
-	s_mapStringValues["ta_aroonosc"]			= ta_aroonosc;
-	s_mapStringValues["ta_asin"]				= ta_asin;
-	s_mapStringValues["ta_atan"]				= ta_atan;
-	s_mapStringValues["ta_atr"]					= ta_atr;
-	s_mapStringValues["ta_avgdev"]				= ta_avgdev;
-	s_mapStringValues["ta_avgprice"]			= ta_avgprice;
-	s_mapStringValues["ta_bbands"]				= ta_bbands;
-	s_mapStringValues["ta_beta"]				= ta_beta;
-	s_mapStringValues["ta_bop"]					= ta_bop;
-	s_mapStringValues["ta_cci"]					= ta_cci;
-	s_mapStringValues["ta_cdl2crows"]			= ta_cdl2crows;
-	s_mapStringValues["ta_cdl3blackcrows"]		= ta_cdl3blackcrows;
-	s_mapStringValues["ta_cdl3inside"]			= ta_cdl3inside;
-	s_mapStringValues["ta_cdl3linestrike"]		= ta_cdl3linestrike;
-	s_mapStringValues["ta_cdl3outside"]			= ta_cdl3outside;
-	s_mapStringValues["ta_cdl3starsinsouth"]	= ta_cdl3starsinsouth;
-	s_mapStringValues["ta_cdl3whitesoldiers"]	= ta_cdl3whitesoldiers;
-	s_mapStringValues["ta_cdlabandonedbaby"]	= ta_cdlabandonedbaby;
-	s_mapStringValues["ta_cdladvanceblock"]		= ta_cdladvanceblock;
-	s_mapStringValues["ta_cdlbelthold"]			= ta_cdlbelthold;
-	s_mapStringValues["ta_cdlbreakaway"]		= ta_cdlbreakaway;
-	s_mapStringValues["ta_cdlclosingmarubozu"]	= ta_cdlclosingmarubozu;
-	s_mapStringValues["ta_cdlconcealbabyswall"]	= ta_cdlconcealbabyswall;
-	s_mapStringValues["ta_cdlcounterattack"]	= ta_cdlcounterattack;
-	s_mapStringValues["ta_cdldarkcloudcover"]	= ta_cdldarkcloudcover;
-	s_mapStringValues["ta_cdldoji"]				= ta_cdldoji;
-	s_mapStringValues["ta_cdldojistar"]			= ta_cdldojistar;
-	s_mapStringValues["ta_cdldragonflydoji"]	= ta_cdldragonflydoji;
-	s_mapStringValues["ta_cdlengulfing"]		= ta_cdlengulfing;
-	s_mapStringValues["ta_cdleveningdojistar"]	= ta_cdleveningdojistar;
-	s_mapStringValues["ta_cdleveningstar"]		= ta_cdleveningstar;
-	s_mapStringValues["ta_cdlgapsidesidewhite"]	= ta_cdlgapsidesidewhite;
-	s_mapStringValues["ta_cdlgravestonedoji"]	= ta_cdlgravestonedoji;
-	s_mapStringValues["ta_cdlhammer"]			= ta_cdlhammer;
-	s_mapStringValues["ta_cdlhangingman"]		= ta_cdlhangingman;
-	s_mapStringValues["ta_cdlharami"]			= ta_cdlharami;
-	s_mapStringValues["ta_cdlharamicross"]		= ta_cdlharamicross;
-	s_mapStringValues["ta_cdlhighwave"]			= ta_cdlhighwave;
-	s_mapStringValues["ta_cdlhikkake"]			= ta_cdlhikkake;
-	s_mapStringValues["ta_cdlhikkakemod"]		= ta_cdlhikkakemod;
-	s_mapStringValues["ta_cdlhomingpigeon"]		= ta_cdlhomingpigeon;
-	s_mapStringValues["ta_cdlidentical3crows"]	= ta_cdlidentical3crows;
-	s_mapStringValues["ta_cdlinneck"]			= ta_cdlinneck;
-	s_mapStringValues["ta_cdlinvertedhammer"]	= ta_cdlinvertedhammer;
-	s_mapStringValues["ta_cdlkicking"]			= ta_cdlkicking;
-	s_mapStringValues["ta_cdlkickingbylength"]	= ta_cdlkickingbylength;
-	s_mapStringValues["ta_cdlladderbottom"]		= ta_cdlladderbottom;
-	s_mapStringValues["ta_cdllongleggeddoji"]	= ta_cdllongleggeddoji;
-	s_mapStringValues["ta_cdllongline"]			= ta_cdllongline;
-	s_mapStringValues["ta_cdlmarubozu"]			= ta_cdlmarubozu;
-	s_mapStringValues["ta_cdlmatchinglow"]		= ta_cdlmatchinglow;
-	s_mapStringValues["ta_cdlmathold"]			= ta_cdlmathold;
-	s_mapStringValues["ta_cdlmorningdojistar"]	= ta_cdlmorningdojistar;
-	s_mapStringValues["ta_cdlmorningstar"]		= ta_cdlmorningstar;
-	s_mapStringValues["ta_cdlonneck"]			= ta_cdlonneck;
-	s_mapStringValues["ta_cdlpiercing"]			= ta_cdlpiercing;
-	s_mapStringValues["ta_cdlrickshawman"]		= ta_cdlrickshawman;
-	s_mapStringValues["ta_cdlrisefall3methods"]	= ta_cdlrisefall3methods;
-	s_mapStringValues["ta_cdlseparatinglines"]	= ta_cdlseparatinglines;
-	s_mapStringValues["ta_cdlshootingstar"]		= ta_cdlshootingstar;
-	s_mapStringValues["ta_cdlshortline"]		= ta_cdlshortline;
-	s_mapStringValues["ta_cdlspinningtop"]		= ta_cdlspinningtop;
-	s_mapStringValues["ta_cdlstalledpattern"]	= ta_cdlstalledpattern;
-	s_mapStringValues["ta_cdlsticksandwich"]	= ta_cdlsticksandwich;
-	s_mapStringValues["ta_cdltakuri"]			= ta_cdltakuri;
-	s_mapStringValues["ta_cdltasukigap"]		= ta_cdltasukigap;
-	s_mapStringValues["ta_cdlthrusting"]		= ta_cdlthrusting;
-	s_mapStringValues["ta_cdltristar"]			= ta_cdltristar;
-	s_mapStringValues["ta_cdlunique3river"]		= ta_cdlunique3river;
-	s_mapStringValues["ta_cdlupsidegap2crows"]	= ta_cdlupsidegap2crows;
-	s_mapStringValues["ta_cdlxsidegap3methods"]	= ta_cdlxsidegap3methods;
-	s_mapStringValues["ta_ceil"]				= ta_ceil;
-	s_mapStringValues["ta_cmo"]					= ta_cmo;
-	s_mapStringValues["ta_correl"]				= ta_correl;
-	s_mapStringValues["ta_cos"]					= ta_cos;
-	s_mapStringValues["ta_cosh"]				= ta_cosh;
-	s_mapStringValues["ta_dema"]				= ta_dema;
-	s_mapStringValues["ta_div"]					= ta_div;
-	s_mapStringValues["ta_dx"]					= ta_dx;
-	s_mapStringValues["ta_ema"]					= ta_ema;
-	s_mapStringValues["ta_exp"]					= ta_exp;
-	s_mapStringValues["ta_floor"]				= ta_floor;
-	s_mapStringValues["ta_ht_dcperiod"]			= ta_ht_dcperiod;
-	s_mapStringValues["ta_ht_dcphase"]			= ta_ht_dcphase;
-	s_mapStringValues["ta_ht_phasor"]			= ta_ht_phasor;
-	s_mapStringValues["ta_ht_sine"]				= ta_ht_sine;
-	s_mapStringValues["ta_ht_trendline"]		= ta_ht_trendline;
-	s_mapStringValues["ta_ht_trendmode"]		= ta_ht_trendmode;
-	s_mapStringValues["ta_kama"]				= ta_kama;
-	s_mapStringValues["ta_linearreg"]			= ta_linearreg;
-	s_mapStringValues["ta_linearreg_angle"]		= ta_linearreg_angle;
-	s_mapStringValues["ta_linearreg_intercept"]	= ta_linearreg_intercept;
-	s_mapStringValues["ta_linearreg_slope"]		= ta_linearreg_slope;
-	s_mapStringValues["ta_ln"]					= ta_ln;
-	s_mapStringValues["ta_log10"]				= ta_log10;
-	s_mapStringValues["ta_ma"]					= ta_ma;
-	s_mapStringValues["ta_macd"]				= ta_macd;
-	s_mapStringValues["ta_macdext"]				= ta_macdext;
-	s_mapStringValues["ta_macdfix"]				= ta_macdfix;
-	s_mapStringValues["ta_mama"]				= ta_mama;
-	s_mapStringValues["ta_mavp"]				= ta_mavp;
-	s_mapStringValues["ta_max"]					= ta_max;
-	s_mapStringValues["ta_maxindex"]			= ta_maxindex;
-	s_mapStringValues["ta_medprice"]			= ta_medprice;
-	s_mapStringValues["ta_mfi"]					= ta_mfi;
-	s_mapStringValues["ta_midpoint"]			= ta_midpoint;
-	s_mapStringValues["ta_midprice"]			= ta_midprice;
-	s_mapStringValues["ta_min"]					= ta_min;
-	s_mapStringValues["ta_minindex"]			= ta_minindex;
-	s_mapStringValues["ta_minmax"]				= ta_minmax;
-	s_mapStringValues["ta_minmaxindex"]			= ta_minmaxindex;
-	s_mapStringValues["ta_minus_di"]			= ta_minus_di;
-	s_mapStringValues["ta_minus_dm"]			= ta_minus_dm;
-	s_mapStringValues["ta_mom"]					= ta_mom;
-	s_mapStringValues["ta_mult"]				= ta_mult;
-	s_mapStringValues["ta_natr"]				= ta_natr;
-	s_mapStringValues["ta_obv"]					= ta_obv;
-	s_mapStringValues["ta_plus_di"]				= ta_plus_di;
-	s_mapStringValues["ta_plus_dm"]				= ta_plus_dm;
-	s_mapStringValues["ta_ppo"]					= ta_ppo;
-	s_mapStringValues["ta_roc"]					= ta_roc;
-	s_mapStringValues["ta_rocp"]				= ta_rocp;
-	s_mapStringValues["ta_rocr"]				= ta_rocr;
-	s_mapStringValues["ta_rocr100"]				= ta_rocr100;
-	s_mapStringValues["ta_rsi"]					= ta_rsi;
-	s_mapStringValues["ta_sar"]					= ta_sar;
-	s_mapStringValues["ta_sarext"]				= ta_sarext;
-	s_mapStringValues["ta_sin"]					= ta_sin;
-	s_mapStringValues["ta_sinh"]				= ta_sinh;
-	s_mapStringValues["ta_sma"]					= ta_sma;
-	s_mapStringValues["ta_sqrt"]				= ta_sqrt;
-	s_mapStringValues["ta_stddev"]				= ta_stddev;
-	s_mapStringValues["ta_stoch"]				= ta_stoch;
-	s_mapStringValues["ta_stochf"]				= ta_stochf;
-	s_mapStringValues["ta_stochrsi"]			= ta_stochrsi;
-	s_mapStringValues["ta_sub"]					= ta_sub;
-	s_mapStringValues["ta_sum"]					= ta_sum;
-	s_mapStringValues["ta_t3"]					= ta_t3;
-	s_mapStringValues["ta_tan"]					= ta_tan;
-	s_mapStringValues["ta_tanh"]				= ta_tanh;
-	s_mapStringValues["ta_tema"]				= ta_tema;
-	s_mapStringValues["ta_trange"]				= ta_trange;
-	s_mapStringValues["ta_trima"]				= ta_trima;
-	s_mapStringValues["ta_trix"]				= ta_trix;
-	s_mapStringValues["ta_tsf"]					= ta_tsf;
-	s_mapStringValues["ta_typprice"]			= ta_typprice;
-	s_mapStringValues["ta_ultosc"]				= ta_ultosc;
-	s_mapStringValues["ta_var"]					= ta_var;
-	s_mapStringValues["ta_wclprice"]			= ta_wclprice;
-	s_mapStringValues["ta_willr"]				= ta_willr;
-	s_mapStringValues["ta_wma"]					= ta_wma;
+	out = mxCreateNumericMatrix(rows, 1, mxINT32_CLASS, mxREAL);
 
+	return (int*)mxGetData(out) + min(max(lookback, 0), rows);
 }
 
 // Validation Methods
@@ -10614,7 +10107,7 @@ void taInvokeFuncInfo(string taFuncNameIn)
 	char *form = NULL;
 	char *typeOut;
 
-	switch (s_mapStringValues[taFuncNameIn])
+	switch (taLookup(taFuncNameIn))
 	{
 		case ta_accbands:
 			{